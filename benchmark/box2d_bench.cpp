@@ -0,0 +1,480 @@
+// Standalone Box2D benchmark. Steps a fixed set of scenes without SDL and
+// prints the per-phase b2Profile times so engine changes can be compared:
+//
+//   make bench
+//   ./bench.exe -csv before.csv            (on the old engine)
+//   ./bench.exe -baseline before.csv       (on the new one)
+//
+// Run it from the repository root so the level files are found.
+
+#include "box2d/box2d.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Same units as the game, see Level::readLevel
+static const float PPM = 32.0f;
+static const float TILE_SIZE = 64.0f;
+static const float TIME_STEP = 1.0f / 60.0f;
+static const int VELOCITY_ITERATIONS = 8;
+static const int POSITION_ITERATIONS = 3;
+static const int WARMUP_STEPS = 60;
+
+struct BenchOptions {
+  int steps = 600;
+  int workers = 1;
+  bool wideSolver = false;
+  const char *sceneFilter = nullptr;
+  const char *csvPath = nullptr;
+  const char *baselinePath = nullptr;
+};
+
+// Everything that gets reported for one scene
+struct BenchResult {
+  std::string name;
+  int bodyCount = 0;
+  int contactCount = 0;
+  float wall = 0.0f; // average ms per step measured around b2World::Step
+  float maxStep = 0.0f;
+  b2Profile total = {};
+  double checksum = 0.0;
+};
+
+struct Scene {
+  std::string name;
+  b2Vec2 gravity;
+  // Creates the bodies of the scene
+  void (*build)(b2World *world, const char *arg);
+  // Optional, called before every step
+  void (*update)(b2World *world, int step);
+  const char *arg;
+};
+
+// ---------------------------------------------------------------------------
+// Tile levels, loaded the same way Level::readLevel does it
+// ---------------------------------------------------------------------------
+
+static void addTile(b2World *world, int row, int col, float halfSize,
+                    float friction, float restitution, bool sensor) {
+  b2BodyDef bodyDef;
+  bodyDef.type = b2_staticBody;
+  bodyDef.position.Set((col * TILE_SIZE + TILE_SIZE / 2) / PPM,
+                       (row * TILE_SIZE + TILE_SIZE / 2) / PPM);
+  b2Body *body = world->CreateBody(&bodyDef);
+
+  b2PolygonShape shape;
+  shape.SetAsBox(halfSize / PPM, halfSize / PPM);
+
+  b2FixtureDef fixtureDef;
+  fixtureDef.shape = &shape;
+  fixtureDef.density = 1.0f;
+  fixtureDef.friction = friction;
+  fixtureDef.restitution = restitution;
+  fixtureDef.isSensor = sensor;
+  body->CreateFixture(&fixtureDef);
+}
+
+static void addPlayer(b2World *world, int row, int col) {
+  b2BodyDef bodyDef;
+  bodyDef.type = b2_dynamicBody;
+  bodyDef.position.Set((col * TILE_SIZE + TILE_SIZE / 2) / PPM,
+                       (row * TILE_SIZE + TILE_SIZE / 2) / PPM);
+  bodyDef.fixedRotation = true;
+  b2Body *body = world->CreateBody(&bodyDef);
+
+  b2PolygonShape shape;
+  shape.SetAsBox((TILE_SIZE / 2 * 0.7f) / PPM, (TILE_SIZE / 2 * 0.7f) / PPM);
+
+  b2FixtureDef fixtureDef;
+  fixtureDef.shape = &shape;
+  fixtureDef.density = 1.0f;
+  fixtureDef.friction = 0.001f;
+  fixtureDef.restitution = 0.05f;
+  body->CreateFixture(&fixtureDef);
+}
+
+static void buildLevel(b2World *world, const char *path) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    fprintf(stderr, "Could not open %s, run from the repository root\n", path);
+    exit(1);
+  }
+
+  int row = 0;
+  int col = 0;
+  int c;
+  while ((c = fgetc(file)) != EOF && row < 30) {
+    if (c == '\n') {
+      row++;
+      col = 0;
+      continue;
+    }
+    switch (c) {
+    case 'D':
+      addTile(world, row, col, TILE_SIZE / 2 * 0.99f, 0.01f, 0.0f, false);
+      break;
+    case 'm':
+      addTile(world, row, col, TILE_SIZE / 2 * 0.99f, 0.001f, 0.05f, false);
+      break;
+    case 'p':
+      addTile(world, row, col, TILE_SIZE * 0.5f, 0.001f, 0.05f, false);
+      break;
+    case 'e':
+      addTile(world, row, col, TILE_SIZE / 2, 0.2f, 0.0f, true);
+      break;
+    case 'P':
+      addPlayer(world, row, col);
+      break;
+    }
+    col++;
+  }
+  fclose(file);
+}
+
+// ---------------------------------------------------------------------------
+// Large tile field: a wide level of static tiles with boxes piling up on it
+// ---------------------------------------------------------------------------
+
+static void buildTileField(b2World *world, const char *) {
+  const int columns = 256;
+  const int rows = 8;
+  const float tile = 1.0f;
+
+  // Uneven ground made of single tiles, like a long hand made level
+  for (int col = 0; col < columns; ++col) {
+    int height = 1 + (col * 7 % 13 == 0 ? 3 : 0) + (col % 32 == 0 ? rows : 0);
+    for (int row = 0; row < height; ++row) {
+      b2BodyDef bodyDef;
+      bodyDef.position.Set(col * tile, -row * tile);
+      b2Body *body = world->CreateBody(&bodyDef);
+      b2PolygonShape shape;
+      shape.SetAsBox(0.5f * tile, 0.5f * tile);
+      body->CreateFixture(&shape, 0.0f);
+    }
+  }
+
+  b2PolygonShape box;
+  box.SetAsBox(0.4f, 0.4f);
+  for (int layer = 0; layer < 10; ++layer) {
+    for (int col = 1; col < columns - 1; col += 1) {
+      if (col % 32 == 0) {
+        continue;
+      }
+      b2BodyDef bodyDef;
+      bodyDef.type = b2_dynamicBody;
+      bodyDef.position.Set(col * tile + 0.05f * (layer % 3),
+                           -5.0f - 1.0f * layer);
+      b2Body *body = world->CreateBody(&bodyDef);
+
+      b2FixtureDef fixtureDef;
+      fixtureDef.shape = &box;
+      fixtureDef.density = 1.0f;
+      fixtureDef.friction = 0.6f;
+      body->CreateFixture(&fixtureDef);
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Bullet storm: fast continuous collision bodies fired at a wall of boxes
+// ---------------------------------------------------------------------------
+
+static const int STORM_ROWS = 20;
+static const int STORM_COLUMNS = 4;
+static const int STORM_MAX_BULLETS = 600;
+
+static void buildBulletStorm(b2World *world, const char *) {
+  b2BodyDef groundDef;
+  b2Body *ground = world->CreateBody(&groundDef);
+  b2EdgeShape edge;
+  edge.SetTwoSided(b2Vec2(-40.0f, 0.0f), b2Vec2(40.0f, 0.0f));
+  ground->CreateFixture(&edge, 0.0f);
+  edge.SetTwoSided(b2Vec2(40.0f, 0.0f), b2Vec2(40.0f, 40.0f));
+  ground->CreateFixture(&edge, 0.0f);
+
+  // Thin static plates are what bullets tunnel through without TOI
+  b2PolygonShape plate;
+  for (int i = 0; i < 8; ++i) {
+    plate.SetAsBox(0.05f, 2.0f, b2Vec2(30.0f, 2.0f + 4.5f * i), 0.0f);
+    ground->CreateFixture(&plate, 0.0f);
+  }
+
+  b2PolygonShape box;
+  box.SetAsBox(0.5f, 0.5f);
+  for (int row = 0; row < STORM_ROWS; ++row) {
+    for (int col = 0; col < STORM_COLUMNS; ++col) {
+      b2BodyDef bodyDef;
+      bodyDef.type = b2_dynamicBody;
+      bodyDef.position.Set(20.0f + 1.0f * col, 0.5f + 1.0f * row);
+      b2Body *body = world->CreateBody(&bodyDef);
+      body->CreateFixture(&box, 1.0f);
+    }
+  }
+}
+
+static void updateBulletStorm(b2World *world, int step) {
+  // Ground body, the box wall and the bullets fired so far
+  int bulletCount = world->GetBodyCount() - 1 - STORM_ROWS * STORM_COLUMNS;
+  if (step % 4 != 0 || bulletCount >= STORM_MAX_BULLETS) {
+    return;
+  }
+
+  b2CircleShape circle;
+  circle.m_radius = 0.1f;
+  for (int i = 0; i < 10; ++i) {
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_dynamicBody;
+    bodyDef.bullet = true;
+    bodyDef.position.Set(-35.0f, 1.0f + 3.0f * i + 0.37f * (step % 7));
+    bodyDef.linearVelocity.Set(250.0f, 10.0f * (i % 3) - 10.0f);
+    b2Body *body = world->CreateBody(&bodyDef);
+    body->CreateFixture(&circle, 20.0f);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Rope stress: long revolute chains with heavy weights at the end
+// ---------------------------------------------------------------------------
+
+static void buildRopeStress(b2World *world, const char *) {
+  const int ropeCount = 20;
+  const int linkCount = 60;
+  const float linkLength = 0.25f;
+
+  b2BodyDef groundDef;
+  b2Body *ground = world->CreateBody(&groundDef);
+
+  b2PolygonShape link;
+  link.SetAsBox(0.5f * linkLength, 0.05f);
+
+  b2PolygonShape weight;
+  weight.SetAsBox(0.75f, 0.75f);
+
+  for (int rope = 0; rope < ropeCount; ++rope) {
+    b2Vec2 anchor(2.0f * rope, 20.0f);
+    b2Body *prev = ground;
+    for (int i = 0; i < linkCount; ++i) {
+      bool last = i == linkCount - 1;
+
+      b2BodyDef bodyDef;
+      bodyDef.type = b2_dynamicBody;
+      bodyDef.position.Set(anchor.x + linkLength * (i + 0.5f), anchor.y);
+      b2Body *body = world->CreateBody(&bodyDef);
+
+      b2FixtureDef fixtureDef;
+      fixtureDef.shape = last ? &weight : &link;
+      fixtureDef.density = last ? 100.0f : 20.0f;
+      fixtureDef.friction = 0.2f;
+      // Neighbouring ropes swing through each other
+      fixtureDef.filter.categoryBits = 0x0002;
+      fixtureDef.filter.maskBits = 0xFFFF & ~0x0002;
+      body->CreateFixture(&fixtureDef);
+
+      b2RevoluteJointDef jointDef;
+      jointDef.Initialize(prev, body,
+                          b2Vec2(anchor.x + linkLength * i, anchor.y));
+      world->CreateJoint(&jointDef);
+      prev = body;
+    }
+  }
+
+  // Something for the weights to hit
+  b2BodyDef floorDef;
+  b2Body *floor = world->CreateBody(&floorDef);
+  b2EdgeShape edge;
+  edge.SetTwoSided(b2Vec2(-20.0f, 0.0f), b2Vec2(60.0f, 0.0f));
+  floor->CreateFixture(&edge, 0.0f);
+}
+
+// ---------------------------------------------------------------------------
+
+static std::vector<Scene> makeScenes() {
+  static const char *levelFiles[] = {
+      "levels/lvl1.txt",           "levels/maze.txt",
+      "levels/hard_parkour_1.txt", "levels/hard_parkour_2.txt",
+      "levels/hard_parkour_3.txt", "levels/lvl_last.txt",
+  };
+
+  std::vector<Scene> scenes;
+  for (const char *path : levelFiles) {
+    std::string name = path;
+    name = name.substr(name.find('/') + 1);
+    name = "level_" + name.substr(0, name.rfind('.'));
+    // Same gravity as Level
+    scenes.push_back({name, b2Vec2(0.0f, 0.7f), buildLevel, nullptr, path});
+  }
+  scenes.push_back({"tile_field", b2Vec2(0.0f, -10.0f), buildTileField,
+                    nullptr, nullptr});
+  scenes.push_back({"bullet_storm", b2Vec2(0.0f, -10.0f), buildBulletStorm,
+                    updateBulletStorm, nullptr});
+  scenes.push_back({"rope_stress", b2Vec2(0.0f, -10.0f), buildRopeStress,
+                    nullptr, nullptr});
+  return scenes;
+}
+
+static void addProfile(b2Profile &sum, const b2Profile &p) {
+  sum.step += p.step;
+  sum.collide += p.collide;
+  sum.solve += p.solve;
+  sum.solveInit += p.solveInit;
+  sum.solveVelocity += p.solveVelocity;
+  sum.solvePosition += p.solvePosition;
+  sum.broadphase += p.broadphase;
+  sum.solveTOI += p.solveTOI;
+}
+
+static BenchResult runScene(const Scene &scene, const BenchOptions &options) {
+  b2World world(scene.gravity);
+  world.SetWorkerCount(options.workers);
+  world.SetWideContactSolver(options.wideSolver);
+  scene.build(&world, scene.arg);
+
+  BenchResult result;
+  result.name = scene.name;
+
+  b2Timer timer;
+  for (int i = 0; i < WARMUP_STEPS + options.steps; ++i) {
+    if (scene.update) {
+      scene.update(&world, i);
+    }
+
+    timer.Reset();
+    world.Step(TIME_STEP, VELOCITY_ITERATIONS, POSITION_ITERATIONS);
+    float ms = timer.GetMilliseconds();
+
+    if (i < WARMUP_STEPS) {
+      continue;
+    }
+    result.wall += ms;
+    result.maxStep = b2Max(result.maxStep, ms);
+    addProfile(result.total, world.GetProfile());
+  }
+
+  float inv = 1.0f / options.steps;
+  result.wall *= inv;
+  b2Profile &t = result.total;
+  t.step *= inv;
+  t.collide *= inv;
+  t.solve *= inv;
+  t.solveInit *= inv;
+  t.solveVelocity *= inv;
+  t.solvePosition *= inv;
+  t.broadphase *= inv;
+  t.solveTOI *= inv;
+
+  // Changes that should not affect the simulation keep this identical
+  for (b2Body *b = world.GetBodyList(); b; b = b->GetNext()) {
+    b2Vec2 p = b->GetPosition();
+    result.checksum += p.x + p.y + b->GetAngle();
+  }
+  result.bodyCount = world.GetBodyCount();
+  result.contactCount = world.GetContactCount();
+  return result;
+}
+
+// Baseline rows are read back from a file written with -csv
+static bool findBaseline(const char *path, const std::string &name,
+                         float &wall) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+  char line[512];
+  bool found = false;
+  while (!found && fgets(line, sizeof(line), file)) {
+    const char *comma = strchr(line, ',');
+    if (comma && std::string(line, comma - line) == name) {
+      found = sscanf(comma + 1, "%*d,%*d,%f", &wall) == 1;
+    }
+  }
+  fclose(file);
+  return found;
+}
+
+static void printUsage() {
+  printf("usage: bench [-steps n] [-workers n] [-wide] [-scene name]\n"
+         "             [-csv out.csv] [-baseline old.csv]\n");
+}
+
+int main(int argc, char **argv) {
+  BenchOptions options;
+  for (int i = 1; i < argc; ++i) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "-steps") == 0 && hasValue) {
+      options.steps = b2Max(1, atoi(argv[++i]));
+    } else if (strcmp(argv[i], "-workers") == 0 && hasValue) {
+      options.workers = b2Max(1, atoi(argv[++i]));
+    } else if (strcmp(argv[i], "-wide") == 0) {
+      options.wideSolver = true;
+    } else if (strcmp(argv[i], "-scene") == 0 && hasValue) {
+      options.sceneFilter = argv[++i];
+    } else if (strcmp(argv[i], "-csv") == 0 && hasValue) {
+      options.csvPath = argv[++i];
+    } else if (strcmp(argv[i], "-baseline") == 0 && hasValue) {
+      options.baselinePath = argv[++i];
+    } else {
+      printUsage();
+      return 1;
+    }
+  }
+
+  printf("%d steps after %d warmup, %d workers, %s contact solver\n",
+         options.steps, WARMUP_STEPS, options.workers,
+         options.wideSolver ? "wide" : "scalar");
+  printf("average ms per step\n");
+  printf("%-24s %6s %8s %8s %8s %8s %8s %8s %8s %8s %8s %8s  %s\n", "scene",
+         "bodies", "wall", "max", "step", "collide", "broad", "solve", "init",
+         "vel", "pos", "toi", "checksum");
+
+  FILE *csv = nullptr;
+  if (options.csvPath) {
+    csv = fopen(options.csvPath, "w");
+    if (csv == nullptr) {
+      fprintf(stderr, "Could not write %s\n", options.csvPath);
+      return 1;
+    }
+    fprintf(csv, "scene,bodies,contacts,wall,max,step,collide,broadphase,"
+                 "solve,solveInit,solveVelocity,solvePosition,solveTOI,"
+                 "checksum\n");
+  }
+
+  std::vector<Scene> scenes = makeScenes();
+  for (const Scene &scene : scenes) {
+    if (options.sceneFilter &&
+        scene.name.find(options.sceneFilter) == std::string::npos) {
+      continue;
+    }
+
+    BenchResult r = runScene(scene, options);
+    const b2Profile &p = r.total;
+    printf("%-24s %6d %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f "
+           "%8.3f  %.6f",
+           r.name.c_str(), r.bodyCount, r.wall, r.maxStep, p.step, p.collide,
+           p.broadphase, p.solve, p.solveInit, p.solveVelocity,
+           p.solvePosition, p.solveTOI, r.checksum);
+
+    float baseline;
+    if (options.baselinePath &&
+        findBaseline(options.baselinePath, r.name, baseline) &&
+        baseline > 0.0f) {
+      printf("  %+.1f%%", 100.0f * (r.wall - baseline) / baseline);
+    }
+    printf("\n");
+
+    if (csv) {
+      fprintf(csv, "%s,%d,%d,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%.9f\n",
+              r.name.c_str(), r.bodyCount, r.contactCount, r.wall, r.maxStep,
+              p.step, p.collide, p.broadphase, p.solve, p.solveInit,
+              p.solveVelocity, p.solvePosition, p.solveTOI, r.checksum);
+    }
+  }
+
+  if (csv) {
+    fclose(csv);
+  }
+  return 0;
+}
+// Code created by Mouttaki Omar(王明清)
@@ -1,13 +1,31 @@
 #pragma once
 #include <SDL2/SDL.h>
 constexpr const bool IS_DEBUG = false; // Set to true to run in windowed mode
-int W_WIDTH = 800;
-int W_HEIGHT = 450;
+// Logical resolution, everything is laid out and rendered at this size and the
+// window only changes the scale. Levels are 30x17 tiles of W_SPRITESIZE
+int W_WIDTH = 1920;
+int W_HEIGHT = 1080;
+// Size of the window, the display mode unless IS_DEBUG
+int W_WINDOW_WIDTH = 800;
+int W_WINDOW_HEIGHT = 450;
+// Share of the logical resolution actually rendered (0.5 to 1), see RenderScaler
+constexpr const float W_RENDER_SCALE = 1.0f;
+// Upscale by whole multiples with nearest filtering instead of linear
+constexpr const bool W_INTEGER_SCALE = false;
 constexpr const char* W_NAME = "El Captcha Oscuro";
 constexpr const SDL_WindowFlags W_TYPE = IS_DEBUG ? SDL_WINDOW_OPENGL : SDL_WINDOW_FULLSCREEN;
 constexpr const char* W_ASSETS = "./assets/";
 constexpr const char* W_FONTS = "./fonts/";
 constexpr const int W_SPRITESIZE = 64;
+constexpr const int W_PHYSICS_WORKERS = 4; // Max threads box2d may use for a level
+constexpr const int W_TARGET_FPS = 60; // Levels step physics by 1/60 s per frame
+constexpr const bool W_LATE_INPUT = true; // Sample input right before the present, see FramePacer
+// Texture memory above which cold reloadable textures are evicted, see TextureRegistry
+constexpr const size_t W_TEXTURE_BUDGET = 24 * 1024 * 1024;
+// Frames longer than this dump the profiler's last seconds to hitch-*.json
+constexpr const double W_HITCH_THRESHOLD_MS = 50.0;
+// Exit with an error when a gameplay frame allocates, past 2 s into the level
+constexpr const bool W_ALLOCATION_TEST = false;
 
 void initializeDisplayMode() {
     // Get the current display mode to know the full resolution of the screen
@@ -18,8 +36,8 @@ void initializeDisplayMode() {
         exit(1);
     }
     if (!IS_DEBUG) {
-        W_WIDTH = displayMode.w;
-        W_HEIGHT = displayMode.h;
+        W_WINDOW_WIDTH = displayMode.w;
+        W_WINDOW_HEIGHT = displayMode.h;
     }
 }
 
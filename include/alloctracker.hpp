@@ -0,0 +1,80 @@
+#pragma once
+#include <SDL2/SDL_stdinc.h>
+
+// Counts heap allocations. src/alloctracker.cpp replaces the global operator
+// new and delete, and install() routes SDL_malloc (SDL itself, SDL_image,
+// SDL_ttf, SDL_mixer) through the tracker too. Plain malloc from C code and
+// the aligned operator new are not seen. Every thread counts into the
+// totals; the main thread also counts per frame and by call site, the
+// innermost profiler zone plus the return address of the allocation
+struct AllocationStats {
+  Uint64 allocations;
+  Uint64 bytes;   // Requested, a realloc counts its new size
+  Uint64 allowed; // Of a frame's allocations, those under AllowAllocations
+};
+
+// Call sites remembered, more are counted in the totals only
+#define ALLOC_SITE_CAPACITY 256
+
+class AllocationTracker {
+public:
+  static AllocationTracker &getInstance() {
+    static AllocationTracker instance;
+    return instance;
+  }
+
+  // Hooks SDL's allocator and makes the calling thread the main thread.
+  // Call before SDL_Init, the hooks forward to SDL's own functions so memory
+  // SDL allocated earlier still frees fine
+  void install();
+
+  // Allocations of the main thread between the two count toward the frame.
+  // Publishes the frame's numbers as the profiler's "allocations" and
+  // "allocated bytes" counters. steadyState marks frames of running gameplay,
+  // see setTestMode
+  void beginFrame();
+  void endFrame(bool steadyState);
+
+  AllocationStats getFrameStats() const { return frame; }
+  // Every thread since startup
+  AllocationStats getTotals() const;
+  Uint64 getFrees() const;
+
+  // In test mode the game exits with an error and logs the call sites when
+  // a steady-state frame allocates outside AllowAllocations, once
+  // warmupFrames of steady state went by so caches fill up first
+  void setTestMode(bool enabled, int warmupFrames);
+
+  // Logs the main thread's busiest call sites since the last reset
+  void logSites(int count) const;
+  void resetSites();
+
+private:
+  AllocationTracker() = default;
+  AllocationTracker(const AllocationTracker &) = delete;
+  AllocationTracker &operator=(const AllocationTracker &) = delete;
+
+  AllocationStats frameStart = {0, 0, 0};
+  AllocationStats frame = {0, 0, 0};
+  bool testMode = false;
+  int warmupFrames = 0;
+  int steadyFrames = 0; // Consecutive steady-state frames so far
+};
+
+// Helper macro for easier access
+#define ALLOC_TRACKER AllocationTracker::getInstance()
+
+// Marks the allocations of the enclosing scope as expected, like redrawing
+// a HUD value that changed. They still count in the frame and its call sites
+// but do not fail the test mode
+class AllowAllocations {
+public:
+  AllowAllocations();
+  ~AllowAllocations();
+
+private:
+  AllowAllocations(const AllowAllocations &) = delete;
+  AllowAllocations &operator=(const AllowAllocations &) = delete;
+};
+
+// Code created by Mouttaki Omar(王明清)
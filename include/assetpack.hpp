@@ -0,0 +1,82 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Built by tools/pack_assets.cpp (make pack), read by Texture::loadFromFile
+#define ASSET_PACK_PATH "assets.pak"
+#define ASSET_PACK_MAGIC 0x4B504345 // "ECPK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_NAME_SIZE 64
+// Pixel format the packer converts to, the native one of the D3D and OpenGL
+// renderers
+#define ASSET_PACK_PIXEL_FORMAT SDL_PIXELFORMAT_ARGB8888
+
+// Entry flags
+#define ASSET_PACK_ALPHA 0x1 // Source had alpha, blended like SDL_CreateTextureFromSurface does
+
+// File layout: the header, entryCount entries sorted by name then width,
+// then one LZ4 block of 32-bit pixels per entry. Little endian throughout
+struct AssetPackHeader {
+  Uint32 magic;
+  Uint32 version;
+  Uint32 pixelFormat; // SDL_PixelFormatEnum of every entry
+  Uint32 entryCount;
+};
+
+// Pre-scaled variants of an image share its name with a different size
+struct AssetPackEntry {
+  char name[ASSET_PACK_NAME_SIZE]; // Path the game loads, e.g. assets/blocks/dirt.png
+  Uint32 width;
+  Uint32 height;
+  Uint32 flags;
+  Uint32 offset; // Of the LZ4 block, from the start of the file
+  Uint32 compressedSize;
+  Uint32 reserved[3];
+};
+
+// Read-only view of the asset pack. The file is memory mapped, an image is
+// decompressed into a buffer that is reused from one load to the next and
+// uploaded as a static texture, no SDL_image decode involved
+class AssetPack {
+public:
+  static AssetPack &getInstance() {
+    static AssetPack instance;
+    return instance;
+  }
+
+  // Maps the pack and checks its header, logs when the renderer would have
+  // to convert the pixel format. Without a pack every image comes from disk
+  bool open(const char *path, SDL_Renderer *renderer);
+  void close();
+  bool isOpen() const { return data != nullptr; }
+
+  // Finds the entry for name. Among pre-scaled variants the narrowest one
+  // at least targetWidth wide wins, or the widest if none is
+  const AssetPackEntry *find(const char *name, int targetWidth) const;
+
+  // Creates a static texture holding the entry's pixels
+  SDL_Texture *createTexture(SDL_Renderer *renderer, const AssetPackEntry *entry);
+
+  // Pixels of the last createTexture, valid until the next one
+  void *getPixels() { return pixels.data(); }
+  Uint32 getPixelFormat() const { return header->pixelFormat; }
+
+  ~AssetPack() { close(); }
+
+private:
+  AssetPack() = default;
+  AssetPack(const AssetPack &) = delete;
+  AssetPack &operator=(const AssetPack &) = delete;
+
+  const Uint8 *data = nullptr;
+  size_t size = 0;
+  void *mapping = nullptr; // Platform handle kept alive with the view
+  const AssetPackHeader *header = nullptr;
+  const AssetPackEntry *entries = nullptr;
+
+  std::vector<Uint8> pixels;
+};
+
+// Helper macro for easier access
+#define ASSET_PACK AssetPack::getInstance()
+// Code created by Mouttaki Omar(王明清)
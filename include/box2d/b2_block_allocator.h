@@ -31,6 +31,20 @@ const int32 b2_blockSizeCount = 14;
 struct b2Block;
 struct b2Chunk;
 
+/// Usage counters of a block allocator.
+struct B2_API b2BlockAllocatorStats
+{
+	int32 chunkCount;							///< chunks allocated for the size classes
+	int32 chunkSize;							///< bytes per chunk
+	int32 blockSizes[b2_blockSizeCount];		///< block size of each size class
+	int32 liveCounts[b2_blockSizeCount];		///< blocks currently in use per size class
+	int32 maxLiveCounts[b2_blockSizeCount];		///< high-water mark of liveCounts
+	int32 liveBytes;							///< bytes in use, rounded up to the block size
+	int32 maxLiveBytes;							///< high-water mark of liveBytes
+	int32 largeLiveCount;						///< allocations above b2_maxBlockSize currently alive
+	int32 largeAllocationCount;					///< allocations above b2_maxBlockSize that went to b2Alloc
+};
+
 /// This is a small object allocator used for allocating small
 /// objects that persist for more than one time step.
 /// See: http://www.codeproject.com/useritems/Small_Block_Allocator.asp
@@ -48,6 +62,9 @@ public:
 
 	void Clear();
 
+	/// Get the usage counters of this allocator.
+	b2BlockAllocatorStats GetStats() const;
+
 private:
 
 	b2Chunk* m_chunks;
@@ -55,6 +72,13 @@ private:
 	int32 m_chunkSpace;
 
 	b2Block* m_freeLists[b2_blockSizeCount];
+
+	int32 m_liveCounts[b2_blockSizeCount];
+	int32 m_maxLiveCounts[b2_blockSizeCount];
+	int32 m_liveBytes;
+	int32 m_maxLiveBytes;
+	int32 m_largeLiveCount;
+	int32 m_largeAllocationCount;
 };
 
 #endif
@@ -393,6 +393,7 @@ private:
 	friend class b2ContactManager;
 	friend class b2ContactSolver;
 	friend class b2Contact;
+	friend class b2WorldSnapshot;
 
 	friend class b2DistanceJoint;
 	friend class b2FrictionJoint;
@@ -434,6 +435,7 @@ private:
 	uint16 m_flags;
 
 	int32 m_islandIndex;
+	int32 m_worldIndex;		// slot in b2World::m_bodies
 
 	b2Transform m_xf;		// the body origin transform
 	b2Sweep m_sweep;		// the swept motion for CCD
@@ -37,6 +37,9 @@ struct B2_API b2Pair
 /// The broad-phase is used for computing pairs and performing volume queries and ray casts.
 /// This broad-phase does not persist pairs. Instead, this reports potentially new pairs.
 /// It is up to the client to consume the new pairs and to track subsequent overlap.
+/// Static proxies live in their own tree. It is rebuilt with a surface area heuristic
+/// whenever it changed and is never queried against itself. Moving proxies are kept
+/// in a separate, incrementally balanced tree.
 class B2_API b2BroadPhase
 {
 public:
@@ -50,8 +53,8 @@ public:
 	~b2BroadPhase();
 
 	/// Create a proxy with an initial AABB. Pairs are not reported until
-	/// UpdatePairs is called.
-	int32 CreateProxy(const b2AABB& aabb, void* userData);
+	/// UpdatePairs is called. Static proxies never form pairs with each other.
+	int32 CreateProxy(const b2AABB& aabb, void* userData, bool staticProxy = false);
 
 	/// Destroy a proxy. It is up to the client to remove any pairs.
 	void DestroyProxy(int32 proxyId);
@@ -94,15 +97,28 @@ public:
 	template <typename T>
 	void RayCast(T* callback, const b2RayCastInput& input) const;
 
-	/// Get the height of the embedded tree.
+	/// Query a b2RayPacket or b2AABBPacket against both trees, see b2DynamicTree::QueryPacket.
+	template <typename T, typename P>
+	void QueryPacket(T* callback, const P* packet) const;
+
+	/// Get the height of the tree holding moving proxies.
 	int32 GetTreeHeight() const;
 
-	/// Get the balance of the embedded tree.
+	/// Get the balance of the tree holding moving proxies.
 	int32 GetTreeBalance() const;
 
-	/// Get the quality metric of the embedded tree.
+	/// Get the quality metric of the tree holding moving proxies.
 	float GetTreeQuality() const;
 
+	/// Get the height of the static tree.
+	int32 GetStaticTreeHeight() const;
+
+	/// Get the balance of the static tree.
+	int32 GetStaticTreeBalance() const;
+
+	/// Get the quality metric of the static tree.
+	float GetStaticTreeQuality() const;
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
@@ -112,12 +128,67 @@ private:
 
 	friend class b2DynamicTree;
 
+	// Forwards tree callbacks with node ids turned into proxy ids. Remembers
+	// the ray clip and early exits so they carry over to the next tree.
+	template <typename T>
+	struct TreeCallback
+	{
+		TreeCallback(T* callback, bool staticTree, float maxFraction = 1.0f)
+		{
+			this->callback = callback;
+			this->staticTree = staticTree;
+			this->maxFraction = maxFraction;
+			terminated = false;
+		}
+
+		bool QueryCallback(int32 nodeId)
+		{
+			bool proceed = callback->QueryCallback(EncodeProxyId(nodeId, staticTree));
+			terminated = proceed == false;
+			return proceed;
+		}
+
+		float RayCastCallback(const b2RayCastInput& input, int32 nodeId)
+		{
+			float value = callback->RayCastCallback(input, EncodeProxyId(nodeId, staticTree));
+			if (value == 0.0f)
+			{
+				terminated = true;
+			}
+			else if (value > 0.0f)
+			{
+				maxFraction = value;
+			}
+			return value;
+		}
+
+		void PacketCallback(int32 nodeId, uint32 mask)
+		{
+			callback->PacketCallback(EncodeProxyId(nodeId, staticTree), mask);
+		}
+
+		T* callback;
+		bool staticTree;
+		float maxFraction;
+		bool terminated;
+	};
+
+	// Proxy ids keep the tree in the lowest bit.
+	static int32 EncodeProxyId(int32 nodeId, bool staticTree) { return (nodeId << 1) | (staticTree ? 1 : 0); }
+	static int32 GetNodeId(int32 proxyId) { return proxyId >> 1; }
+	static bool IsStaticProxy(int32 proxyId) { return (proxyId & 1) != 0; }
+
+	b2DynamicTree& GetTree(int32 proxyId) { return IsStaticProxy(proxyId) ? m_staticTree : m_dynamicTree; }
+	const b2DynamicTree& GetTree(int32 proxyId) const { return IsStaticProxy(proxyId) ? m_staticTree : m_dynamicTree; }
+
 	void BufferMove(int32 proxyId);
 	void UnBufferMove(int32 proxyId);
 
 	bool QueryCallback(int32 proxyId);
 
-	b2DynamicTree m_tree;
+	b2DynamicTree m_dynamicTree;
+	b2DynamicTree m_staticTree;
+	bool m_staticTreeDirty;
 
 	int32 m_proxyCount;
 
@@ -134,19 +205,19 @@ private:
 
 inline void* b2BroadPhase::GetUserData(int32 proxyId) const
 {
-	return m_tree.GetUserData(proxyId);
+	return GetTree(proxyId).GetUserData(GetNodeId(proxyId));
 }
 
 inline bool b2BroadPhase::TestOverlap(int32 proxyIdA, int32 proxyIdB) const
 {
-	const b2AABB& aabbA = m_tree.GetFatAABB(proxyIdA);
-	const b2AABB& aabbB = m_tree.GetFatAABB(proxyIdB);
+	const b2AABB& aabbA = GetFatAABB(proxyIdA);
+	const b2AABB& aabbB = GetFatAABB(proxyIdB);
 	return b2TestOverlap(aabbA, aabbB);
 }
 
 inline const b2AABB& b2BroadPhase::GetFatAABB(int32 proxyId) const
 {
-	return m_tree.GetFatAABB(proxyId);
+	return GetTree(proxyId).GetFatAABB(GetNodeId(proxyId));
 }
 
 inline int32 b2BroadPhase::GetProxyCount() const
@@ -156,22 +227,44 @@ inline int32 b2BroadPhase::GetProxyCount() const
 
 inline int32 b2BroadPhase::GetTreeHeight() const
 {
-	return m_tree.GetHeight();
+	return m_dynamicTree.GetHeight();
 }
 
 inline int32 b2BroadPhase::GetTreeBalance() const
 {
-	return m_tree.GetMaxBalance();
+	return m_dynamicTree.GetMaxBalance();
 }
 
 inline float b2BroadPhase::GetTreeQuality() const
 {
-	return m_tree.GetAreaRatio();
+	return m_dynamicTree.GetAreaRatio();
+}
+
+inline int32 b2BroadPhase::GetStaticTreeHeight() const
+{
+	return m_staticTree.GetHeight();
+}
+
+inline int32 b2BroadPhase::GetStaticTreeBalance() const
+{
+	return m_staticTree.GetMaxBalance();
+}
+
+inline float b2BroadPhase::GetStaticTreeQuality() const
+{
+	return m_staticTree.GetAreaRatio();
 }
 
 template <typename T>
 void b2BroadPhase::UpdatePairs(T* callback)
 {
+	// Static proxies were added, removed or moved since the last update.
+	if (m_staticTreeDirty)
+	{
+		m_staticTree.RebuildBottomUp();
+		m_staticTreeDirty = false;
+	}
+
 	// Reset pair buffer
 	m_pairCount = 0;
 
@@ -186,18 +279,26 @@ void b2BroadPhase::UpdatePairs(T* callback)
 
 		// We have to query the tree with the fat AABB so that
 		// we don't fail to create a pair that may touch later.
-		const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
+		const b2AABB& fatAABB = GetFatAABB(m_queryProxyId);
 
 		// Query tree, create pairs and add them pair buffer.
-		m_tree.Query(this, fatAABB);
+		TreeCallback<b2BroadPhase> dynamicCallback(this, false);
+		m_dynamicTree.Query(&dynamicCallback, fatAABB);
+
+		// Static proxies can only pair with moving ones.
+		if (IsStaticProxy(m_queryProxyId) == false)
+		{
+			TreeCallback<b2BroadPhase> staticCallback(this, true);
+			m_staticTree.Query(&staticCallback, fatAABB);
+		}
 	}
 
 	// Send pairs to caller
 	for (int32 i = 0; i < m_pairCount; ++i)
 	{
 		b2Pair* primaryPair = m_pairBuffer + i;
-		void* userDataA = m_tree.GetUserData(primaryPair->proxyIdA);
-		void* userDataB = m_tree.GetUserData(primaryPair->proxyIdB);
+		void* userDataA = GetUserData(primaryPair->proxyIdA);
+		void* userDataB = GetUserData(primaryPair->proxyIdB);
 
 		callback->AddPair(userDataA, userDataB);
 	}
@@ -211,7 +312,7 @@ void b2BroadPhase::UpdatePairs(T* callback)
 			continue;
 		}
 
-		m_tree.ClearMoved(proxyId);
+		GetTree(proxyId).ClearMoved(GetNodeId(proxyId));
 	}
 
 	// Reset move buffer
@@ -221,18 +322,48 @@ void b2BroadPhase::UpdatePairs(T* callback)
 template <typename T>
 inline void b2BroadPhase::Query(T* callback, const b2AABB& aabb) const
 {
-	m_tree.Query(callback, aabb);
+	TreeCallback<T> staticCallback(callback, true);
+	m_staticTree.Query(&staticCallback, aabb);
+	if (staticCallback.terminated)
+	{
+		return;
+	}
+
+	TreeCallback<T> dynamicCallback(callback, false);
+	m_dynamicTree.Query(&dynamicCallback, aabb);
 }
 
 template <typename T>
 inline void b2BroadPhase::RayCast(T* callback, const b2RayCastInput& input) const
 {
-	m_tree.RayCast(callback, input);
+	TreeCallback<T> staticCallback(callback, true, input.maxFraction);
+	m_staticTree.RayCast(&staticCallback, input);
+	if (staticCallback.terminated)
+	{
+		return;
+	}
+
+	// Continue with the ray clipped by the closest static hit.
+	b2RayCastInput dynamicInput = input;
+	dynamicInput.maxFraction = staticCallback.maxFraction;
+	TreeCallback<T> dynamicCallback(callback, false);
+	m_dynamicTree.RayCast(&dynamicCallback, dynamicInput);
+}
+
+template <typename T, typename P>
+inline void b2BroadPhase::QueryPacket(T* callback, const P* packet) const
+{
+	TreeCallback<T> staticCallback(callback, true);
+	m_staticTree.QueryPacket(&staticCallback, packet);
+
+	TreeCallback<T> dynamicCallback(callback, false);
+	m_dynamicTree.QueryPacket(&dynamicCallback, packet);
 }
 
 inline void b2BroadPhase::ShiftOrigin(const b2Vec2& newOrigin)
 {
-	m_tree.ShiftOrigin(newOrigin);
+	m_dynamicTree.ShiftOrigin(newOrigin);
+	m_staticTree.ShiftOrigin(newOrigin);
 }
 
 #endif
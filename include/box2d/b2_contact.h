@@ -171,6 +171,7 @@ protected:
 	friend class b2ContactSolver;
 	friend class b2Body;
 	friend class b2Fixture;
+	friend class b2WorldSnapshot;
 
 	// Flags stored in m_flags
 	enum
@@ -210,6 +211,12 @@ protected:
 
 	void Update(b2ContactListener* listener);
 
+	// Update is split in two so the narrow-phase can run in parallel.
+	// UpdateManifold only writes to this contact and returns whether the shapes touch.
+	// FinishUpdate applies the result, wakes bodies and reports to the listener.
+	bool UpdateManifold(b2Manifold* oldManifold);
+	void FinishUpdate(b2ContactListener* listener, const b2Manifold& oldManifold, bool touching);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
 
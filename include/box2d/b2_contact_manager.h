@@ -30,12 +30,15 @@ class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2ThreadPool;
+struct b2ContactUpdate;
 
 // Delegate of b2World.
 class B2_API b2ContactManager
 {
 public:
 	b2ContactManager();
+	~b2ContactManager();
 
 	// Broad-phase callback.
 	void AddPair(void* proxyUserDataA, void* proxyUserDataB);
@@ -46,12 +49,20 @@ public:
 
 	void Collide();
 
+	// Narrow-phase task, see b2ThreadPool::ParallelFor.
+	static void UpdateManifolds(int32 startIndex, int32 endIndex, int32 workerIndex, void* context);
+
 	b2BroadPhase m_broadPhase;
 	b2Contact* m_contactList;
 	int32 m_contactCount;
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+	b2ThreadPool* m_threadPool;
+
+	// Narrow-phase scratch, one slot per contact updated in Collide.
+	b2ContactUpdate* m_updates;
+	int32 m_updateCapacity;
 };
 
 #endif
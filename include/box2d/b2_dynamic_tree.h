@@ -29,6 +29,49 @@
 
 #define b2_nullNode (-1)
 
+/// The number of rays or AABBs in a packet, one bit each in a uint32 mask.
+#define b2_packetSize 32
+
+/// Rays tested together by b2DynamicTree::QueryPacket. Ray i extends from its p1 to
+/// p1 + maxFraction[i] * (p2 - p1). Callbacks shorten maxFraction as they find hits,
+/// which prunes the rest of the traversal for that ray.
+struct B2_API b2RayPacket
+{
+	b2RayPacket();
+
+	/// Append a ray. The ray must have a non-zero length.
+	void Add(const b2RayCastInput& input);
+
+	/// Get the bits of the rays in mask that cross the AABB. Uses slab tests on
+	/// B2_SIMD_WIDTH rays at a time.
+	uint32 TestOverlap(const b2AABB& aabb, uint32 mask) const;
+
+	float originX[b2_packetSize];
+	float originY[b2_packetSize];
+	float invDirectionX[b2_packetSize];
+	float invDirectionY[b2_packetSize];
+	float maxFraction[b2_packetSize];
+	int32 count;
+};
+
+/// AABBs tested together by b2DynamicTree::QueryPacket.
+struct B2_API b2AABBPacket
+{
+	b2AABBPacket();
+
+	/// Append an AABB.
+	void Add(const b2AABB& aabb);
+
+	/// Get the bits of the AABBs in mask that overlap the given AABB.
+	uint32 TestOverlap(const b2AABB& aabb, uint32 mask) const;
+
+	float lowerX[b2_packetSize];
+	float lowerY[b2_packetSize];
+	float upperX[b2_packetSize];
+	float upperY[b2_packetSize];
+	int32 count;
+};
+
 /// A node in the dynamic tree. The client does not interact with this directly.
 struct B2_API b2TreeNode
 {
@@ -111,6 +154,13 @@ public:
 	template <typename T>
 	void RayCast(T* callback, const b2RayCastInput& input) const;
 
+	/// Query a b2RayPacket or b2AABBPacket in a single traversal. A node is only visited
+	/// by the packet entries that overlap its parent. The callback class is called as
+	/// PacketCallback(proxyId, mask) for every leaf, with the bits of the entries that
+	/// overlap it. It may shorten ray max fractions in the packet.
+	template <typename T, typename P>
+	void QueryPacket(T* callback, const P* packet) const;
+
 	/// Validate this tree. For testing.
 	void Validate() const;
 
@@ -125,7 +175,8 @@ public:
 	/// Get the ratio of the sum of the node areas to the root area.
 	float GetAreaRatio() const;
 
-	/// Build an optimal tree. Very expensive. For testing.
+	/// Rebuild the tree from its leaves using a binned surface area heuristic.
+	/// Proxy ids are preserved. O(n log n), meant for proxies that rarely change.
 	void RebuildBottomUp();
 
 	/// Shift the world origin. Useful for large worlds.
@@ -143,6 +194,8 @@ private:
 
 	int32 Balance(int32 index);
 
+	int32 BuildSAH(int32* leaves, int32 count);
+
 	int32 ComputeHeight() const;
 	int32 ComputeHeight(int32 nodeId) const;
 
@@ -305,4 +358,57 @@ inline void b2DynamicTree::RayCast(T* callback, const b2RayCastInput& input) con
 	}
 }
 
+template <typename T, typename P>
+inline void b2DynamicTree::QueryPacket(T* callback, const P* packet) const
+{
+	struct StackItem
+	{
+		int32 nodeId;
+		uint32 mask;
+	};
+
+	if (packet->count == 0)
+	{
+		return;
+	}
+
+	StackItem root;
+	root.nodeId = m_root;
+	root.mask = packet->count == b2_packetSize ? 0xFFFFFFFF : (1u << packet->count) - 1;
+
+	b2GrowableStack<StackItem, 256> stack;
+	stack.Push(root);
+
+	while (stack.GetCount() > 0)
+	{
+		StackItem item = stack.Pop();
+		if (item.nodeId == b2_nullNode)
+		{
+			continue;
+		}
+
+		const b2TreeNode* node = m_nodes + item.nodeId;
+
+		uint32 mask = packet->TestOverlap(node->aabb, item.mask);
+		if (mask == 0)
+		{
+			continue;
+		}
+
+		if (node->IsLeaf())
+		{
+			callback->PacketCallback(item.nodeId, mask);
+		}
+		else
+		{
+			StackItem child;
+			child.mask = mask;
+			child.nodeId = node->child1;
+			stack.Push(child);
+			child.nodeId = node->child2;
+			stack.Push(child);
+		}
+	}
+}
+
 #endif
@@ -216,6 +216,7 @@ protected:
 	friend class b2World;
 	friend class b2Contact;
 	friend class b2ContactManager;
+	friend class b2WorldSnapshot;
 
 	b2Fixture();
 
@@ -234,6 +235,7 @@ protected:
 
 	b2Fixture* m_next;
 	b2Body* m_body;
+	int32 m_worldIndex;		// slot in b2World::m_fixtures
 
 	b2Shape* m_shape;
 
@@ -0,0 +1,125 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_SIMD_H
+#define B2_SIMD_H
+
+#include "b2_math.h"
+
+#include <string.h>
+
+// Thin wrapper over the widest float vector enabled at compile time: AVX2 (8 lanes),
+// SSE2 (4 lanes) or a plain array the compiler may vectorize. Internal to the contact
+// solver and the tree packet queries, not part of box2d.h.
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#define B2_SIMD_WIDTH 8
+
+typedef __m256 b2FloatW;
+
+static inline b2FloatW b2LoadW(const float* p) { return _mm256_loadu_ps(p); }
+static inline void b2StoreW(float* p, b2FloatW a) { _mm256_storeu_ps(p, a); }
+static inline b2FloatW b2SplatW(float s) { return _mm256_set1_ps(s); }
+static inline b2FloatW b2AddW(b2FloatW a, b2FloatW b) { return _mm256_add_ps(a, b); }
+static inline b2FloatW b2SubW(b2FloatW a, b2FloatW b) { return _mm256_sub_ps(a, b); }
+static inline b2FloatW b2MulW(b2FloatW a, b2FloatW b) { return _mm256_mul_ps(a, b); }
+static inline b2FloatW b2DivW(b2FloatW a, b2FloatW b) { return _mm256_div_ps(a, b); }
+static inline b2FloatW b2MinW(b2FloatW a, b2FloatW b) { return _mm256_min_ps(a, b); }
+static inline b2FloatW b2MaxW(b2FloatW a, b2FloatW b) { return _mm256_max_ps(a, b); }
+
+static inline b2FloatW b2GreaterW(b2FloatW a, b2FloatW b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline b2FloatW b2GreaterEqualW(b2FloatW a, b2FloatW b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+static inline b2FloatW b2AndW(b2FloatW a, b2FloatW b) { return _mm256_and_ps(a, b); }
+
+// b where the mask is set, a elsewhere
+static inline b2FloatW b2BlendW(b2FloatW a, b2FloatW b, b2FloatW mask) { return _mm256_blendv_ps(a, b, mask); }
+
+// One bit per lane of a comparison mask
+static inline int32 b2MaskBitsW(b2FloatW mask) { return _mm256_movemask_ps(mask); }
+
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+#define B2_SIMD_WIDTH 4
+
+typedef __m128 b2FloatW;
+
+static inline b2FloatW b2LoadW(const float* p) { return _mm_loadu_ps(p); }
+static inline void b2StoreW(float* p, b2FloatW a) { _mm_storeu_ps(p, a); }
+static inline b2FloatW b2SplatW(float s) { return _mm_set1_ps(s); }
+static inline b2FloatW b2AddW(b2FloatW a, b2FloatW b) { return _mm_add_ps(a, b); }
+static inline b2FloatW b2SubW(b2FloatW a, b2FloatW b) { return _mm_sub_ps(a, b); }
+static inline b2FloatW b2MulW(b2FloatW a, b2FloatW b) { return _mm_mul_ps(a, b); }
+static inline b2FloatW b2DivW(b2FloatW a, b2FloatW b) { return _mm_div_ps(a, b); }
+static inline b2FloatW b2MinW(b2FloatW a, b2FloatW b) { return _mm_min_ps(a, b); }
+static inline b2FloatW b2MaxW(b2FloatW a, b2FloatW b) { return _mm_max_ps(a, b); }
+
+static inline b2FloatW b2GreaterW(b2FloatW a, b2FloatW b) { return _mm_cmpgt_ps(a, b); }
+static inline b2FloatW b2GreaterEqualW(b2FloatW a, b2FloatW b) { return _mm_cmpge_ps(a, b); }
+static inline b2FloatW b2AndW(b2FloatW a, b2FloatW b) { return _mm_and_ps(a, b); }
+
+// b where the mask is set, a elsewhere
+static inline b2FloatW b2BlendW(b2FloatW a, b2FloatW b, b2FloatW mask)
+{
+	return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+}
+
+// One bit per lane of a comparison mask
+static inline int32 b2MaskBitsW(b2FloatW mask) { return _mm_movemask_ps(mask); }
+
+#else
+
+#define B2_SIMD_WIDTH 4
+
+// Portable fallback, the compiler is left to vectorize the lane loops.
+struct b2FloatW
+{
+	float v[B2_SIMD_WIDTH];
+};
+
+static inline b2FloatW b2LoadW(const float* p) { b2FloatW r; memcpy(r.v, p, sizeof(r.v)); return r; }
+static inline void b2StoreW(float* p, b2FloatW a) { memcpy(p, a.v, sizeof(a.v)); }
+static inline b2FloatW b2SplatW(float s) { b2FloatW r; for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) r.v[i] = s; return r; }
+static inline b2FloatW b2AddW(b2FloatW a, b2FloatW b) { for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) a.v[i] += b.v[i]; return a; }
+static inline b2FloatW b2SubW(b2FloatW a, b2FloatW b) { for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) a.v[i] -= b.v[i]; return a; }
+static inline b2FloatW b2MulW(b2FloatW a, b2FloatW b) { for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) a.v[i] *= b.v[i]; return a; }
+static inline b2FloatW b2DivW(b2FloatW a, b2FloatW b) { for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) a.v[i] = b.v[i] != 0.0f ? a.v[i] / b.v[i] : 0.0f; return a; }
+static inline b2FloatW b2MinW(b2FloatW a, b2FloatW b) { for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) a.v[i] = b2Min(a.v[i], b.v[i]); return a; }
+static inline b2FloatW b2MaxW(b2FloatW a, b2FloatW b) { for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) a.v[i] = b2Max(a.v[i], b.v[i]); return a; }
+
+// Masks hold 1 or 0 per lane.
+static inline b2FloatW b2GreaterW(b2FloatW a, b2FloatW b) { for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) a.v[i] = a.v[i] > b.v[i] ? 1.0f : 0.0f; return a; }
+static inline b2FloatW b2GreaterEqualW(b2FloatW a, b2FloatW b) { for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) a.v[i] = a.v[i] >= b.v[i] ? 1.0f : 0.0f; return a; }
+static inline b2FloatW b2AndW(b2FloatW a, b2FloatW b) { for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) a.v[i] = a.v[i] != 0.0f && b.v[i] != 0.0f ? 1.0f : 0.0f; return a; }
+
+// b where the mask is set, a elsewhere
+static inline b2FloatW b2BlendW(b2FloatW a, b2FloatW b, b2FloatW mask) { for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) a.v[i] = mask.v[i] != 0.0f ? b.v[i] : a.v[i]; return a; }
+
+// One bit per lane of a comparison mask
+static inline int32 b2MaskBitsW(b2FloatW mask) { int32 bits = 0; for (int32 i = 0; i < B2_SIMD_WIDTH; ++i) bits |= mask.v[i] != 0.0f ? 1 << i : 0; return bits; }
+
+#endif
+
+#endif
@@ -28,17 +28,41 @@
 
 const int32 b2_stackSize = 100 * 1024;	// 100k
 const int32 b2_maxStackEntries = 32;
+const int32 b2_maxStackSegments = 8;
 
 struct B2_API b2StackEntry
 {
 	char* data;
 	int32 size;
+	int32 segment;
 	bool usedMalloc;
 };
 
+/// A contiguous block of stack memory. The first segment is b2_stackSize bytes,
+/// each following one is at least twice the size of the previous.
+struct B2_API b2StackSegment
+{
+	char* data;
+	int32 size;
+	int32 index;
+};
+
+/// Usage counters of a stack allocator.
+struct B2_API b2StackAllocatorStats
+{
+	int32 capacity;				///< bytes reserved by all segments
+	int32 segmentCount;			///< number of segments, starts at one
+	int32 allocation;			///< bytes currently allocated
+	int32 maxAllocation;		///< high-water mark of allocated bytes
+	int32 growCount;			///< segments added because an allocation did not fit
+	int32 heapFallbackCount;	///< allocations that went to b2Alloc because b2_maxStackSegments was reached
+};
+
 // This is a stack allocator used for fast per step allocations.
 // You must nest allocate/free pairs. The code will assert
 // if you try to interleave multiple allocate/free pairs.
+// When the current segment is full a bigger one is added, pointers handed
+// out earlier stay valid. Segments are kept for the following steps.
 class B2_API b2StackAllocator
 {
 public:
@@ -50,10 +74,17 @@ public:
 
 	int32 GetMaxAllocation() const;
 
+	/// Get the usage counters of this allocator.
+	b2StackAllocatorStats GetStats() const;
+
 private:
 
-	char m_data[b2_stackSize];
-	int32 m_index;
+	b2StackSegment m_segments[b2_maxStackSegments];
+	int32 m_segmentCount;
+	int32 m_segmentIndex;
+
+	int32 m_growCount;
+	int32 m_heapFallbackCount;
 
 	int32 m_allocation;
 	int32 m_maxAllocation;
@@ -0,0 +1,83 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#ifndef B2_THREAD_POOL_H
+#define B2_THREAD_POOL_H
+
+#include "b2_api.h"
+#include "b2_settings.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/// Work callback for b2ThreadPool::ParallelFor. Processes items [startIndex, endIndex).
+/// workerIndex is in [0, workerCount) and can be used to pick per-worker scratch data.
+typedef void b2ParallelForFcn(int32 startIndex, int32 endIndex, int32 workerIndex, void* context);
+
+/// A fixed set of worker threads used to split up parts of the world step.
+/// The thread calling ParallelFor takes part in the work as worker 0.
+class B2_API b2ThreadPool
+{
+public:
+
+	/// Starts workerCount - 1 threads.
+	explicit b2ThreadPool(int32 workerCount);
+
+	/// Stops and joins the threads.
+	~b2ThreadPool();
+
+	/// Number of workers including the calling thread.
+	int32 GetWorkerCount() const { return m_workerCount; }
+
+	/// Run fcn over [0, count) in ranges of at least minRange items. Blocks until
+	/// every range is done. Runs inline on the caller if there is only one range.
+	void ParallelFor(int32 count, int32 minRange, b2ParallelForFcn* fcn, void* context);
+
+private:
+
+	b2ThreadPool(const b2ThreadPool&) = delete;
+	void operator=(const b2ThreadPool&) = delete;
+
+	void WorkerMain(int32 workerIndex);
+	void RunRanges(int32 workerIndex);
+
+	int32 m_workerCount;
+	std::thread* m_threads;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	uint32 m_generation;
+	int32 m_busyCount;
+	bool m_quit;
+
+	// The current job.
+	b2ParallelForFcn* m_fcn;
+	void* m_context;
+	int32 m_count;
+	int32 m_rangeSize;
+	int32 m_rangeCount;
+	std::atomic<int32> m_nextRange;
+};
+
+#endif
@@ -47,6 +47,7 @@ struct B2_API b2TimeStep
 	int32 velocityIterations;
 	int32 positionIterations;
 	bool warmStarting;
+	bool wideContactSolver;
 };
 
 /// This is an internal structure.
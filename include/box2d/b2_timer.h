@@ -47,8 +47,7 @@ private:
 	double m_start;
 	static double s_invFrequency;
 #elif defined(__linux__) || defined (__APPLE__)
-	unsigned long long m_start_sec;
-	unsigned long long m_start_usec;
+	unsigned long long m_start;
 #endif
 };
 
@@ -35,10 +35,65 @@ struct b2AABB;
 struct b2BodyDef;
 struct b2Color;
 struct b2JointDef;
+struct b2RayCastInput;
 class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+class b2ThreadPool;
+
+/// Fixture filter shared by all queries of a batch.
+/// See b2World::RayCastBatch and b2World::QueryAABBBatch
+struct B2_API b2QueryFilter
+{
+	b2QueryFilter()
+	{
+		maskBits = 0xFFFF;
+		ignoreBody = nullptr;
+		ignoreSensors = false;
+	}
+
+	/// Fixtures whose category bits don't overlap these are skipped.
+	uint16 maskBits;
+
+	/// Fixtures of this body are skipped, usually the body doing the query.
+	const b2Body* ignoreBody;
+
+	/// Skip sensor fixtures.
+	bool ignoreSensors;
+};
+
+/// Closest hit of one ray of b2World::RayCastBatch.
+struct B2_API b2RayCastHit
+{
+	/// The fixture hit, nullptr if the ray hit nothing.
+	b2Fixture* fixture;
+	b2Vec2 point;
+	b2Vec2 normal;
+	float fraction;
+};
+
+/// A fixture found by b2World::QueryAABBBatch.
+struct B2_API b2AABBOverlap
+{
+	/// Index of the query AABB.
+	int32 index;
+	b2Fixture* fixture;
+};
+
+/// Memory usage of a world's allocators. See b2World::GetMemoryStats
+struct B2_API b2MemoryStats
+{
+	/// Per step scratch of the calling thread.
+	b2StackAllocatorStats stack;
+
+	/// Island scratch of the worker threads, summed up. The maxAllocation is
+	/// the largest of the worker stacks. All zero without a thread pool.
+	b2StackAllocatorStats workerStacks;
+
+	/// Bodies, fixtures, shapes, contacts and joints.
+	b2BlockAllocatorStats block;
+};
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -126,12 +181,44 @@ public:
 	/// @param point2 the ray ending point
 	void RayCast(b2RayCastCallback* callback, const b2Vec2& point1, const b2Vec2& point2) const;
 
+	/// Ray-cast many rays at once. Rays are traversed in packets of b2_packetSize, so
+	/// each tree node is tested against all rays of a packet in one go. Every ray
+	/// reports its closest hit, shapes that contain the starting point are ignored.
+	/// @param inputs the rays, each from p1 to p1 + maxFraction * (p2 - p1)
+	/// @param count the number of rays
+	/// @param hits receives one closest hit per ray
+	/// @param filter fixtures to skip
+	void RayCastBatch(const b2RayCastInput* inputs, int32 count, b2RayCastHit* hits,
+						const b2QueryFilter& filter = b2QueryFilter()) const;
+
+	/// Query many AABBs at once, in packets like RayCastBatch. A fixture is reported when
+	/// the AABB of one of its children overlaps a query AABB, once per child.
+	/// @param aabbs the query boxes
+	/// @param count the number of query boxes
+	/// @param overlaps receives up to capacity overlaps, in no particular order
+	/// @param capacity the size of the overlaps array
+	/// @param filter fixtures to skip
+	/// @return the number of overlaps found, which may exceed capacity
+	int32 QueryAABBBatch(const b2AABB* aabbs, int32 count, b2AABBOverlap* overlaps, int32 capacity,
+						const b2QueryFilter& filter = b2QueryFilter()) const;
+
 	/// Get the world body list. With the returned body, use b2Body::GetNext to get
 	/// the next body in the world list. A nullptr body indicates the end of the list.
 	/// @return the head of the world body list.
 	b2Body* GetBodyList();
 	const b2Body* GetBodyList() const;
 
+	/// Get the world bodies as a dense array of GetBodyCount() entries. Prefer this
+	/// over the body list for loops over every body. Destroying a body moves the
+	/// last body into its slot, so the order is not stable across DestroyBody.
+	b2Body* const* GetBodies() { return m_bodies; }
+	const b2Body* const* GetBodies() const { return m_bodies; }
+
+	/// Get every fixture in the world as a dense array of GetFixtureCount() entries.
+	/// Destroying a fixture moves the last fixture into its slot.
+	b2Fixture* const* GetFixtures() { return m_fixtures; }
+	const b2Fixture* const* GetFixtures() const { return m_fixtures; }
+
 	/// Get the world joint list. With the returned joint, use b2Joint::GetNext to get
 	/// the next joint in the world list. A nullptr joint indicates the end of the list.
 	/// @return the head of the world joint list.
@@ -150,6 +237,19 @@ public:
 	void SetAllowSleeping(bool flag);
 	bool GetAllowSleeping() const { return m_allowSleep; }
 
+	/// Set the number of threads used to step the world, including the calling thread.
+	/// The default of 1 runs everything on the calling thread. Callbacks are always
+	/// reported on the calling thread, PostSolve after every island has been solved.
+	/// @warning This function is locked during callbacks.
+	void SetWorkerCount(int32 workerCount);
+	int32 GetWorkerCount() const;
+
+	/// Enable/disable the wide contact solver. It colors the contact graph and solves
+	/// several contacts per SIMD instruction, including the 2-point block solver, for
+	/// throughput on large piles. Off by default.
+	void SetWideContactSolver(bool flag) { m_wideContactSolver = flag; }
+	bool GetWideContactSolver() const { return m_wideContactSolver; }
+
 	/// Enable/disable warm starting. For testing.
 	void SetWarmStarting(bool flag) { m_warmStarting = flag; }
 	bool GetWarmStarting() const { return m_warmStarting; }
@@ -168,22 +268,35 @@ public:
 	/// Get the number of bodies.
 	int32 GetBodyCount() const;
 
+	/// Get the number of fixtures.
+	int32 GetFixtureCount() const;
+
 	/// Get the number of joints.
 	int32 GetJointCount() const;
 
 	/// Get the number of contacts (each may have 0 or more contact points).
 	int32 GetContactCount() const;
 
-	/// Get the height of the dynamic tree.
+	/// Get the height of the broad-phase tree holding non-static proxies.
 	int32 GetTreeHeight() const;
 
-	/// Get the balance of the dynamic tree.
+	/// Get the balance of the broad-phase tree holding non-static proxies.
 	int32 GetTreeBalance() const;
 
-	/// Get the quality metric of the dynamic tree. The smaller the better.
-	/// The minimum is 1.
+	/// Get the quality metric of the broad-phase tree holding non-static proxies.
+	/// The smaller the better. The minimum is 1.
 	float GetTreeQuality() const;
 
+	/// Get the height of the static body tree.
+	int32 GetStaticTreeHeight() const;
+
+	/// Get the balance of the static body tree.
+	int32 GetStaticTreeBalance() const;
+
+	/// Get the quality metric of the static body tree. It is rebuilt with a surface
+	/// area heuristic after static bodies change, on the next step.
+	float GetStaticTreeQuality() const;
+
 	/// Change the global gravity vector.
 	void SetGravity(const b2Vec2& gravity);
 
@@ -210,6 +323,10 @@ public:
 	/// Get the current profile.
 	const b2Profile& GetProfile() const;
 
+	/// Get the usage of the world's allocators: stack high-water marks, segments
+	/// added and heap fallbacks during steps, live blocks per size class.
+	b2MemoryStats GetMemoryStats() const;
+
 	/// Dump the world into the log file.
 	/// @warning this should be called outside of a time step.
 	void Dump();
@@ -220,26 +337,46 @@ private:
 	friend class b2Fixture;
 	friend class b2ContactManager;
 	friend class b2Controller;
+	friend class b2WorldSnapshot;
 
 	b2World(const b2World&) = delete;
 	void operator=(const b2World&) = delete;
 
 	void Solve(const b2TimeStep& step);
+	static void SolveIslands(int32 startIndex, int32 endIndex, int32 workerIndex, void* context);
 	void SolveTOI(const b2TimeStep& step);
 
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 
+	void AddBody(b2Body* body);
+	void RemoveBody(b2Body* body);
+	void AddFixture(b2Fixture* fixture);
+	void RemoveFixture(b2Fixture* fixture);
+
 	b2BlockAllocator m_blockAllocator;
 	b2StackAllocator m_stackAllocator;
 
 	b2ContactManager m_contactManager;
 
+	b2ThreadPool* m_threadPool;
+
+	// Island scratch for workers 1..n-1, the calling thread uses m_stackAllocator.
+	b2StackAllocator* m_workerStacks;
+
 	b2Body* m_bodyList;
 	b2Joint* m_jointList;
 
 	int32 m_bodyCount;
 	int32 m_jointCount;
 
+	// Bodies and fixtures packed for the per-step loops. The linked lists are kept
+	// for the public iteration API.
+	b2Body** m_bodies;
+	int32 m_bodyCapacity;
+	b2Fixture** m_fixtures;
+	int32 m_fixtureCount;
+	int32 m_fixtureCapacity;
+
 	b2Vec2 m_gravity;
 	bool m_allowSleep;
 
@@ -258,6 +395,7 @@ private:
 	bool m_warmStarting;
 	bool m_continuousPhysics;
 	bool m_subStepping;
+	bool m_wideContactSolver;
 
 	bool m_stepComplete;
 
@@ -299,6 +437,11 @@ inline int32 b2World::GetBodyCount() const
 	return m_bodyCount;
 }
 
+inline int32 b2World::GetFixtureCount() const
+{
+	return m_fixtureCount;
+}
+
 inline int32 b2World::GetJointCount() const
 {
 	return m_jointCount;
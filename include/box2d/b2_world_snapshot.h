@@ -0,0 +1,133 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_WORLD_SNAPSHOT_H
+#define B2_WORLD_SNAPSHOT_H
+
+#include "b2_api.h"
+#include "b2_collision.h"
+#include "b2_fixture.h"
+#include "b2_math.h"
+
+class b2Body;
+class b2World;
+
+/// Captured state of one body. See b2WorldSnapshot
+struct B2_API b2BodyState
+{
+	b2Body* body;
+	b2Transform xf;
+	b2Sweep sweep;
+	b2Vec2 linearVelocity;
+	float angularVelocity;
+	b2Vec2 force;
+	float torque;
+	float gravityScale;
+	float sleepTime;
+	uint16 flags;
+};
+
+/// Captured state of one fixture. See b2WorldSnapshot
+struct B2_API b2FixtureState
+{
+	b2Fixture* fixture;
+	float friction;
+	float restitution;
+	float restitutionThreshold;
+	b2Filter filter;
+	bool isSensor;
+};
+
+/// Captured state of one touching contact. See b2WorldSnapshot
+struct B2_API b2ContactState
+{
+	b2Fixture* fixtureA;
+	b2Fixture* fixtureB;
+	int32 indexA;
+	int32 indexB;
+	b2Manifold manifold;
+	uint32 flags;
+	int32 toiCount;
+	float toi;
+	float friction;
+	float restitution;
+	float restitutionThreshold;
+	float tangentSpeed;
+};
+
+/// A copy of the mutable state of a world: body transforms, velocities and flags,
+/// fixture materials and filters, and the manifolds of touching contacts so warm
+/// starting carries over. Restoring rewinds the world in place, nothing is allocated
+/// or loaded. Bodies and fixtures must not be created or destroyed in between, disable
+/// bodies instead. Mass data and joint impulses are not captured.
+class B2_API b2WorldSnapshot
+{
+public:
+	b2WorldSnapshot();
+	~b2WorldSnapshot();
+
+	/// Capture the state of a world. This must be called outside of a time step.
+	void Capture(const b2World* world);
+
+	/// Put the world back into the captured state. This must be called outside of
+	/// a time step. No contact begin or end events are reported for the rewind.
+	/// @return false if bodies or fixtures were created or destroyed since the
+	/// capture, or if this is a different world. Nothing is changed then.
+	bool Restore(b2World* world) const;
+
+	/// Forget the captured state, the memory is kept for the next capture.
+	void Clear();
+
+	/// Is there a captured state?
+	bool IsEmpty() const;
+
+	/// Get the number of bytes used by the captured state.
+	int32 GetByteCount() const;
+
+private:
+
+	b2WorldSnapshot(const b2WorldSnapshot&) = delete;
+	void operator=(const b2WorldSnapshot&) = delete;
+
+	bool Matches(const b2World* world) const;
+
+	const b2World* m_world;
+
+	b2BodyState* m_bodies;
+	int32 m_bodyCount;
+	int32 m_bodyCapacity;
+
+	b2FixtureState* m_fixtures;
+	int32 m_fixtureCount;
+	int32 m_fixtureCapacity;
+
+	b2ContactState* m_contacts;
+	int32 m_contactCount;
+	int32 m_contactCapacity;
+};
+
+inline bool b2WorldSnapshot::IsEmpty() const
+{
+	return m_world == nullptr;
+}
+
+#endif
@@ -1,15 +1,14 @@
 #pragma once
 #include "SDL2/SDL.h"
-#include "textures.hpp"
-#include <list>
-#include <memory>
 #include <math.h>
 #include <cstdio>
 
+// Plain value so the player keeps its bullets in a reused vector: firing
+// one allocates nothing. The texture belongs to whoever fired it
 class Bullet {
 public:
-  Bullet(SDL_Renderer *renderer, float x, float y, float angle, float speed);
-  ~Bullet();
+  Bullet(SDL_Texture *texture, int width, int height, float x, float y,
+         float angle, float speed);
   void update();
   void render(SDL_Renderer *renderer);
   bool isOutOfBounds(int screenWidth, int screenHeight);
@@ -26,23 +25,10 @@ private:
   int height = 4;
 };
 
-Bullet::Bullet(SDL_Renderer *renderer, float x, float y, float angle,
-               float speed)
-    : x(x), y(y), angle(angle), speed(speed) {
-  SDL_Surface *surface =
-      Texture::loadFromFile("assets/gun/laser_bullet.png", renderer, texture);
-  if (surface) {
-    width = surface->w;
-    height = surface->h;
-    SDL_FreeSurface(surface);
-  }
-}
-
-Bullet::~Bullet() {
-  if (texture) {
-    SDL_DestroyTexture(texture);
-  }
-}
+Bullet::Bullet(SDL_Texture *texture, int width, int height, float x, float y,
+               float angle, float speed)
+    : texture(texture), x(x), y(y), angle(angle), speed(speed), width(width),
+      height(height) {}
 
 void Bullet::update() {
   // Move bullet based on angle and speed
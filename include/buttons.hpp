@@ -1,4 +1,5 @@
 #pragma once
+#include "renderscaler.hpp"
 #include "textures.hpp"
 #include <SDL2/SDL.h>
 #include <functional>
@@ -7,6 +8,7 @@ class Button {
     SDL_Texture* texture;
     SDL_Rect rect;
     std::function<void()> callback = nullptr;
+    std::function<void()> hoverCallback = nullptr;
     bool isHoveredState = false;
 
   public:
@@ -16,6 +18,10 @@ class Button {
     void setCallback(std::function<void()> callback) {
         this->callback = callback;
     }
+    // called once each time the mouse starts hovering the button
+    void setHoverCallback(std::function<void()> hoverCallback) {
+        this->hoverCallback = hoverCallback;
+    }
     void render(SDL_Renderer* renderer);
     void setPosition(int x, int y);
     void setSize(int w, int h);
@@ -32,13 +38,13 @@ Button::Button() {
 }
 Button::~Button() {
     if (texture != nullptr) {
-        SDL_DestroyTexture(texture);
+        TEXTURE_REGISTRY.destroy(texture);
         texture = nullptr;
     }
 }
 void Button::loadFromFile(const char* path, SDL_Renderer* renderer) {
     // loading the button's texture
-    SDL_Surface* loadedSurface = Texture::loadFromFile(path, renderer, texture);
+    SDL_Surface* loadedSurface = Texture::loadFromFile(path, renderer, texture, "menu");
     if (loadedSurface == nullptr) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to load image %s! SDL_image Error: %s\n", path, SDL_GetError());
         exit(1);
@@ -75,7 +81,7 @@ bool Button::isHovered(int x, int y) {
 }
 void Button::handleEvents(SDL_Event event) {
     int x, y;
-    SDL_GetMouseState(&x, &y);
+    RENDER_SCALER.getMouseState(&x, &y);
     if (event.type == SDL_MOUSEBUTTONDOWN) {
         if (isHovered(x, y)) {
             if (callback != nullptr) {
@@ -84,6 +90,9 @@ void Button::handleEvents(SDL_Event event) {
         }
     }
     if (isHovered(x, y)) {
+        if (!isHoveredState && hoverCallback != nullptr) {
+            hoverCallback();
+        }
         isHoveredState = true;
     } else {
         isHoveredState = false;
@@ -0,0 +1,102 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <box2d/box2d.h>
+
+// What a fixture belongs to. Every fixture the game creates stores a tag in
+// its user data, so a contact tells the player from a block without guessing
+// what a pointer points at
+enum FixtureKind {
+  FIXTURE_NONE, // Untagged, user data left at 0
+  FIXTURE_PLAYER,
+  FIXTURE_BLOCK, // Handle indexes Level::blocks
+  FIXTURE_EXIT,  // Exit sensor, handle indexes Level::blocks
+};
+
+// Kind in the high 8 bits, handle in the low 24, so a tag fits the user
+// data of 32-bit builds too. Tags order by kind first
+typedef Uint32 FixtureTag;
+#define FIXTURE_HANDLE_BITS 24
+#define FIXTURE_HANDLE_MASK ((1u << FIXTURE_HANDLE_BITS) - 1)
+
+inline FixtureTag makeFixtureTag(FixtureKind kind, Uint32 handle) {
+  return (FixtureTag)kind << FIXTURE_HANDLE_BITS | (handle & FIXTURE_HANDLE_MASK);
+}
+inline FixtureKind getFixtureKind(FixtureTag tag) {
+  return (FixtureKind)(tag >> FIXTURE_HANDLE_BITS);
+}
+inline Uint32 getFixtureHandle(FixtureTag tag) { return tag & FIXTURE_HANDLE_MASK; }
+inline FixtureTag getFixtureTag(const b2Fixture *fixture) {
+  return (FixtureTag)fixture->GetUserData().pointer;
+}
+
+// Events per step before the queue starts dropping them, far more than a
+// level of 30x17 tiles produces
+#define COLLISION_EVENT_CAPACITY 1024
+
+enum CollisionEventType {
+  COLLISION_BEGIN, // Fixtures started touching
+  COLLISION_END,   // Fixtures stopped touching
+  COLLISION_HIT,   // Solved with a normal impulse above the hit threshold
+};
+
+// tagA <= tagB, so the pair comes with the lower kind first whichever
+// fixture Box2D calls A
+struct CollisionEvent {
+  Uint32 type; // CollisionEventType
+  FixtureTag tagA;
+  FixtureTag tagB;
+  float impulse; // Largest normal impulse of a hit, 0 otherwise
+};
+
+// Contact listener that only records. Callbacks run inside b2World::Step,
+// so they append fixed size events to a preallocated buffer and nothing
+// else: no game state, no logging. The level reads the whole buffer after
+// the step and clears it
+class CollisionEventQueue : public b2ContactListener {
+public:
+  void BeginContact(b2Contact *contact) override { push(COLLISION_BEGIN, contact, 0.0f); }
+  void EndContact(b2Contact *contact) override { push(COLLISION_END, contact, 0.0f); }
+  void PostSolve(b2Contact *contact, const b2ContactImpulse *impulse) override {
+    float normal = impulse->normalImpulses[0];
+    if (impulse->count > 1)
+      normal = b2Max(normal, impulse->normalImpulses[1]);
+    if (normal >= hitImpulse)
+      push(COLLISION_HIT, contact, normal);
+  }
+
+  // Normal impulse from which a solved contact counts as a hit, hits are
+  // off until this is set
+  void setHitImpulse(float impulse) { hitImpulse = impulse; }
+
+  const CollisionEvent *getEvents() const { return events; }
+  int getCount() const { return count; }
+  // Events lost to a full buffer since the last clear
+  int getDropped() const { return dropped; }
+
+  void clear() {
+    count = 0;
+    dropped = 0;
+  }
+
+private:
+  void push(CollisionEventType type, b2Contact *contact, float impulse) {
+    if (count == COLLISION_EVENT_CAPACITY) {
+      dropped++;
+      return;
+    }
+    FixtureTag a = getFixtureTag(contact->GetFixtureA());
+    FixtureTag b = getFixtureTag(contact->GetFixtureB());
+    CollisionEvent &event = events[count++];
+    event.type = type;
+    event.tagA = SDL_min(a, b);
+    event.tagB = SDL_max(a, b);
+    event.impulse = impulse;
+  }
+
+  CollisionEvent events[COLLISION_EVENT_CAPACITY];
+  int count = 0;
+  int dropped = 0;
+  float hitImpulse = b2_maxFloat;
+};
+
+// Code created by Mouttaki Omar(王明清)
@@ -0,0 +1,220 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <box2d/box2d.h>
+#include <vector>
+
+// Segments used to approximate circles
+#define DEBUG_DRAW_CIRCLE_SEGMENTS 16
+
+// b2Draw for the F1 collision view. b2World::DebugDraw emits every shape,
+// joint and contact point into two vertex buffers, fills and outlines, which
+// flush() submits with one SDL_RenderGeometry call each. Lines are drawn as
+// one pixel wide quads, and anything outside the renderer viewport is
+// dropped before it reaches the buffers.
+class PhysicsDebugDraw : public b2Draw {
+public:
+  static constexpr float PPM = 32.0f; // 32 pixels = 1 Box2D meter
+
+  PhysicsDebugDraw() : renderer(nullptr) {}
+
+  // Starts a frame. The viewport is read once here for culling
+  void begin(SDL_Renderer *target) {
+    renderer = target;
+    SDL_Rect viewport;
+    SDL_RenderGetViewport(renderer, &viewport);
+    viewMin.Set(0.0f, 0.0f);
+    viewMax.Set(viewport.w / PPM, viewport.h / PPM);
+
+    fillVertices.clear();
+    fillIndices.clear();
+    lineVertices.clear();
+    lineIndices.clear();
+  }
+
+  // Draws everything accumulated since begin, fills below outlines
+  void flush() {
+    if (renderer == nullptr)
+      return;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    if (!fillIndices.empty()) {
+      SDL_RenderGeometry(renderer, nullptr, fillVertices.data(),
+                         (int)fillVertices.size(), fillIndices.data(),
+                         (int)fillIndices.size());
+    }
+    if (!lineIndices.empty()) {
+      SDL_RenderGeometry(renderer, nullptr, lineVertices.data(),
+                         (int)lineVertices.size(), lineIndices.data(),
+                         (int)lineIndices.size());
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    renderer = nullptr;
+  }
+
+  void DrawPolygon(const b2Vec2 *vertices, int32 vertexCount,
+                   const b2Color &color) override {
+    if (!isVisible(vertices, vertexCount, 0.0f))
+      return;
+    addOutline(vertices, vertexCount, color);
+  }
+
+  void DrawSolidPolygon(const b2Vec2 *vertices, int32 vertexCount,
+                        const b2Color &color) override {
+    if (!isVisible(vertices, vertexCount, 0.0f))
+      return;
+
+    // Convex, so a fan around the first vertex covers it
+    SDL_Color fill = toColor(color, 0.5f);
+    int base = (int)fillVertices.size();
+    for (int32 i = 0; i < vertexCount; i++) {
+      fillVertices.push_back(toVertex(vertices[i], fill));
+    }
+    for (int32 i = 1; i < vertexCount - 1; i++) {
+      fillIndices.push_back(base);
+      fillIndices.push_back(base + i);
+      fillIndices.push_back(base + i + 1);
+    }
+    addOutline(vertices, vertexCount, color);
+  }
+
+  void DrawCircle(const b2Vec2 &center, float radius,
+                  const b2Color &color) override {
+    if (!isVisible(&center, 1, radius))
+      return;
+    b2Vec2 vertices[DEBUG_DRAW_CIRCLE_SEGMENTS];
+    circleVertices(center, radius, vertices);
+    addOutline(vertices, DEBUG_DRAW_CIRCLE_SEGMENTS, color);
+  }
+
+  void DrawSolidCircle(const b2Vec2 &center, float radius, const b2Vec2 &axis,
+                       const b2Color &color) override {
+    if (!isVisible(&center, 1, radius))
+      return;
+    b2Vec2 vertices[DEBUG_DRAW_CIRCLE_SEGMENTS];
+    circleVertices(center, radius, vertices);
+    DrawSolidPolygon(vertices, DEBUG_DRAW_CIRCLE_SEGMENTS, color);
+    // Radius line so rotation is visible
+    addLine(center, center + radius * axis, toColor(color, 1.0f));
+  }
+
+  void DrawSegment(const b2Vec2 &p1, const b2Vec2 &p2,
+                   const b2Color &color) override {
+    b2Vec2 ends[2] = {p1, p2};
+    if (!isVisible(ends, 2, 0.0f))
+      return;
+    addLine(p1, p2, toColor(color, 1.0f));
+  }
+
+  void DrawTransform(const b2Transform &xf) override {
+    if (!isVisible(&xf.p, 1, 0.5f))
+      return;
+    const float axisScale = 0.5f;
+    SDL_Color red = {255, 0, 0, 255};
+    SDL_Color green = {0, 255, 0, 255};
+    addLine(xf.p, xf.p + axisScale * xf.q.GetXAxis(), red);
+    addLine(xf.p, xf.p + axisScale * xf.q.GetYAxis(), green);
+  }
+
+  void DrawPoint(const b2Vec2 &p, float size, const b2Color &color) override {
+    // size is in pixels
+    float half = 0.5f * size / PPM;
+    if (!isVisible(&p, 1, half))
+      return;
+    b2Vec2 vertices[4] = {b2Vec2(p.x - half, p.y - half),
+                          b2Vec2(p.x + half, p.y - half),
+                          b2Vec2(p.x + half, p.y + half),
+                          b2Vec2(p.x - half, p.y + half)};
+    SDL_Color fill = toColor(color, 1.0f);
+    int base = (int)fillVertices.size();
+    for (int i = 0; i < 4; i++) {
+      fillVertices.push_back(toVertex(vertices[i], fill));
+    }
+    addQuadIndices(fillIndices, base);
+  }
+
+private:
+  // True when the bounds of the points, grown by margin meters, overlap the
+  // viewport
+  bool isVisible(const b2Vec2 *vertices, int32 count, float margin) const {
+    b2Vec2 lower = vertices[0];
+    b2Vec2 upper = vertices[0];
+    for (int32 i = 1; i < count; i++) {
+      lower = b2Min(lower, vertices[i]);
+      upper = b2Max(upper, vertices[i]);
+    }
+    return lower.x - margin <= viewMax.x && upper.x + margin >= viewMin.x &&
+           lower.y - margin <= viewMax.y && upper.y + margin >= viewMin.y;
+  }
+
+  void circleVertices(const b2Vec2 &center, float radius, b2Vec2 *vertices) {
+    const float step = 2.0f * b2_pi / DEBUG_DRAW_CIRCLE_SEGMENTS;
+    for (int i = 0; i < DEBUG_DRAW_CIRCLE_SEGMENTS; i++) {
+      float angle = i * step;
+      vertices[i] = center + radius * b2Vec2(cosf(angle), sinf(angle));
+    }
+  }
+
+  void addOutline(const b2Vec2 *vertices, int32 vertexCount,
+                  const b2Color &color) {
+    SDL_Color line = toColor(color, 1.0f);
+    b2Vec2 previous = vertices[vertexCount - 1];
+    for (int32 i = 0; i < vertexCount; i++) {
+      addLine(previous, vertices[i], line);
+      previous = vertices[i];
+    }
+  }
+
+  // A segment becomes a quad one pixel wide
+  void addLine(const b2Vec2 &p1, const b2Vec2 &p2, const SDL_Color &color) {
+    b2Vec2 direction = p2 - p1;
+    if (direction.Normalize() < b2_epsilon)
+      direction.Set(1.0f, 0.0f);
+    b2Vec2 offset = (0.5f / PPM) * b2Cross(1.0f, direction);
+
+    int base = (int)lineVertices.size();
+    lineVertices.push_back(toVertex(p1 - offset, color));
+    lineVertices.push_back(toVertex(p2 - offset, color));
+    lineVertices.push_back(toVertex(p2 + offset, color));
+    lineVertices.push_back(toVertex(p1 + offset, color));
+    addQuadIndices(lineIndices, base);
+  }
+
+  static void addQuadIndices(std::vector<int> &indices, int base) {
+    indices.push_back(base);
+    indices.push_back(base + 1);
+    indices.push_back(base + 2);
+    indices.push_back(base);
+    indices.push_back(base + 2);
+    indices.push_back(base + 3);
+  }
+
+  SDL_Vertex toVertex(const b2Vec2 &p, const SDL_Color &color) const {
+    SDL_Vertex vertex;
+    vertex.position.x = p.x * PPM;
+    vertex.position.y = p.y * PPM;
+    vertex.color = color;
+    vertex.tex_coord.x = 0.0f;
+    vertex.tex_coord.y = 0.0f;
+    return vertex;
+  }
+
+  static SDL_Color toColor(const b2Color &color, float alphaScale) {
+    SDL_Color result;
+    result.r = (Uint8)(color.r * 255.0f);
+    result.g = (Uint8)(color.g * 255.0f);
+    result.b = (Uint8)(color.b * 255.0f);
+    result.a = (Uint8)(color.a * alphaScale * 255.0f);
+    return result;
+  }
+
+  SDL_Renderer *renderer;
+  b2Vec2 viewMin;
+  b2Vec2 viewMax;
+
+  // Kept between frames so the buffers stop reallocating after the first one
+  std::vector<SDL_Vertex> fillVertices;
+  std::vector<int> fillIndices;
+  std::vector<SDL_Vertex> lineVertices;
+  std::vector<int> lineIndices;
+};
+// Code created by Mouttaki Omar(王明清)
@@ -0,0 +1,521 @@
+#pragma once
+#include "player.hpp"
+#include "textures.hpp"
+#include <CONSTANTS.hpp>
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Most entities alive at once, every component array is reserved to this so
+// spawning never allocates
+#define MAX_ENTITIES 4096
+#define ENTITY_INDEX_MASK 0xFFFF
+#define ENTITY_GENERATION_SHIFT 16
+
+// An entity is just an id: the low bits index the component arrays, the high
+// bits count how often that index was reused so stale ids can be told apart
+typedef Uint32 Entity;
+#define ENTITY_NONE 0xFFFFFFFFu
+
+// Top-left corner for enemies, center for projectiles (see SpriteComponent)
+struct TransformComponent {
+  float x, y;
+  float angle; // Degrees, only used for drawing
+};
+
+struct SpriteComponent {
+  SDL_Texture *texture; // Shared, owned by EntityManager
+  int w, h;
+  int offsetX, offsetY; // From the transform to the top-left of the image
+};
+
+struct HealthComponent {
+  int current;
+  int max;
+};
+
+// Flying enemy: dodges the player's bullets and, below half health, flies
+// one of a few patterns picked at random every few seconds
+struct EnemyAIComponent {
+  float dodgeChance;
+  float minY, maxY;   // Vertical band the enemy stays in
+  int pattern;        // 0 patrol, 1 circle, 2 keep distance from the player
+  float patternTimer; // Picks a new pattern past 300
+  float speed;
+  float angle; // Position on the circle pattern
+  float targetX, targetY;
+  bool patternInitialized;
+};
+
+// Fires at the player, faster as health drops
+struct WeaponComponent {
+  int baseFireRate; // Frames between shots at full health
+  int fireRate;
+  int fireTimer;
+  float projectileSpeed;
+  int damage;
+  float hitChance; // Of a projectile touching the player actually hurting
+};
+
+struct ProjectileComponent {
+  float vx, vy;
+  int damage;
+  float hitChance;
+};
+
+// Packed array of one component type. The components stay contiguous so a
+// system walks them in a straight loop, sparse maps an entity index to its
+// slot. Removal moves the last component into the hole
+template <typename T> class ComponentArray {
+public:
+  ComponentArray() : sparse(MAX_ENTITIES, -1) {
+    dense.reserve(MAX_ENTITIES);
+    owners.reserve(MAX_ENTITIES);
+  }
+
+  T &add(Entity entity, const T &component) {
+    int index = entity & ENTITY_INDEX_MASK;
+    if (sparse[index] < 0) {
+      sparse[index] = (int)dense.size();
+      dense.push_back(component);
+      owners.push_back(entity);
+    } else {
+      dense[sparse[index]] = component;
+    }
+    return dense[sparse[index]];
+  }
+
+  void remove(Entity entity) {
+    int index = entity & ENTITY_INDEX_MASK;
+    int slot = sparse[index];
+    if (slot < 0)
+      return;
+    int last = (int)dense.size() - 1;
+    dense[slot] = dense[last];
+    owners[slot] = owners[last];
+    sparse[owners[slot] & ENTITY_INDEX_MASK] = slot;
+    dense.pop_back();
+    owners.pop_back();
+    sparse[index] = -1;
+  }
+
+  // nullptr if the entity has no such component
+  T *find(Entity entity) {
+    int slot = sparse[entity & ENTITY_INDEX_MASK];
+    return slot < 0 ? nullptr : &dense[slot];
+  }
+  T &get(Entity entity) { return dense[sparse[entity & ENTITY_INDEX_MASK]]; }
+
+  int size() const { return (int)dense.size(); }
+  T &operator[](int slot) { return dense[slot]; }
+  const T &operator[](int slot) const { return dense[slot]; }
+  Entity owner(int slot) const { return owners[slot]; }
+
+  void clear() {
+    for (Entity entity : owners) {
+      sparse[entity & ENTITY_INDEX_MASK] = -1;
+    }
+    dense.clear();
+    owners.clear();
+  }
+
+private:
+  std::vector<T> dense;
+  std::vector<Entity> owners;
+  std::vector<int> sparse;
+};
+
+// Owns every enemy and enemy projectile of a level. Entities are rows across
+// the component arrays, behavior lives in the systems run by update(), one
+// loop per component type, instead of in per-enemy objects
+class EntityManager {
+public:
+  EntityManager();
+  ~EntityManager();
+
+  Entity create();
+  // Not from inside a system, they queue into pendingDestroy instead
+  void destroy(Entity entity);
+  bool isAlive(Entity entity) const;
+  void clear();
+  int getCount() const { return count; }
+
+  // Prefabs, the first enemy loads the shared textures
+  Entity spawnEnemy(SDL_Renderer *renderer, float x, float y);
+  Entity spawnProjectile(float x, float y, float angle, float speed,
+                         int damage, float hitChance);
+
+  // Runs the systems once, one frame
+  void update(Player *player);
+  void render(SDL_Renderer *renderer);
+
+  // Damages the first enemy under the point, enemies at 0 health are removed.
+  // Returns whether one was hit
+  bool hitTest(float x, float y, int damage);
+  int getEnemyCount() const { return ais.size(); }
+  // Health left over the health all enemies started with, 1 without enemies
+  float getHealthFraction() const;
+
+  ComponentArray<TransformComponent> transforms;
+  ComponentArray<SpriteComponent> sprites;
+  ComponentArray<HealthComponent> healths;
+  ComponentArray<EnemyAIComponent> ais;
+  ComponentArray<WeaponComponent> weapons;
+  ComponentArray<ProjectileComponent> projectiles;
+
+private:
+  void updateFireRates();
+  void dodgeBullets(Player *player);
+  void updateFlightPatterns(Player *player);
+  void updateWeapons(Player *player);
+  void updateProjectiles(Player *player);
+  void flushDestroyed();
+
+  std::vector<Uint16> generations;
+  std::vector<Uint16> freeIndices;
+  std::vector<bool> alive;
+  std::vector<Entity> pendingDestroy;
+  int count = 0;
+
+  std::mt19937 rng;
+  std::uniform_real_distribution<float> chance;
+
+  SDL_Texture *enemyTexture = nullptr;
+  SDL_Texture *projectileTexture = nullptr;
+  int projectileWidth = 8;
+  int projectileHeight = 4;
+};
+
+EntityManager::EntityManager()
+    : generations(MAX_ENTITIES, 0), alive(MAX_ENTITIES, false),
+      rng(std::random_device()()), chance(0.0f, 1.0f) {
+  // Handed out from the back, lowest index first
+  freeIndices.reserve(MAX_ENTITIES);
+  for (int i = MAX_ENTITIES - 1; i >= 0; i--) {
+    freeIndices.push_back((Uint16)i);
+  }
+  pendingDestroy.reserve(MAX_ENTITIES);
+}
+
+EntityManager::~EntityManager() {
+  TEXTURE_REGISTRY.destroy(enemyTexture);
+  TEXTURE_REGISTRY.destroy(projectileTexture);
+}
+
+Entity EntityManager::create() {
+  if (freeIndices.empty()) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                 "EntityManager: More than %d entities", MAX_ENTITIES);
+    return ENTITY_NONE;
+  }
+  Uint16 index = freeIndices.back();
+  freeIndices.pop_back();
+  alive[index] = true;
+  count++;
+  return (Entity)generations[index] << ENTITY_GENERATION_SHIFT | index;
+}
+
+void EntityManager::destroy(Entity entity) {
+  if (!isAlive(entity))
+    return;
+  transforms.remove(entity);
+  sprites.remove(entity);
+  healths.remove(entity);
+  ais.remove(entity);
+  weapons.remove(entity);
+  projectiles.remove(entity);
+
+  Uint16 index = entity & ENTITY_INDEX_MASK;
+  alive[index] = false;
+  generations[index]++;
+  freeIndices.push_back(index);
+  count--;
+}
+
+bool EntityManager::isAlive(Entity entity) const {
+  if (entity == ENTITY_NONE)
+    return false;
+  Uint16 index = entity & ENTITY_INDEX_MASK;
+  return alive[index] &&
+         generations[index] == (Uint16)(entity >> ENTITY_GENERATION_SHIFT);
+}
+
+void EntityManager::clear() {
+  for (int i = 0; i < MAX_ENTITIES; i++) {
+    if (alive[i]) {
+      destroy((Entity)generations[i] << ENTITY_GENERATION_SHIFT | i);
+    }
+  }
+  pendingDestroy.clear();
+}
+
+Entity EntityManager::spawnEnemy(SDL_Renderer *renderer, float x, float y) {
+  if (enemyTexture == nullptr) {
+    SDL_Surface *surface = Texture::loadFromFile(
+        "assets/enemy/enemy.png", renderer, enemyTexture, "enemy");
+    if (surface == nullptr) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                   "Unable to load the enemy texture");
+      exit(1);
+    }
+    SDL_FreeSurface(surface);
+    surface = Texture::loadFromFile("assets/gun/laser_bullet.png", renderer,
+                                    projectileTexture, "enemy");
+    if (surface) {
+      projectileWidth = surface->w;
+      projectileHeight = surface->h;
+      SDL_FreeSurface(surface);
+    }
+  }
+
+  Entity entity = create();
+  if (entity == ENTITY_NONE)
+    return entity;
+  transforms.add(entity, {x, y, 0.0f});
+  sprites.add(entity, {enemyTexture, W_SPRITESIZE, W_SPRITESIZE, 0, 0});
+  healths.add(entity, {400, 400});
+  // Stays 200 pixels above the bottom of the screen
+  ais.add(entity, {0.75f, 400.0f, (float)W_HEIGHT - 200.0f, 0, 0.0f, 0.01f,
+                   0.0f, 0.0f, 0.0f, false});
+  weapons.add(entity, {400, 120, 0, 2.0f, 10, 0.25f});
+  return entity;
+}
+
+Entity EntityManager::spawnProjectile(float x, float y, float angle,
+                                      float speed, int damage,
+                                      float hitChance) {
+  Entity entity = create();
+  if (entity == ENTITY_NONE)
+    return entity;
+  float radians = angle * (float)M_PI / 180.0f;
+  transforms.add(entity, {x, y, angle});
+  sprites.add(entity, {projectileTexture, projectileWidth, projectileHeight,
+                       -projectileWidth / 2, -projectileHeight / 2});
+  projectiles.add(entity, {std::cos(radians) * speed,
+                           std::sin(radians) * speed, damage, hitChance});
+  return entity;
+}
+
+void EntityManager::update(Player *player) {
+  if (player == nullptr)
+    return;
+  updateProjectiles(player);
+  dodgeBullets(player);
+  updateFireRates();
+  updateFlightPatterns(player);
+  updateWeapons(player);
+  flushDestroyed();
+}
+
+void EntityManager::render(SDL_Renderer *renderer) {
+  for (int i = 0; i < sprites.size(); i++) {
+    const SpriteComponent &sprite = sprites[i];
+    const TransformComponent &transform = transforms.get(sprites.owner(i));
+    SDL_Rect rect = {(int)transform.x + sprite.offsetX,
+                     (int)transform.y + sprite.offsetY, sprite.w, sprite.h};
+    if (transform.angle == 0.0f) {
+      SDL_RenderCopy(renderer, sprite.texture, nullptr, &rect);
+    } else {
+      SDL_RenderCopyEx(renderer, sprite.texture, nullptr, &rect,
+                       transform.angle, nullptr, SDL_FLIP_NONE);
+    }
+  }
+}
+
+bool EntityManager::hitTest(float x, float y, int damage) {
+  for (int i = 0; i < healths.size(); i++) {
+    Entity entity = healths.owner(i);
+    const TransformComponent &transform = transforms.get(entity);
+    const SpriteComponent &sprite = sprites.get(entity);
+    if (x < transform.x || x > transform.x + sprite.w || y < transform.y ||
+        y > transform.y + sprite.h)
+      continue;
+
+    HealthComponent &health = healths[i];
+    health.current = SDL_max(health.current - damage, 0);
+    if (health.current == 0) {
+      destroy(entity);
+    }
+    return true;
+  }
+  return false;
+}
+
+float EntityManager::getHealthFraction() const {
+  int current = 0;
+  int max = 0;
+  for (int i = 0; i < healths.size(); i++) {
+    current += healths[i].current;
+    max += healths[i].max;
+  }
+  return max > 0 ? (float)current / max : 1.0f;
+}
+
+void EntityManager::updateFireRates() {
+  // 4x faster at no health, never under 30 frames
+  for (int i = 0; i < weapons.size(); i++) {
+    WeaponComponent &weapon = weapons[i];
+    const HealthComponent &health = healths.get(weapons.owner(i));
+    float healthPercent = (float)health.current / health.max;
+    weapon.fireRate = SDL_max(
+        (int)(weapon.baseFireRate * (0.25f + 0.75f * healthPercent)), 30);
+  }
+}
+
+void EntityManager::dodgeBullets(Player *player) {
+  const float minXFromEdge = 100.0f;
+  for (int i = 0; i < ais.size(); i++) {
+    const EnemyAIComponent &ai = ais[i];
+    TransformComponent &transform = transforms.get(ais.owner(i));
+    for (const auto &bullet : player->getBulletsObj()) {
+      if (chance(rng) >= ai.dodgeChance)
+        continue;
+      float dx = bullet.getX() - transform.x;
+      float dy = bullet.getY() - transform.y;
+      float distance = std::sqrt(dx * dx + dy * dy);
+      // Only nearby bullets, step perpendicular to them
+      if (distance < ai.minY && distance > 0.0f) {
+        transform.x = SDL_clamp(transform.x - dy / distance * 5.0f,
+                                minXFromEdge, W_WIDTH - minXFromEdge);
+        transform.y = SDL_clamp(transform.y + dx / distance * 5.0f, ai.minY,
+                                ai.maxY);
+      }
+    }
+  }
+}
+
+void EntityManager::updateFlightPatterns(Player *player) {
+  const float minXFromEdge = 100.0f;
+  for (int i = 0; i < ais.size(); i++) {
+    EnemyAIComponent &ai = ais[i];
+    Entity entity = ais.owner(i);
+    const HealthComponent &health = healths.get(entity);
+    float healthPercent = (float)health.current / health.max;
+    // Only flies once below half health
+    if (healthPercent >= 0.5f)
+      continue;
+
+    TransformComponent &transform = transforms.get(entity);
+    // Pick a new pattern about every 10 seconds, faster when hurt
+    ai.patternTimer += 0.5f;
+    if (ai.patternTimer > 300.0f) {
+      ai.patternTimer = 0.0f;
+      ai.pattern = rng() % 3;
+      ai.patternInitialized = false;
+      ai.speed = 1.0f + 2.0f * (1.0f - healthPercent);
+      ai.targetX = minXFromEdge +
+                   rng() % (W_WIDTH - 2 * (int)minXFromEdge);
+      ai.targetY = ai.minY + rng() % (int)(ai.maxY - ai.minY);
+    }
+
+    float x = transform.x;
+    float y = transform.y;
+    switch (ai.pattern) {
+    case 0: // Horizontal patrol
+      if (!ai.patternInitialized) {
+        ai.targetX = minXFromEdge;
+        ai.patternInitialized = true;
+      }
+      if (x < minXFromEdge + 10) {
+        ai.targetX = W_WIDTH - minXFromEdge;
+      } else if (x > W_WIDTH - minXFromEdge - 10) {
+        ai.targetX = minXFromEdge;
+      }
+      if (std::fabs(ai.targetX - x) > 5.0f) {
+        x += (ai.targetX > x ? 1 : -1) * ai.speed * 2;
+      }
+      break;
+
+    case 1: // Circle around the upper middle of the screen
+    {
+      float centerX = W_WIDTH / 2.0f;
+      float centerY = W_HEIGHT / 3.0f;
+      float radius = SDL_min(150.0f, SDL_min(centerX - minXFromEdge,
+                                             centerY - ai.minY));
+      ai.angle += 0.01f;
+      float dx = centerX + std::cos(ai.angle) * radius - x;
+      float dy = centerY + std::sin(ai.angle) * radius - y;
+      float dist = std::sqrt(dx * dx + dy * dy);
+      if (dist > 5.0f) {
+        x += dx / dist * ai.speed;
+        y += dy / dist * ai.speed;
+      }
+    } break;
+
+    case 2: // Stay between 200 and 400 pixels from the player
+    {
+      float dx = player->getX() - x;
+      float dy = player->getY() - y;
+      float dist = std::sqrt(dx * dx + dy * dy);
+      if (dist < 200.0f && dist > 0.0f) {
+        x -= dx / dist * ai.speed;
+        y -= dy / dist * ai.speed;
+      } else if (dist > 400.0f) {
+        x += dx / dist * ai.speed;
+        y += dy / dist * ai.speed;
+      }
+    } break;
+    }
+
+    transform.x = SDL_clamp(x, minXFromEdge, W_WIDTH - minXFromEdge);
+    transform.y = SDL_clamp(y, ai.minY, ai.maxY);
+  }
+}
+
+void EntityManager::updateWeapons(Player *player) {
+  for (int i = 0; i < weapons.size(); i++) {
+    WeaponComponent &weapon = weapons[i];
+    if (weapon.fireTimer > 0) {
+      weapon.fireTimer--;
+      continue;
+    }
+    weapon.fireTimer = weapon.fireRate;
+
+    // Copied, spawning may move the transform array
+    TransformComponent transform = transforms.get(weapons.owner(i));
+    float angle = std::atan2(player->getY() - transform.y,
+                             player->getX() - transform.x) *
+                  180.0f / (float)M_PI;
+    spawnProjectile(transform.x, transform.y, angle, weapon.projectileSpeed,
+                    weapon.damage, weapon.hitChance);
+  }
+}
+
+void EntityManager::updateProjectiles(Player *player) {
+  for (int i = 0; i < projectiles.size(); i++) {
+    const ProjectileComponent &projectile = projectiles[i];
+    Entity entity = projectiles.owner(i);
+    TransformComponent &transform = transforms.get(entity);
+    transform.x += projectile.vx;
+    transform.y += projectile.vy;
+
+    // Boxes touch
+    float halfWidth = projectileWidth / 2.0f;
+    float halfHeight = projectileHeight / 2.0f;
+    bool hit = transform.x + halfWidth >= player->getX() &&
+               transform.x - halfWidth <= player->getX() + player->getWidth() &&
+               transform.y + halfHeight >= player->getY() &&
+               transform.y - halfHeight <= player->getY() + player->getHeight();
+    if (hit) {
+      // Always gone, only sometimes hurts
+      if (chance(rng) < projectile.hitChance) {
+        player->takeDamage(projectile.damage);
+      }
+      pendingDestroy.push_back(entity);
+    } else if (transform.x < -projectileWidth ||
+               transform.x > W_WIDTH + projectileWidth ||
+               transform.y < -projectileHeight ||
+               transform.y > W_HEIGHT + projectileHeight) {
+      pendingDestroy.push_back(entity);
+    }
+  }
+}
+
+void EntityManager::flushDestroyed() {
+  for (Entity entity : pendingDestroy) {
+    destroy(entity);
+  }
+  pendingDestroy.clear();
+}
+// Code created by Mouttaki Omar(王明清)
@@ -0,0 +1,260 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cmath>
+
+// Present intervals kept for the statistics
+#define FRAME_PACER_HISTORY 120
+// Seconds between two statistics lines in the log
+#define FRAME_PACER_LOG_PERIOD 10.0
+// Missed or recovered frames in a row before adaptive vsync switches
+#define FRAME_PACER_ADAPT_FRAMES 8
+
+enum FramePacing {
+  FRAME_PACING_UNCAPPED,      // Present as fast as possible, tears
+  FRAME_PACING_CAP,           // Sleep then spin to the target rate, tears
+  FRAME_PACING_VSYNC,         // Block on the display refresh
+  FRAME_PACING_ADAPTIVE_VSYNC // Vsync, but tear instead of dropping to half rate
+};
+
+// Measured present intervals, in milliseconds
+struct FramePacerStats {
+  double averageInterval = 0.0;
+  double jitter = 0.0; // Standard deviation of the interval
+  double maxInterval = 0.0;
+  int sampleCount = 0;
+};
+
+// Paces Game::run. Levels advance by one fixed 1/60 s step per frame, so
+// every mode except FRAME_PACING_UNCAPPED keeps the frame rate at targetFps:
+// vsync paces on its own when the display refresh matches, otherwise a
+// sleep+spin wait holds each present until its deadline. SDL_Delay overshoot
+// is measured and the last stretch is spun instead of slept.
+//
+// With late input the wait moves in front of input sampling. beginFrame
+// sleeps until the next present minus the predicted update+render time, so
+// input is read as close to the present as the frame allows.
+class FramePacer {
+public:
+  void init(SDL_Renderer *target, SDL_Window *window, FramePacing mode,
+            int targetFps, bool lateInput) {
+    renderer = target;
+    frequency = (double)SDL_GetPerformanceFrequency();
+    targetPeriod = 1.0 / targetFps;
+    refreshPeriod = targetPeriod;
+
+    SDL_DisplayMode displayMode;
+    if (SDL_GetWindowDisplayMode(window, &displayMode) == 0 &&
+        displayMode.refresh_rate > 0) {
+      refreshPeriod = 1.0 / displayMode.refresh_rate;
+    }
+
+    setLateInput(lateInput);
+    setMode(mode);
+    lastPresent = SDL_GetPerformanceCounter();
+    deadline = lastPresent;
+    lastLog = lastPresent;
+  }
+
+  void setMode(FramePacing newMode) {
+    mode = newMode;
+    vsync = mode == FRAME_PACING_VSYNC || mode == FRAME_PACING_ADAPTIVE_VSYNC;
+    driverAdaptive = false;
+    if (vsync && SDL_RenderSetVSync(renderer, 1) != 0) {
+      SDL_Log("FramePacer: Vsync unavailable (%s), capping instead",
+              SDL_GetError());
+      vsync = false;
+    } else if (!vsync) {
+      SDL_RenderSetVSync(renderer, 0);
+    }
+
+    // OpenGL can tear late frames itself (swap interval -1)
+    if (vsync && mode == FRAME_PACING_ADAPTIVE_VSYNC) {
+      SDL_RendererInfo info;
+      if (SDL_GetRendererInfo(renderer, &info) == 0 &&
+          SDL_strncmp(info.name, "opengl", 6) == 0) {
+        driverAdaptive = SDL_GL_SetSwapInterval(-1) == 0;
+      }
+    }
+    vsyncSuspended = false;
+    adaptCount = 0;
+
+    // Vsync alone only paces correctly when the display runs at the target
+    // rate, a 144 Hz panel still needs the timer
+    bool refreshMatches = SDL_fabs(refreshPeriod - targetPeriod) * targetFps() < 0.02;
+    capping = mode != FRAME_PACING_UNCAPPED && !(vsync && refreshMatches);
+
+    SDL_Log("FramePacer: %s at %d fps%s%s", modeName(),
+            targetFps(), capping ? ", timer capped" : "",
+            lateInput ? ", late input" : "");
+  }
+  FramePacing getMode() const { return mode; }
+
+  void setLateInput(bool late) { lateInput = late; }
+  bool getLateInput() const { return lateInput; }
+
+  // Call before polling input
+  void beginFrame() {
+    if (lateInput && mode != FRAME_PACING_UNCAPPED) {
+      // Half a millisecond and a quarter of the estimate absorb noise
+      double lead = workEstimate * 1.25 + 0.0005;
+      Uint64 present = timerPaced() ? deadline + toCounter(targetPeriod)
+                                    : lastPresent + toCounter(refreshPeriod);
+      Uint64 inputTime = present - SDL_min(toCounter(lead), present - lastPresent);
+      waitUntil(inputTime);
+    }
+    frameStart = SDL_GetPerformanceCounter();
+  }
+
+  // Replaces SDL_RenderPresent
+  void present() {
+    Uint64 workEnd = SDL_GetPerformanceCounter();
+    double work = toSeconds(workEnd - frameStart);
+    workEstimate = workEstimate == 0.0 ? work : workEstimate * 0.9 + work * 0.1;
+    // Spikes count at once so late input does not miss the next deadline
+    workEstimate = SDL_max(workEstimate, work * 0.75);
+
+    if (timerPaced()) {
+      deadline += toCounter(targetPeriod);
+      // Fell more than a frame behind, do not rush to catch up
+      if (workEnd > deadline + toCounter(targetPeriod)) {
+        deadline = workEnd;
+      }
+      waitUntil(deadline);
+    }
+
+    SDL_RenderPresent(renderer);
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    double interval = toSeconds(now - lastPresent);
+    lastPresent = now;
+    record(interval);
+    if (mode == FRAME_PACING_ADAPTIVE_VSYNC && vsync && !driverAdaptive) {
+      adapt(work);
+    }
+
+    if (toSeconds(now - lastLog) >= FRAME_PACER_LOG_PERIOD) {
+      lastLog = now;
+      FramePacerStats stats = getStats();
+      SDL_Log("FramePacer: present %.2f ms avg, %.2f ms jitter, %.2f ms max "
+              "over %d frames",
+              stats.averageInterval, stats.jitter, stats.maxInterval,
+              stats.sampleCount);
+    }
+  }
+
+  FramePacerStats getStats() const {
+    FramePacerStats stats;
+    stats.sampleCount = historyCount;
+    if (historyCount == 0)
+      return stats;
+
+    double sum = 0.0;
+    for (int i = 0; i < historyCount; i++) {
+      sum += history[i];
+      stats.maxInterval = SDL_max(stats.maxInterval, history[i]);
+    }
+    double mean = sum / historyCount;
+    double variance = 0.0;
+    for (int i = 0; i < historyCount; i++) {
+      variance += (history[i] - mean) * (history[i] - mean);
+    }
+    stats.averageInterval = mean * 1000.0;
+    stats.jitter = std::sqrt(variance / historyCount) * 1000.0;
+    stats.maxInterval *= 1000.0;
+    return stats;
+  }
+
+private:
+  const char *modeName() const {
+    switch (mode) {
+    case FRAME_PACING_CAP:
+      return "frame cap";
+    case FRAME_PACING_VSYNC:
+      return vsync ? "vsync" : "frame cap (no vsync)";
+    case FRAME_PACING_ADAPTIVE_VSYNC:
+      if (!vsync)
+        return "frame cap (no vsync)";
+      return driverAdaptive ? "adaptive vsync (driver)" : "adaptive vsync";
+    default:
+      return "uncapped";
+    }
+  }
+
+  int targetFps() const { return (int)(1.0 / targetPeriod + 0.5); }
+
+  // Suspended vsync falls back to the timer
+  bool timerPaced() const { return capping || vsyncSuspended; }
+
+  Uint64 toCounter(double seconds) const { return (Uint64)(seconds * frequency); }
+  double toSeconds(Uint64 counter) const { return counter / frequency; }
+
+  // Sleeps while the remaining time is above the worst SDL_Delay overshoot
+  // seen, then spins
+  void waitUntil(Uint64 target) {
+    for (;;) {
+      Uint64 now = SDL_GetPerformanceCounter();
+      if (now >= target)
+        return;
+      double remaining = toSeconds(target - now);
+      if (remaining > sleepOvershoot + 0.001) {
+        Uint32 ms = (Uint32)((remaining - sleepOvershoot) * 1000.0);
+        SDL_Delay(ms);
+        double overshoot = toSeconds(SDL_GetPerformanceCounter() - now) - ms / 1000.0;
+        // Grow at once, shrink slowly
+        sleepOvershoot = SDL_max(overshoot, sleepOvershoot * 0.99);
+      } else {
+        SDL_CPUPauseInstruction();
+      }
+    }
+  }
+
+  void record(double interval) {
+    history[historyNext] = interval;
+    historyNext = (historyNext + 1) % FRAME_PACER_HISTORY;
+    historyCount = SDL_min(historyCount + 1, FRAME_PACER_HISTORY);
+  }
+
+  // Adaptive vsync without driver support: drop vsync while frames miss the
+  // refresh, take it back once they fit again
+  void adapt(double work) {
+    bool late = work > refreshPeriod;
+    bool fits = work < refreshPeriod * 0.8;
+    if ((!vsyncSuspended && late) || (vsyncSuspended && fits)) {
+      adaptCount++;
+    } else {
+      adaptCount = 0;
+    }
+    if (adaptCount < FRAME_PACER_ADAPT_FRAMES)
+      return;
+
+    adaptCount = 0;
+    vsyncSuspended = !vsyncSuspended;
+    SDL_RenderSetVSync(renderer, vsyncSuspended ? 0 : 1);
+    SDL_Log("FramePacer: Vsync %s", vsyncSuspended ? "suspended" : "resumed");
+  }
+
+  SDL_Renderer *renderer = nullptr;
+  FramePacing mode = FRAME_PACING_UNCAPPED;
+  bool lateInput = false;
+  bool vsync = false;
+  bool driverAdaptive = false;
+  bool vsyncSuspended = false;
+  bool capping = false;
+  int adaptCount = 0;
+
+  double frequency = 1.0;
+  double targetPeriod = 1.0 / 60.0;
+  double refreshPeriod = 1.0 / 60.0;
+  double workEstimate = 0.0;
+  double sleepOvershoot = 0.001;
+
+  Uint64 frameStart = 0;
+  Uint64 lastPresent = 0;
+  Uint64 deadline = 0;
+  Uint64 lastLog = 0;
+
+  double history[FRAME_PACER_HISTORY] = {};
+  int historyNext = 0;
+  int historyCount = 0;
+};
+// Code created by Mouttaki Omar(王明清)
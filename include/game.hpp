@@ -1,10 +1,15 @@
 #include "CONSTANTS.hpp"
 #include "SDL2/SDL_log.h"
+#include "alloctracker.hpp"
 #include "levels/Credits.hpp"
 #include "levels/LevelLamp.hpp"
 #include "levels/LevelLast.hpp"
 #include "levels/LevelHardParkour.hpp"
+#include "assetpack.hpp"
+#include "framepacer.hpp"
 #include "mainmenu.hpp"
+#include "profiler.h"
+#include "renderscaler.hpp"
 #include <GameState.hpp>
 #include <SDL2/SDL.h>
 #include <levels/Level.hpp>
@@ -29,12 +34,17 @@ private:
   SDL_Window *window;
   SDL_Renderer *renderer;
   SDL_Event event;
+  FramePacer framePacer;
   Level *current_level_obj = nullptr;
   int current_level = 0;
 };
 
 Game::Game() {
-  // Initialization
+  // Initialization, the allocation hooks go in before SDL allocates anything
+  ALLOC_TRACKER.install();
+  ALLOC_TRACKER.setTestMode(W_ALLOCATION_TEST, W_TARGET_FPS * 2);
+  profilerSetThreadName("main");
+  PROFILER.setHitchThreshold(W_HITCH_THRESHOLD_MS);
   if (SDL_Init(SDL_INIT_VIDEO) < 0) {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s",
                  SDL_GetError());
@@ -56,7 +66,8 @@ Game::Game() {
     exit(1);
   }
   // Window, audio and renderer
-  this->window = SDL_CreateWindow(W_NAME, 300, 100, W_WIDTH, W_HEIGHT, W_TYPE);
+  this->window = SDL_CreateWindow(W_NAME, 300, 100, W_WINDOW_WIDTH,
+                                  W_WINDOW_HEIGHT, W_TYPE);
   if (this->window == NULL) {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create window: %s",
                  SDL_GetError());
@@ -73,6 +84,12 @@ Game::Game() {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create renderer: %s",
                  SDL_GetError());
   }
+  // Everything below draws at W_WIDTH x W_HEIGHT whatever the window size
+  RENDER_SCALER.init(renderer, W_RENDER_SCALE, W_INTEGER_SCALE);
+  framePacer.init(renderer, window, FRAME_PACING_ADAPTIVE_VSYNC, W_TARGET_FPS,
+                  W_LATE_INPUT);
+  // Images come from the pack when there is one, see make pack
+  ASSET_PACK.open(ASSET_PACK_PATH, renderer);
   // Music
   SOUND_MANAGER.loadMusic("menu", "assets/music/Sadness to happiness.wav");
   SOUND_MANAGER.loadMusic("boss", "assets/music/La Fiola 2.wav");
@@ -97,6 +114,7 @@ Game::Game() {
       NULL, [] { GameState::running = false; });
 }
 void Game::update() {
+  PROFILE_ZONE("Game::update");
 
   // Loading and updating the current level
   if (!GameState::isMenu && GameState::current_level >= 0 &&
@@ -109,6 +127,7 @@ void Game::update() {
   } // Showing a loading screen while the level is loading(it may not be shown
     // cause loading level's is pretty fast)
   else if (GameState::isLoading) {
+    PROFILE_ZONE("level transition");
     switch (GameState::current_level) {
     case 0:
       if (current_level_obj != nullptr) {
@@ -164,9 +183,16 @@ void Game::update() {
 }
 void Game::run() {
   while (GameState::running) {
+    ALLOC_TRACKER.beginFrame();
+    framePacer.beginFrame();
+    TEXTURE_REGISTRY.beginFrame();
     handleEvents();
     update();
     render();
+    // Outside the tracked frame, a hitch trace allocates while it is written
+    ALLOC_TRACKER.endFrame(!GameState::isMenu && !GameState::isLoading &&
+                           GameState::current_level >= 0);
+    PROFILER.endFrame();
   }
 }
 void Game::render() {
@@ -174,6 +200,8 @@ void Game::render() {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Renderer is not initialized!");
     return;
   }
+  PROFILE_ZONE("Game::render");
+  RENDER_SCALER.begin();
   SDL_RenderClear(renderer);
   // rendering the menu
   if (GameState::isMenu || GameState::current_level < 0) {
@@ -194,31 +222,75 @@ void Game::render() {
     current_level_obj->render(renderer);
   }
 
-  SDL_RenderPresent(renderer);
+  RENDER_SCALER.end();
+  PROFILE_ZONE("present");
+  framePacer.present();
 }
 
 void Game::handleEvents() {
-  SDL_PollEvent(&event);
-  if (event.type == SDL_QUIT) {
-    GameState::running = false;
-  }
+  PROFILE_ZONE("Game::handleEvents");
+  // Drain everything queued since the last frame, with late input this runs
+  // right before the present
+  while (SDL_PollEvent(&event)) {
+    if (event.type == SDL_QUIT) {
+      GameState::running = false;
+    }
+    // Menus and levels work in logical coordinates
+    RENDER_SCALER.translateEvent(&event);
 
-  // Modified menu event handling to ensure it works after returning from
-  // credits
-  if (GameState::isMenu || GameState::current_level < 0) {
-    if (menu != nullptr) {
-      menu->handleEvents(event);
+    // Modified menu event handling to ensure it works after returning from
+    // credits
+    if (GameState::isMenu || GameState::current_level < 0) {
+      if (menu != nullptr) {
+        menu->handleEvents(event);
+      }
+    }
+    // Handle events for the current level
+    else if (GameState::current_level >= 0 && !GameState::isLoading) {
+      current_level_obj->handleEvents(&event, renderer);
     }
-  }
-  // Handle events for the current level
-  else if (GameState::current_level >= 0 && !GameState::isLoading) {
-    current_level_obj->handleEvents(&event, renderer);
-  }
 
-  if (event.type == SDL_KEYDOWN) {
-    // make sdl break the game if Q was pressed
-    if (event.key.keysym.sym == SDLK_q) {
-      GameState::running = false;
+    if (event.type == SDL_KEYDOWN) {
+      // make sdl break the game if Q was pressed
+      if (event.key.keysym.sym == SDLK_q) {
+        GameState::running = false;
+      }
+      // F6 logs texture memory by owner
+      if (event.key.keysym.sym == SDLK_F6) {
+        TEXTURE_REGISTRY.logUsage();
+      }
+      // F11 writes the profiler's last seconds as a Chrome trace
+      if (event.key.keysym.sym == SDLK_F11) {
+        PROFILER.dump("trace.json");
+      }
+      // F12 logs where the main thread allocated since the last F12
+      if (event.key.keysym.sym == SDLK_F12) {
+        ALLOC_TRACKER.logSites(20);
+        ALLOC_TRACKER.resetSites();
+      }
+      // F7 toggles late input, F8 cycles the frame pacing mode
+      if (event.key.keysym.sym == SDLK_F7) {
+        framePacer.setLateInput(!framePacer.getLateInput());
+        SDL_Log("Late input %s",
+                framePacer.getLateInput() ? "enabled" : "disabled");
+      }
+      if (event.key.keysym.sym == SDLK_F8) {
+        framePacer.setMode(
+            (FramePacing)((framePacer.getMode() + 1) %
+                          (FRAME_PACING_ADAPTIVE_VSYNC + 1)));
+      }
+      // F9 cycles the render scale through 50/75/100%, F10 toggles integer
+      // upscaling
+      if (event.key.keysym.sym == SDLK_F9) {
+        float scale = RENDER_SCALER.getRenderScale() + 0.25f;
+        RENDER_SCALER.setRenderScale(
+            scale > RENDER_SCALE_MAX ? RENDER_SCALE_MIN : scale);
+      }
+      if (event.key.keysym.sym == SDLK_F10) {
+        RENDER_SCALER.setIntegerScale(!RENDER_SCALER.getIntegerScale());
+        SDL_Log("Integer scaling %s",
+                RENDER_SCALER.getIntegerScale() ? "enabled" : "disabled");
+      }
     }
   }
 }
@@ -227,6 +299,9 @@ void Game::clean() {
   if (current_level_obj) {
     delete current_level_obj;
   }
+  RENDER_SCALER.clean();
+  ASSET_PACK.close();
+  TEXTURE_REGISTRY.clean();
   SDL_DestroyRenderer(renderer);
   SDL_DestroyWindow(window);
   Mix_Quit();
@@ -0,0 +1,61 @@
+#pragma once
+#include "profiler.h"
+#include "theora/theoraplay.h"
+#include <SDL2/SDL.h>
+
+// Path and buffering of the intro cutscene played by LevelZero
+#define INTRO_VIDEO_PATH "assets/video/video.ogv"
+#define INTRO_VIDEO_MAXFRAMES 30
+
+// Keeps the intro decoder warm while the player is still on the menu.
+// Opening the Ogg stream, parsing the headers and decoding the first frames
+// happens on theoraplay's worker thread, so by the time Play is clicked the
+// level only has to pick up the already running decoder.
+class IntroVideo {
+public:
+  static IntroVideo &getInstance() {
+    static IntroVideo instance;
+    return instance;
+  }
+
+  // Starts decoding in the background, never blocks. Safe to call every frame.
+  void prewarm() {
+    if (decoder != nullptr)
+      return;
+    PROFILE_ZONE("IntroVideo::prewarm");
+    decoder = THEORAPLAY_startDecodeFile(INTRO_VIDEO_PATH, INTRO_VIDEO_MAXFRAMES,
+                                         THEORAPLAY_VIDFMT_IYUV, NULL, 1);
+    if (decoder == nullptr) {
+      SDL_Log("IntroVideo: Failed to start decoding %s", INTRO_VIDEO_PATH);
+      return;
+    }
+    SDL_Log("IntroVideo: Prebuffering %s", INTRO_VIDEO_PATH);
+  }
+
+  // Hands the decoder over to the caller, who becomes responsible for
+  // stopping it. Starts one right away if nothing was prebuffered.
+  THEORAPLAY_Decoder *take() {
+    prewarm();
+    THEORAPLAY_Decoder *taken = decoder;
+    decoder = nullptr;
+    return taken;
+  }
+
+  ~IntroVideo() {
+    if (decoder != nullptr) {
+      THEORAPLAY_stopDecode(decoder);
+      decoder = nullptr;
+    }
+  }
+
+private:
+  IntroVideo() = default;
+  IntroVideo(const IntroVideo &) = delete;
+  IntroVideo &operator=(const IntroVideo &) = delete;
+
+  THEORAPLAY_Decoder *decoder = nullptr;
+};
+
+// Helper macro for easier access
+#define INTRO_VIDEO IntroVideo::getInstance()
+// Code created by Mouttaki Omar(王明清)
@@ -1,18 +1,24 @@
 #pragma once
 #include "SDL2/SDL_mixer.h"
-#include "enemy.hpp"
+#include "collisionevents.hpp"
+#include "entities.hpp"
 #include <CONSTANTS.hpp>
 #include <SDL2/SDL.h>
 #include <box2d/box2d.h>
 #include <cstdio>
+#include <debugdraw.hpp>
 #include <player.hpp>
 #include <sprite.hpp>
+#include <timerwheel.hpp>
 #include <vector>
 #include <map>
 #include <string>
 #include <random>
 #include <ctime>
 
+// Event types the level's timer wheel queues, see Level::advanceTimers
+#define TIMER_EVENT_CRUMBLE 1 // data is the Block
+
 // Structure to represent a snowflake
 struct Snowflake {
   float x, y;        // Position
@@ -27,14 +33,14 @@ struct Snowflake {
 class Block : public Sprite {
 public:
   Block(SDL_Renderer* renderer, const char* path) 
-    : isCrumbling(false), crumbleTimer(-1.0f), timeToCrumble(2.0f), body(nullptr), isVisible(true) // Initialize new members
+    : isCrumbling(false), crumbleTimer(-1.0f), timeToCrumble(2.0f), crumbleTimerId(TIMER_NONE), body(nullptr), isVisible(true) // Initialize new members
   {
-    loadFromFile(path, renderer);
+    loadFromFile(path, renderer, "level");
     setSize(W_SPRITESIZE, W_SPRITESIZE);
   }
   
   Block(SDL_Texture* texture)
-    : isCrumbling(false), crumbleTimer(-1.0f), timeToCrumble(2.0f), body(nullptr), isVisible(true) // Initialize new members
+    : isCrumbling(false), crumbleTimer(-1.0f), timeToCrumble(2.0f), crumbleTimerId(TIMER_NONE), body(nullptr), isVisible(true) // Initialize new members
   {
     this->texture = texture;
     setSize(W_SPRITESIZE, W_SPRITESIZE);
@@ -47,8 +53,9 @@ public:
   
   char type;
   bool isCrumbling;      // Is the timer active?
-  float crumbleTimer;    // Time left before disappearing
+  float crumbleTimer;    // Time left before disappearing, refreshed from the timer each render
   float timeToCrumble;   // How long the block lasts after touch
+  TimerId crumbleTimerId; // Level timer that makes it disappear
   b2Body* body;          // Pointer to its physics body
   bool isVisible;        // Control rendering
   
@@ -92,6 +99,10 @@ public:
   void loadLevel() { isLoaded = true; }
   void unloadLevel() { isLoaded = false; }
   bool isLevelOver() { return this->over; };
+
+  // Makes a block disappear timeToCrumble seconds from now, unless it
+  // already is crumbling
+  void startCrumbling(Block *block);
   
   // Debug rendering toggle
   void toggleDebugDraw() { debugDraw = !debugDraw; }
@@ -110,12 +121,34 @@ protected:
   SDL_Renderer *renderer;
   b2World *world;
   bool isLoaded = false;
-  Enemy *enemy;
+  // Enemies and their projectiles, spawned from the E tiles
+  EntityManager entities;
+  std::vector<SDL_FPoint> enemySpawns;
   bool over = false;
   bool debugDraw = false;  // Flag to toggle debug drawing
+  PhysicsDebugDraw physicsDebugDraw;
   
-  // Queue for physics bodies to be destroyed safely after world step
-  std::vector<b2Body*> bodiesToDestroy;
+  // Queue for physics bodies to be removed safely after world step
+  std::vector<b2Body*> bodiesToRemove;
+
+  // Contacts recorded during the world step, handled after it
+  CollisionEventQueue collisions;
+
+  // Gameplay timers, ticked once per update. Subclasses schedule callbacks
+  // on it too
+  TimerWheel timers;
+
+  // Crumbling state of a block, see captureLoadedState
+  struct BlockState {
+    bool isCrumbling;
+    float crumbleTimer;
+    bool isVisible;
+  };
+
+  // Everything a restart needs, captured once the level file was read
+  b2WorldSnapshot loadedWorld;
+  PlayerSnapshot loadedPlayer;
+  std::vector<BlockState> loadedBlocks;
   
   // Texture cache to avoid reloading the same textures
   std::map<std::string, SDL_Texture*> textureCache;
@@ -130,6 +163,31 @@ protected:
   
   // Helper method to get or load a texture
   SDL_Texture* getTexture(const char* path, SDL_Renderer* renderer);
+
+  // Creates the Box2D world with the settings every level uses
+  void createWorld();
+
+  // Ticks the timers and handles the events they queued, update does it
+  // first thing. Levels that don't call Level::update call it themselves
+  void advanceTimers();
+
+  // Reacts to the collision events of the last step, update clears them
+  // afterwards. Overrides call the base version for crumbling blocks
+  virtual void handleCollisions();
+
+  // False when every body sleeps, the world step can be skipped then
+  bool hasAwakeBodies() const;
+
+  // Remembers the freshly loaded level, called at the end of readLevel
+  void captureLoadedState();
+
+  // Puts the world, the player and the blocks back to how they were loaded,
+  // without touching files, textures or allocating. Returns false if the
+  // world was rebuilt or bodies were created or destroyed since the capture
+  bool restoreLoadedState();
+
+  // Replaces every enemy and projectile with the enemies the map spawned
+  void respawnEnemies();
   
   // Debug rendering method
   void renderDebugCollisions(SDL_Renderer* renderer);
@@ -147,7 +205,7 @@ SDL_Texture* Level::getTexture(const char* path, SDL_Renderer* renderer) {
   
   // If not in cache, load it
   SDL_Texture* newTexture = nullptr;
-  SDL_Surface* loadedSurface = Texture::loadFromFile(path, renderer, newTexture);
+  SDL_Surface* loadedSurface = Texture::loadFromFile(path, renderer, newTexture, "level");
   
   if (loadedSurface == nullptr || newTexture == nullptr) {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
@@ -165,8 +223,7 @@ SDL_Texture* Level::getTexture(const char* path, SDL_Renderer* renderer) {
 
 Level::Level(SDL_Renderer *renderer) : gravity(0.0f, 0.7f), renderer(renderer) {
   // box2d setup
-  world = new b2World(gravity);
-  world->SetAllowSleeping(false);
+  createWorld();
 
   // Improved physics parameters
   b2BodyDef bodyDef;
@@ -178,8 +235,9 @@ Level::Level(SDL_Renderer *renderer) : gravity(0.0f, 0.7f), renderer(renderer) {
   player = nullptr;
   
   // Initialize snow effect
-  // Get screen dimensions
-  SDL_GetRendererOutputSize(renderer, &screenWidth, &screenHeight);
+  // Logical screen size, see RenderScaler
+  screenWidth = W_WIDTH;
+  screenHeight = W_HEIGHT;
   
   // Seed random generator
   randomGenerator.seed(static_cast<unsigned int>(time(nullptr)));
@@ -194,32 +252,66 @@ Level::~Level() {
   }
   blocks.clear();
 
+  // Clean up snowflake texture, unless it is the cached flake image
+  if (snowflakeTexture && textureCache.count("assets/snow/flake.png") == 0) {
+    TEXTURE_REGISTRY.destroy(snowflakeTexture);
+  }
+
   // Clean up texture cache
   for (auto& pair : textureCache) {
     if (pair.second) {
-      SDL_DestroyTexture(pair.second);
+      TEXTURE_REGISTRY.destroy(pair.second);
     }
   }
   textureCache.clear();
 
-  // Clean up snowflake texture
-  if (snowflakeTexture) {
-    SDL_DestroyTexture(snowflakeTexture);
-  }
+  // Report how much scratch the level needed so b2_stackSize can be tuned
+  b2MemoryStats memory = world->GetMemoryStats();
+  SDL_Log("Physics memory: stack peak %d/%d bytes (%d segments, %d heap "
+          "fallbacks), worker peak %d bytes, blocks peak %d bytes in %d chunks",
+          memory.stack.maxAllocation, memory.stack.capacity,
+          memory.stack.segmentCount, memory.stack.heapFallbackCount,
+          memory.workerStacks.maxAllocation, memory.block.maxLiveBytes,
+          memory.block.chunkCount);
 
   delete world; // Clean up Box2D world
   if (player) {
     delete player;
   }
   if (background) {
-    SDL_DestroyTexture(background);
+    TEXTURE_REGISTRY.destroy(background);
   }
 }
 
+void Level::createWorld() {
+  world = new b2World(gravity);
+  // Bodies at rest fall asleep, the player is woken by input and anything
+  // else by what touches it
+  world->SetAllowSleeping(true);
+  world->SetWorkerCount(SDL_min(SDL_GetCPUCount(), W_PHYSICS_WORKERS));
+  world->SetWideContactSolver(true);
+  world->SetContactListener(&collisions);
+  collisions.clear();
+  physicsDebugDraw.SetFlags(b2Draw::e_shapeBit | b2Draw::e_jointBit |
+                            b2Draw::e_contactPointBit);
+  world->SetDebugDraw(&physicsDebugDraw);
+}
+
+bool Level::hasAwakeBodies() const {
+  b2Body *const *bodies = world->GetBodies();
+  for (int i = 0; i < world->GetBodyCount(); i++) {
+    const b2Body *body = bodies[i];
+    if (body->GetType() != b2_staticBody && body->IsAwake()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void Level::loadLevelBackground(const char *path, SDL_Renderer *renderer) {
   // Load the background image
   SDL_Surface *loadedSurface =
-      Texture::loadFromFile(path, renderer, background);
+      Texture::loadFromFile(path, renderer, background, "level");
   if (loadedSurface == nullptr) {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
                  "Unable to load image %s! SDL_image Error: %s\n", path,
@@ -230,6 +322,11 @@ void Level::loadLevelBackground(const char *path, SDL_Renderer *renderer) {
 }
 
 void Level::readLevel(const char *path, SDL_Renderer *renderer) {
+  PROFILE_ZONE("Level::readLevel");
+  // A reload spawns the map's enemies again, drop the ones of the last read
+  enemySpawns.clear();
+  entities.clear();
+
   // Add conversion factor (pixels per meter)
   const float PPM = 32.0f;  // 32 pixels = 1 Box2D meter
 
@@ -292,6 +389,7 @@ void Level::readLevel(const char *path, SDL_Renderer *renderer) {
         // Add collision filtering
         blockFixtureDef.filter.categoryBits = 0x0001;  // Block category
         blockFixtureDef.filter.maskBits = 0xFFFF;      // Collide with everything
+        blockFixtureDef.userData.pointer = makeFixtureTag(FIXTURE_BLOCK, (Uint32)blocks.size());
         
         blockBody->CreateFixture(&blockFixtureDef);
       }
@@ -334,6 +432,7 @@ void Level::readLevel(const char *path, SDL_Renderer *renderer) {
         // Add collision filtering
         blockFixtureDef.filter.categoryBits = 0x0001;  // Block category
         blockFixtureDef.filter.maskBits = 0xFFFF;      // Collide with everything
+        blockFixtureDef.userData.pointer = makeFixtureTag(FIXTURE_BLOCK, (Uint32)blocks.size());
         
         blockBody->CreateFixture(&blockFixtureDef);
       }
@@ -373,8 +472,8 @@ void Level::readLevel(const char *path, SDL_Renderer *renderer) {
         blockFixtureDef.friction = 0.001f; 
         blockFixtureDef.restitution = 0.05f;
         
-        // Store the Block pointer in the fixture's user data for the listener
-        blockFixtureDef.userData.pointer = reinterpret_cast<uintptr_t>(block);
+        // Tag the fixture with the block's index, it is appended to blocks below
+        blockFixtureDef.userData.pointer = makeFixtureTag(FIXTURE_BLOCK, (Uint32)blocks.size());
         
         blockBody->CreateFixture(&blockFixtureDef);
       }
@@ -388,10 +487,10 @@ void Level::readLevel(const char *path, SDL_Renderer *renderer) {
       break;
     }
     case 'E': {
-      // enemy sprite
-      enemy = new Enemy(renderer);
-      enemy->setPosition(col * W_SPRITESIZE, row * W_SPRITESIZE);
-      enemy->setSize(W_SPRITESIZE, W_SPRITESIZE);
+      // enemy, as many as the map holds
+      SDL_FPoint spawn = {(float)(col * W_SPRITESIZE), (float)(row * W_SPRITESIZE)};
+      enemySpawns.push_back(spawn);
+      entities.spawnEnemy(renderer, spawn.x, spawn.y);
       break;
     }
     
@@ -427,9 +526,8 @@ void Level::readLevel(const char *path, SDL_Renderer *renderer) {
         exitFixtureDef.shape = &exitShape;
         exitFixtureDef.isSensor = true; // Make it a sensor so player passes through
         
-        // Store the Block pointer in userData to identify it during collision
-        // Use a struct or pair if you need to store more data later
-        exitFixtureDef.userData.pointer = reinterpret_cast<uintptr_t>(block); 
+        // Tag the sensor so collision events can tell the exit apart
+        exitFixtureDef.userData.pointer = makeFixtureTag(FIXTURE_EXIT, (Uint32)blocks.size());
         
         exitBody->CreateFixture(&exitFixtureDef);
         
@@ -453,51 +551,109 @@ void Level::readLevel(const char *path, SDL_Renderer *renderer) {
 
   fclose(file);
   SDL_Log("Loaded %zu blocks", blocks.size());
+
+  captureLoadedState();
 }
 
-void Level::update() {
-  // --- Update Crumbling Blocks --- 
-  float timeStep = 1.0f / 60.0f; // Assuming 60 FPS, get this properly if possible
-  
-  // Count crumbling blocks for debug
-  int crumblingBlockCount = 0;
-  
-  for (Block* block : blocks) {
-      // Ensure block pointer is valid before accessing members
-      if (!block) continue; 
-      
-      // Debug: Log parkour block state periodically 
-      if (block->type == 'p') {
-          static int frameCounter = 0;
-          if (frameCounter++ % 60 == 0) { // Log every 60 frames
-              SDL_Log("Parkour block status: isCrumbling=%d, timer=%.2f, isVisible=%d", 
-                     block->isCrumbling, block->crumbleTimer, block->isVisible);
-          }
-      }
-      
-      if (block->type == 'p' && block->isCrumbling) {
-          crumblingBlockCount++;
-          
-          block->crumbleTimer -= timeStep;
-          SDL_Log("Updating crumbling block timer: %.2f", block->crumbleTimer);
-          
-          if (block->crumbleTimer <= 0) {
-              // Timer finished, mark for destruction and hide
-              if (block->body && block->isVisible) { // Check if body exists and not already marked
-                  SDL_Log("Parkour block timer finished. Queuing body %p for destruction.", block->body);
-                  bodiesToDestroy.push_back(block->body);
-                  block->isVisible = false; // Stop rendering
-                  block->isCrumbling = false; // Stop timer updates
-                  block->body = nullptr; // Prevent adding again
-              }
-          }
+void Level::captureLoadedState() {
+  loadedWorld.Capture(world);
+
+  loadedBlocks.clear();
+  for (Block *block : blocks) {
+    loadedBlocks.push_back({block->isCrumbling, block->crumbleTimer, block->isVisible});
+  }
+
+  if (player) {
+    loadedPlayer = player->captureState();
+  }
+  SDL_Log("Captured level state: %d bytes of physics", loadedWorld.GetByteCount());
+}
+
+bool Level::restoreLoadedState() {
+  if (loadedBlocks.size() != blocks.size() || !loadedWorld.Restore(world)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < blocks.size(); i++) {
+    timers.cancel(blocks[i]->crumbleTimerId);
+    blocks[i]->crumbleTimerId = TIMER_NONE;
+    if (loadedBlocks[i].isCrumbling) {
+      blocks[i]->crumbleTimerId = timers.scheduleEvent(
+          TimerWheel::secondsToTicks(loadedBlocks[i].crumbleTimer), TIMER_EVENT_CRUMBLE, blocks[i]);
+    }
+    blocks[i]->isCrumbling = loadedBlocks[i].isCrumbling;
+    blocks[i]->crumbleTimer = loadedBlocks[i].crumbleTimer;
+    blocks[i]->isVisible = loadedBlocks[i].isVisible;
+  }
+
+  if (player) {
+    player->restoreState(loadedPlayer);
+  }
+  respawnEnemies();
+  bodiesToRemove.clear();
+  collisions.clear();
+  over = false;
+  return true;
+}
+
+void Level::respawnEnemies() {
+  entities.clear();
+  for (const SDL_FPoint &spawn : enemySpawns) {
+    entities.spawnEnemy(renderer, spawn.x, spawn.y);
+  }
+}
+
+void Level::startCrumbling(Block *block) {
+  if (block->isCrumbling) {
+    return;
+  }
+  block->isCrumbling = true;
+  block->crumbleTimer = block->timeToCrumble;
+  block->crumbleTimerId = timers.scheduleEvent(TimerWheel::secondsToTicks(block->timeToCrumble),
+                                               TIMER_EVENT_CRUMBLE, block);
+  SDL_Log("Block starts crumbling, gone in %.2f s", block->timeToCrumble);
+}
+
+void Level::advanceTimers() {
+  timers.advance();
+
+  TimerEvent event;
+  while (timers.pollEvent(&event)) {
+    if (event.type == TIMER_EVENT_CRUMBLE) {
+      // Hide the block and queue its body, disabled after the world step
+      Block *block = static_cast<Block *>(event.data);
+      block->crumbleTimerId = TIMER_NONE;
+      block->isCrumbling = false;
+      block->crumbleTimer = 0.0f;
+      if (block->body && block->isVisible) {
+        bodiesToRemove.push_back(block->body);
+        block->isVisible = false;
       }
+    }
   }
-  
-  // Debug: log the count of crumbling blocks
-  if (crumblingBlockCount > 0) {
-      SDL_Log("Total crumbling blocks: %d", crumblingBlockCount);
+}
+
+void Level::handleCollisions() {
+  const CollisionEvent *events = collisions.getEvents();
+  for (int i = 0; i < collisions.getCount(); i++) {
+    const CollisionEvent &event = events[i];
+    // Parkour blocks start crumbling once the player lands on them
+    if (event.type == COLLISION_BEGIN && getFixtureKind(event.tagA) == FIXTURE_PLAYER &&
+        getFixtureKind(event.tagB) == FIXTURE_BLOCK) {
+      Uint32 index = getFixtureHandle(event.tagB);
+      if (index < blocks.size() && blocks[index]->type == 'p') {
+        startCrumbling(blocks[index]);
+      }
+    }
   }
+}
+
+void Level::update() {
+  // --- Fire Expired Timers ---
+  // Crumbling blocks and phase timeouts, only the timers due this tick cost
+  // anything
+  advanceTimers();
+  float timeStep = 1.0f / 60.0f; // Assuming 60 FPS, get this properly if possible
 
   // --- Update Player Physics --- 
   if (player) {
@@ -507,24 +663,43 @@ void Level::update() {
   // --- Step Physics World --- 
   const int velocityIterations = 8;
   const int positionIterations = 3;
-  if (world) { // Ensure world exists before stepping
+  // Skip the step entirely while everything sleeps, puzzle levels and a
+  // player standing still cost nothing that way
+  if (world && hasAwakeBodies()) { // Ensure world exists before stepping
+      PROFILE_ZONE("physics step");
       world->Step(timeStep, velocityIterations, positionIterations);
   }
 
-  // --- Destroy Queued Bodies --- 
-  // Safely destroy bodies AFTER the world step
-  if (world && !bodiesToDestroy.empty()) {
-       SDL_Log("Processing destruction queue: %zu bodies.", bodiesToDestroy.size());
-       for (b2Body* body : bodiesToDestroy) {
+  // --- Handle Collisions ---
+  // Everything the step recorded at once, plus contacts that ended when
+  // bodies were disabled last update
+  handleCollisions();
+  if (collisions.getDropped() > 0) {
+      SDL_Log("Collision queue full, %d events dropped", collisions.getDropped());
+  }
+  collisions.clear();
+
+  // --- Remove Queued Bodies --- 
+  // Safely remove bodies AFTER the world step. They are disabled rather than
+  // destroyed so restoreLoadedState can bring them back
+  if (world && !bodiesToRemove.empty()) {
+       SDL_Log("Processing removal queue: %zu bodies.", bodiesToRemove.size());
+       for (b2Body* body : bodiesToRemove) {
            if (body) { // Double check pointer is valid
-               SDL_Log("Destroying body %p", body);
-               world->DestroyBody(body);
+               // Whatever rested on the block has to start falling
+               for (b2ContactEdge *edge = body->GetContactList(); edge; edge = edge->next) {
+                   if (edge->contact->IsTouching()) {
+                       edge->other->SetAwake(true);
+                   }
+               }
+               SDL_Log("Disabling body %p", body);
+               body->SetEnabled(false);
            } else {
-               SDL_Log("Attempted to destroy a null body pointer in queue.");
+               SDL_Log("Attempted to remove a null body pointer in queue.");
            }
        }
-       bodiesToDestroy.clear(); // Clear the queue
-       SDL_Log("Destruction queue processed.");
+       bodiesToRemove.clear(); // Clear the queue
+       SDL_Log("Removal queue processed.");
   }
 
   // --- Update Player Position/State (Based on new physics state) --- 
@@ -546,6 +721,10 @@ void Level::render(SDL_Renderer *renderer) {
   }
   // Render the blocks
   for (Block *block : blocks) {
+    // The fade follows what is left on the crumble timer
+    if (block->isCrumbling) {
+      block->crumbleTimer = TimerWheel::ticksToSeconds(timers.getRemaining(block->crumbleTimerId));
+    }
     block->render(renderer, block->getX(), block->getY());
   }
   // Render the player
@@ -563,57 +742,11 @@ void Level::render(SDL_Renderer *renderer) {
 }
 
 void Level::renderDebugCollisions(SDL_Renderer* renderer) {
-  const float PPM = 32.0f;  // 32 pixels = 1 Box2D meter
-  
-  // Set debug draw color (semi-transparent red)
-  SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-  SDL_SetRenderDrawColor(renderer, 255, 0, 0, 128);
-  
-  // Iterate through all bodies in the world
-  for (b2Body* body = world->GetBodyList(); body; body = body->GetNext()) {
-    // Iterate through all fixtures on this body
-    for (b2Fixture* fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
-      // We only handle polygon shapes for now
-      if (fixture->GetType() == b2Shape::e_polygon) {
-        b2PolygonShape* poly = (b2PolygonShape*)fixture->GetShape();
-        
-        // Get vertex count
-        int vertexCount = poly->m_count;
-        
-        // Convert vertices to screen coordinates
-        SDL_Point points[b2_maxPolygonVertices];
-        for (int i = 0; i < vertexCount; i++) {
-          // Get vertex in world coordinates
-          b2Vec2 worldPoint = body->GetWorldPoint(poly->m_vertices[i]);
-          
-          // Convert to screen coordinates
-          points[i].x = (int)(worldPoint.x * PPM);
-          points[i].y = (int)(worldPoint.y * PPM);
-        }
-        
-        // Draw the polygon outline
-        for (int i = 0; i < vertexCount; i++) {
-          int j = (i + 1) % vertexCount;
-          SDL_RenderDrawLine(renderer, points[i].x, points[i].y, points[j].x, points[j].y);
-        }
-        
-        // Also draw a filled polygon with lower alpha
-        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 64);
-        if (vertexCount >= 3) {
-          // For simple boxes, we can use this approach
-          SDL_Rect rect;
-          rect.x = points[0].x;
-          rect.y = points[0].y;
-          rect.w = points[2].x - points[0].x;
-          rect.h = points[2].y - points[0].y;
-          SDL_RenderFillRect(renderer, &rect);
-        }
-        
-        // Reset color for next shape
-        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 128);
-      }
-    }
-  }
+  // Shapes, joints and contact points are batched by physicsDebugDraw and
+  // drawn with a couple of SDL_RenderGeometry calls
+  physicsDebugDraw.begin(renderer);
+  world->DebugDraw();
+  physicsDebugDraw.flush();
   
   // Also render the player's sprite bounds if debug is enabled
   if (player) {
@@ -624,9 +757,9 @@ void Level::renderDebugCollisions(SDL_Renderer* renderer) {
   SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
 }
 
-void Level::handleEvents(SDL_Event *event, SDL_Renderer *renderer) {
+void Level::handleEvents(SDL_Event *event, SDL_Renderer *) {
   if (player) {
-    player->handleEvents(event, renderer);
+    player->handleEvents(event);
   }
   
   // Toggle debug drawing with F1 key
@@ -645,7 +778,7 @@ void Level::initSnowEffect(SDL_Renderer *renderer) {
     SDL_Surface* surface = SDL_CreateRGBSurface(0, 16, 16, 32, 0, 0, 0, 0);
     if (surface) {
       SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, 255, 255, 255, 200));
-      snowflakeTexture = SDL_CreateTextureFromSurface(renderer, surface);
+      snowflakeTexture = TEXTURE_REGISTRY.createFromSurface(renderer, surface, "level");
       SDL_FreeSurface(surface);
     }
   }
@@ -5,103 +5,12 @@
 // Forward declare Player
 class Player;
 
-// Custom contact listener to detect player hitting the exit
-class MyContactListener : public b2ContactListener
-{
-public:
-    bool playerHitExit = false; // Flag to indicate player reached exit
-
-    void BeginContact(b2Contact *contact) override
-    {
-        // Get the two fixtures involved in the contact
-        b2Fixture *fixtureA = contact->GetFixtureA();
-        b2Fixture *fixtureB = contact->GetFixtureB();
-
-        // Debug: Log fixture contact
-        SDL_Log("Contact detected between fixtures: %p and %p", fixtureA, fixtureB);
-
-        // Get the user data from both fixtures
-        uintptr_t userDataA = fixtureA->GetUserData().pointer;
-        uintptr_t userDataB = fixtureB->GetUserData().pointer;
-
-        // Debug: Log user data
-        SDL_Log("User data pointers: %p and %p", (void *)userDataA, (void *)userDataB);
-
-        // Simplified detection: Try to cast each userData to Block* and check
-        Block *blockA = nullptr;
-        Block *blockB = nullptr;
-
-        if (userDataA)
-        {
-            blockA = reinterpret_cast<Block *>(userDataA);
-            // Only consider it a valid Block if it has a known block type
-            if (blockA && (blockA->type != 'p' && blockA->type != 'e' &&
-                           blockA->type != 'm' && blockA->type != 'D'))
-            {
-                blockA = nullptr; // Reset if not a valid block type
-            }
-        }
-
-        if (userDataB)
-        {
-            blockB = reinterpret_cast<Block *>(userDataB);
-            // Only consider it a valid Block if it has a known block type
-            if (blockB && (blockB->type != 'p' && blockB->type != 'e' &&
-                           blockB->type != 'm' && blockB->type != 'D'))
-            {
-                blockB = nullptr; // Reset if not a valid block type
-            }
-        }
-
-        // At this point, if one pointer is a block and one isn't,
-        // assume the non-block pointer is the player (or something else we don't care about)
-
-        // Check for exit block collision
-        if ((blockA && blockA->type == 'e') || (blockB && blockB->type == 'e'))
-        {
-            SDL_Log("Exit block collision detected!");
-            playerHitExit = true;
-        }
-
-        // Check for parkour block collision
-        Block *parkourBlock = nullptr;
-        if (blockA && blockA->type == 'p')
-        {
-            parkourBlock = blockA;
-        }
-        else if (blockB && blockB->type == 'p')
-        {
-            parkourBlock = blockB;
-        }
-
-        if (parkourBlock)
-        {
-            SDL_Log("Parkour block collision detected! Block type: %c", parkourBlock->type);
-
-            // Start crumble timer if not already crumbling
-            if (!parkourBlock->isCrumbling)
-            {
-                parkourBlock->isCrumbling = true;
-                parkourBlock->crumbleTimer = parkourBlock->timeToCrumble;
-                SDL_Log("Starting crumble timer for parkour block! Timer set to: %.2f",
-                        parkourBlock->crumbleTimer);
-            }
-            else
-            {
-                SDL_Log("Parkour block is already crumbling. Current timer: %.2f",
-                        parkourBlock->crumbleTimer);
-            }
-        }
-    }
-};
-
 class LevelHardParkour : public Level
 {
 private:
     int currentDifficulty;
     bool difficultyChanged;
-    MyContactListener contactListener; // Add contact listener instance
-    bool playerReachedExit = false;    // Flag set by contact listener
+    bool playerReachedExit = false;    // Flag set by handleCollisions
     SDL_Renderer *m_renderer;          // Store the renderer pointer
 
 public:
@@ -112,9 +21,6 @@ public:
         gravity = b2Vec2(0.0f, 0.5f);
         world->SetGravity(gravity);
 
-        // Set the custom contact listener for the world
-        world->SetContactListener(&contactListener);
-
         // Load level based on difficulty
         loadLevelWithDifficulty(m_renderer, currentDifficulty); // Use stored renderer
 
@@ -134,7 +40,6 @@ public:
 
         // Reset the exit flag when loading a new level
         playerReachedExit = false;
-        contactListener.playerHitExit = false;
 
         // Read level from file (this creates the player and blocks)
         readLevel(levelFilePath, renderer); // Use passed renderer
@@ -169,13 +74,6 @@ public:
     {
         Level::update(); // This steps the world and updates player
 
-        // Check if the contact listener flagged the exit collision
-        if (contactListener.playerHitExit)
-        {
-            playerReachedExit = true;
-            contactListener.playerHitExit = false; // Reset listener flag
-        }
-
         // If player reached exit, change difficulty using the stored renderer
         if (playerReachedExit)
         {
@@ -185,6 +83,23 @@ public:
         }
     }
 
+    void handleCollisions() override
+    {
+        // Parkour blocks crumble in the base level
+        Level::handleCollisions();
+
+        const CollisionEvent *events = collisions.getEvents();
+        for (int i = 0; i < collisions.getCount(); i++)
+        {
+            if (events[i].type == COLLISION_BEGIN && getFixtureKind(events[i].tagA) == FIXTURE_PLAYER &&
+                getFixtureKind(events[i].tagB) == FIXTURE_EXIT)
+            {
+                SDL_Log("Exit block collision detected!");
+                playerReachedExit = true;
+            }
+        }
+    }
+
     void render(SDL_Renderer *renderer) override
     {
         // First render all normal level elements
@@ -261,6 +176,14 @@ public:
 
     void restartLevel(SDL_Renderer *renderer)
     {
+        // Same layout as loaded: rewind it in place instead of rebuilding
+        if (!difficultyChanged && restoreLoadedState())
+        {
+            playerReachedExit = false;
+            SDL_Log("Level restarted from snapshot, difficulty: %d", currentDifficulty);
+            return;
+        }
+
         // --- 1. Delete C++ Objects ---
         // Delete player object first (its destructor might access world, but body is gone with world)
         if (player)
@@ -290,13 +213,11 @@ public:
         // --- 3. Reset State ---
         over = false;
         playerReachedExit = false;
-        contactListener.playerHitExit = false;
-        bodiesToDestroy.clear(); // Clear destruction queue too
+        bodiesToRemove.clear(); // Clear removal queue too
+        timers.clear();         // Crumble timers point at the deleted blocks
 
         // --- 4. Recreate World ---
-        world = new b2World(gravity); // Create new world
-        world->SetAllowSleeping(false);
-        world->SetContactListener(&contactListener); // Assign listener to new world
+        createWorld(); // Create new world
 
         // --- 5. Reload Level ---
         loadLevelWithDifficulty(renderer, currentDifficulty); // Use passed renderer
@@ -6,6 +6,7 @@
 #include <ctime>
 #include <string>
 #include <SDL2/SDL_ttf.h>
+#include "textlabel.hpp"
 
 enum LampState { ON_GREEN, ON_RED, OFF };
 
@@ -50,8 +51,7 @@ private:
   GamePhase currentPhase = SHOWING_PATTERN;
   int currentLevel = 0;
   bool isNewPhaseTimer = false;
-  uint32_t patternStartTime = 0;
-  uint32_t inputStartTime = 0;
+  TimerId phaseTimer = TIMER_NONE; // Ends the current phase, see onPhaseTimeout
   
   // Level configuration
   uint32_t getPatternShowTime() const { return 2000 + (currentLevel * 1000); }
@@ -65,7 +65,12 @@ private:
   bool checkPatternMatch();
   void resetLevel();
   void startNextLevel();
+  void enterPhase(GamePhase phase, Uint32 durationMs);
+  void onPhaseTimeout();
   TTF_Font* gameFont = nullptr;
+  TextLabel phaseLabel;
+  TextLabel levelLabel;
+  TextLabel timerLabel;
 };
 
 LevelLamp::LevelLamp(SDL_Renderer *renderer) : Level(renderer) {
@@ -78,21 +83,21 @@ LevelLamp::LevelLamp(SDL_Renderer *renderer) : Level(renderer) {
   // Load lamp textures
   SDL_Surface *surf = nullptr;
   
-  surf = Texture::loadFromFile("assets/lamps/green.png", renderer, green);
+  surf = Texture::loadFromFile("assets/lamps/green.png", renderer, green, "level");
   if(!green){
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Error loading green lamp");
     exit(1);
   }
   if(surf) SDL_FreeSurface(surf);
   
-  surf = Texture::loadFromFile("assets/lamps/red.png", renderer, red);
+  surf = Texture::loadFromFile("assets/lamps/red.png", renderer, red, "level");
   if(!red){
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Error loading red lamp");
     exit(1);
   }
   if(surf) SDL_FreeSurface(surf);
   
-  surf = Texture::loadFromFile("assets/lamps/off.png", renderer, off);
+  surf = Texture::loadFromFile("assets/lamps/off.png", renderer, off, "level");
   if(!off){
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Error loading off lamp");
     exit(1);
@@ -110,16 +115,16 @@ LevelLamp::LevelLamp(SDL_Renderer *renderer) : Level(renderer) {
   // Initialize game
   generatePattern();
   current_lamps = lamps;
-  patternStartTime = SDL_GetTicks();
+  enterPhase(SHOWING_PATTERN, getPatternShowTime());
   
   SDL_Log("Lamp level loaded successfully");
 }
 
 LevelLamp::~LevelLamp() {
   // Clean up textures
-  if (green) SDL_DestroyTexture(green);
-  if (red) SDL_DestroyTexture(red);
-  if (off) SDL_DestroyTexture(off);
+  if (green) TEXTURE_REGISTRY.destroy(green);
+  if (red) TEXTURE_REGISTRY.destroy(red);
+  if (off) TEXTURE_REGISTRY.destroy(off);
   
   // Clean up font
   if (gameFont) TTF_CloseFont(gameFont);
@@ -165,56 +170,53 @@ void LevelLamp::render(SDL_Renderer *renderer) {
 }
 
 void LevelLamp::update() {
-  uint32_t currentTime = SDL_GetTicks();
+  // Phase timeouts fire from the level's timers
+  Level::update();
+}
+
+void LevelLamp::enterPhase(GamePhase phase, Uint32 durationMs) {
+  timers.cancel(phaseTimer);
+  currentPhase = phase;
+  phaseTimer = timers.schedule(TimerWheel::msToTicks(durationMs), [this]() {
+    phaseTimer = TIMER_NONE;
+    onPhaseTimeout();
+  });
+}
 
+void LevelLamp::onPhaseTimeout() {
   switch (currentPhase) {
     case SHOWING_PATTERN:
-      if (currentTime - patternStartTime > getPatternShowTime()) {
-        // Clear all lamps in input grid
-        for (int i = 0; i < 8; i++) {
-          for (int j = 0; j < 6; j++) {
-            input_lamps[i][j].x = lamps[i][j].x;
-            input_lamps[i][j].y = lamps[i][j].y;
-            input_lamps[i][j].state = OFF;
-          }
+      // Clear all lamps in input grid
+      for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 6; j++) {
+          input_lamps[i][j].x = lamps[i][j].x;
+          input_lamps[i][j].y = lamps[i][j].y;
+          input_lamps[i][j].state = OFF;
         }
-        current_lamps = input_lamps;
-        currentPhase = PLAYER_INPUT;
-        inputStartTime = currentTime;
-        SDL_Log("Switching to PLAYER_INPUT phase at time: %u", currentTime);
       }
+      current_lamps = input_lamps;
+      enterPhase(PLAYER_INPUT, getInputTimeLimit());
+      SDL_Log("Switching to PLAYER_INPUT phase at tick: %u", timers.getNow());
       break;
       
     case PLAYER_INPUT:
-      if (currentTime - inputStartTime > getInputTimeLimit()) {
-        SDL_Log("Input time limit reached, switching to GAME_OVER");
-        currentPhase = GAME_OVER;
-        patternStartTime = currentTime;
-      }
+      SDL_Log("Input time limit reached, switching to GAME_OVER");
+      enterPhase(GAME_OVER, 2000);
       break;
       
     case PHASE_COMPLETE:
-      if (currentTime - patternStartTime > 1000) {
-        startNextLevel();
-      }
+      startNextLevel();
       break;
       
     case GAME_OVER:
-      if (currentTime - patternStartTime > 2000) {
-        resetLevel();
-      }
+      resetLevel();
       break;
       
     case GAME_WIN:
-      if (currentTime - patternStartTime > 2000) {
-        GameState::setCurrentLevel(GameState::current_level + 1);
-        GameState::isLoading = true;
-      }
+      GameState::setCurrentLevel(GameState::current_level + 1);
+      GameState::isLoading = true;
       break;
   }
-  
-  // Call base class update
-  Level::update();
 }
 
 void LevelLamp::handleEvents(SDL_Event *event, SDL_Renderer *renderer) {
@@ -256,8 +258,7 @@ void LevelLamp::handleEvents(SDL_Event *event, SDL_Renderer *renderer) {
         
         // Check if pattern is complete
         if (checkPatternMatch()) {
-          currentPhase = PHASE_COMPLETE;
-          patternStartTime = SDL_GetTicks();
+          enterPhase(PHASE_COMPLETE, 1000);
         }
       }
 
@@ -309,7 +310,7 @@ void LevelLamp::generatePattern() {
 void LevelLamp::renderPhaseInfo(SDL_Renderer *renderer) {
   if (!gameFont) return;
   
-  std::string phaseText;
+  const char *phaseText = "";
   SDL_Color textColor = {255, 255, 255, 255};
   
   switch (currentPhase) {
@@ -331,28 +332,15 @@ void LevelLamp::renderPhaseInfo(SDL_Renderer *renderer) {
   }
   
   // Render phase text
-  SDL_Surface* textSurface = TTF_RenderText_Solid(gameFont, phaseText.c_str(), textColor);
-  if (textSurface) {
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-    if (textTexture) {
-      SDL_Rect textRect = {(W_WIDTH - textSurface->w) / 2, 30, textSurface->w, textSurface->h};
-      SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-      SDL_DestroyTexture(textTexture);
-    }
-    SDL_FreeSurface(textSurface);
+  if (phaseLabel.set(renderer, gameFont, phaseText, textColor)) {
+    phaseLabel.render(renderer, (W_WIDTH - phaseLabel.getWidth()) / 2, 30);
   }
   
   // Render level info
-  std::string levelText = "Level: " + std::to_string(currentLevel + 1);
-  textSurface = TTF_RenderText_Solid(gameFont, levelText.c_str(), textColor);
-  if (textSurface) {
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-    if (textTexture) {
-      SDL_Rect textRect = {20, 20, textSurface->w, textSurface->h};
-      SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-      SDL_DestroyTexture(textTexture);
-    }
-    SDL_FreeSurface(textSurface);
+  char levelText[32];
+  snprintf(levelText, sizeof(levelText), "Level: %d", currentLevel + 1);
+  if (levelLabel.set(renderer, gameFont, levelText, textColor)) {
+    levelLabel.render(renderer, 20, 20);
   }
 }
 
@@ -371,22 +359,19 @@ void LevelLamp::resetLevel() {
   currentLevel = 0;
   generatePattern();
   current_lamps = lamps;
-  currentPhase = SHOWING_PATTERN;
-  patternStartTime = SDL_GetTicks();
+  enterPhase(SHOWING_PATTERN, getPatternShowTime());
 }
 
 void LevelLamp::startNextLevel() {
   currentLevel++;
   
   if (currentLevel >= 3) {
-    currentPhase = GAME_WIN;
+    enterPhase(GAME_WIN, 2000);
   } else {
     generatePattern();
     current_lamps = lamps;
-    currentPhase = SHOWING_PATTERN;
+    enterPhase(SHOWING_PATTERN, getPatternShowTime());
   }
-  
-  patternStartTime = SDL_GetTicks();
 }
 
 bool LevelLamp::isLevelComplete() {
@@ -397,14 +382,11 @@ bool LevelLamp::isLevelComplete() {
 void LevelLamp::renderTimer(SDL_Renderer *renderer) {
   if (!gameFont) return;
   
-  uint32_t currentTime = SDL_GetTicks();
   int timeRemaining = 0;
   
   // Calculate time remaining based on current phase
-  if (currentPhase == SHOWING_PATTERN) {
-    timeRemaining = (getPatternShowTime() - (currentTime - patternStartTime)) / 1000 + 1;
-  } else if (currentPhase == PLAYER_INPUT) {
-    timeRemaining = (getInputTimeLimit() - (currentTime - inputStartTime)) / 1000 + 1;
+  if (currentPhase == SHOWING_PATTERN || currentPhase == PLAYER_INPUT) {
+    timeRemaining = (int)TimerWheel::ticksToSeconds(timers.getRemaining(phaseTimer)) + 1;
   } else {
     return; // Don't show timer for other phases
   }
@@ -413,18 +395,12 @@ void LevelLamp::renderTimer(SDL_Renderer *renderer) {
   if (timeRemaining < 0) timeRemaining = 0;
   
   // Create timer text
-  std::string timerText = "Time: " + std::to_string(timeRemaining);
+  char timerText[32];
+  snprintf(timerText, sizeof(timerText), "Time: %d", timeRemaining);
   SDL_Color textColor = {255, 255, 0, 255}; // Yellow for timer
   
   // Render timer text
-  SDL_Surface* textSurface = TTF_RenderText_Solid(gameFont, timerText.c_str(), textColor);
-  if (textSurface) {
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-    if (textTexture) {
-      SDL_Rect textRect = {(W_WIDTH - textSurface->w) / 2, 70, textSurface->w, textSurface->h};
-      SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-      SDL_DestroyTexture(textTexture);
-    }
-    SDL_FreeSurface(textSurface);
+  if (timerLabel.set(renderer, gameFont, timerText, textColor)) {
+    timerLabel.render(renderer, (W_WIDTH - timerLabel.getWidth()) / 2, 70);
   }
 }
\ No newline at end of file
@@ -1,12 +1,12 @@
 #pragma once
 #include "GameState.hpp"
 #include "Level.hpp"
-#include "enemy.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <cstdint>
 #include <string>
 #include "soundmanager.hpp"
+#include "textlabel.hpp"
 
 
 class LevelLast : public Level {
@@ -19,6 +19,12 @@ public:
 
 private:
   TTF_Font *statsFont = nullptr;
+  TTF_Font *endFont = nullptr; // Large font of the end screen
+  TextLabel healthLabel;
+  TextLabel bulletsLabel;
+  TextLabel enemyHealthLabel;
+  TextLabel endMessageLabel;
+  TextLabel endSubMessageLabel;
   void renderPlayerStats(SDL_Renderer *renderer);
   void renderHealthBars(SDL_Renderer *renderer);
 
@@ -38,7 +44,7 @@ private:
   void renderGameEndScreen(SDL_Renderer *renderer);
 
   // Method to restart the level
-  void restartLevel(SDL_Renderer *renderer);
+  void restartLevel();
 };
 
 LevelLast::LevelLast(SDL_Renderer *renderer) : Level(renderer) {
@@ -52,12 +58,13 @@ LevelLast::LevelLast(SDL_Renderer *renderer) : Level(renderer) {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load font: %s",
                  TTF_GetError());
   }
+  // Opened up front, the end screen used to open it every frame
+  endFont = TTF_OpenFont("assets/fonts/ARCADECLASSIC.ttf", 72);
 
   SOUND_MANAGER.setMusicVolume(80);
   SOUND_MANAGER.playMusic("boss");
   SDL_Log("Level one loaded. Number of blocks: %zu", blocks.size());
   player->shouldShot(true);
-  enemy->linkToPlayer(player);
 }
 
 void LevelLast::update() {
@@ -71,13 +78,10 @@ void LevelLast::update() {
     }
   }
 
-  if (enemy) {
-    int enemyHealth = enemy->getHealth();
-    if (enemyHealth <= 0) {
-      SDL_Log("Enemy health is %d - triggering Win condition", enemyHealth);
-      isGameOver = true;
-      playerWon = true;
-    }
+  if (!enemySpawns.empty() && entities.getEnemyCount() == 0) {
+    SDL_Log("Every enemy is dead - triggering Win condition");
+    isGameOver = true;
+    playerWon = true;
   }
 
   // If game is over, don't update anything else
@@ -111,7 +115,7 @@ void LevelLast::update() {
   }
   Level::update();
 
-  if (enemy) {
+  if (entities.getEnemyCount() > 0) {
     // Update enemy movement pattern
     enemyMovementTimer++;
 
@@ -123,77 +127,74 @@ void LevelLast::update() {
       movementPattern = rand() % 4; // 5 different patterns
 
       // Make intervals shorter as enemy health decreases
-      float healthPercent = static_cast<float>(enemy->getHealth()) / 400.0f;
+      float healthPercent = entities.getHealthFraction();
       enemyMovementInterval = 120 * (0.3f + (0.7f * healthPercent));
 
       // Enemy becomes more aggressive at low health
       isEnemyAggressive = (healthPercent < 0.5f);
     }
 
-    // Apply the selected movement pattern
-    int screenWidth, screenHeight;
-    SDL_GetRendererOutputSize(SDL_GetRenderer(SDL_GetWindowFromID(1)),
-                              &screenWidth, &screenHeight);
-
-    float enemyX = enemy->getX();
-    float enemyY = enemy->getY();
+    // Apply the selected movement pattern to every enemy
     float moveSpeed = isEnemyAggressive ? 4.0f : 2.0f;
-
-    switch (movementPattern) {
-    case 0: // Circle around player
-      if (player) {
-        float angle = enemyMovementTimer * 0.05f;
-        float radius = isEnemyAggressive ? 150 : 250;
-        float targetX = player->getX() + cos(angle) * radius;
-        float targetY = player->getY() + sin(angle) * radius;
-
-        // Move towards target position
-        float dx = targetX - enemyX;
-        float dy = targetY - enemyY;
-        float dist = sqrt(dx * dx + dy * dy);
-
-        if (dist > 5) {
-          enemy->setPosition(
-              enemyX + (dx / dist) * moveSpeed,
-              std::max(200.0f, enemyY + (dy / dist) * moveSpeed));
+    for (int i = 0; i < entities.ais.size(); i++) {
+      TransformComponent &transform =
+          entities.transforms.get(entities.ais.owner(i));
+      float enemyX = transform.x;
+      float enemyY = transform.y;
+
+      switch (movementPattern) {
+      case 0: // Circle around player
+        if (player) {
+          float angle = enemyMovementTimer * 0.05f;
+          float radius = isEnemyAggressive ? 150 : 250;
+          float targetX = player->getX() + cos(angle) * radius;
+          float targetY = player->getY() + sin(angle) * radius;
+
+          // Move towards target position
+          float dx = targetX - enemyX;
+          float dy = targetY - enemyY;
+          float dist = sqrt(dx * dx + dy * dy);
+
+          if (dist > 5) {
+            transform.x = enemyX + (dx / dist) * moveSpeed;
+            transform.y = std::max(200.0f, enemyY + (dy / dist) * moveSpeed);
+          }
         }
-      }
-      break;
-    case 1: // Zigzag horizontal movement
-    {
-      float zigzagSpeed = isEnemyAggressive ? 6.0f : 3.0f;
-      float zigzagY = sin(enemyMovementTimer * 0.1f) * 50;
-      enemy->setPosition(enemyX +
-                             (isEnemyAggressive ? -zigzagSpeed : zigzagSpeed),
-                         std::max(200.0f, enemyY + zigzagY * 0.5f));
-
-      // Bounce off screen edges
-      if (enemyX < 50 || enemyX > screenWidth - 50) {
-        movementPattern = 3; // Switch to vertical movement
-      }
-    } break;
-
-    case 2: // Vertical bouncing
-    {
-      float bounceSpeed = isEnemyAggressive ? 5.0f : 2.5f;
-      enemy->setPosition(
-          enemyX, std::max(200.0f, enemyY + (sin(enemyMovementTimer * 0.05f) *
-                                             bounceSpeed)));
-    } break;
-
-    case 3: // Chase player (only when aggressive)
-      if (player && isEnemyAggressive) {
-        float dx = player->getX() - enemyX;
-        float dy = player->getY() - enemyY;
-        float dist = sqrt(dx * dx + dy * dy);
-
-        if (dist > 100) { // Don't get too close
-          enemy->setPosition(
-              enemyX + (dx / dist) * moveSpeed,
-              std::max(200.0f, enemyY + (dy / dist) * moveSpeed));
+        break;
+      case 1: // Zigzag horizontal movement
+      {
+        float zigzagSpeed = isEnemyAggressive ? 6.0f : 3.0f;
+        float zigzagY = sin(enemyMovementTimer * 0.1f) * 50;
+        transform.x =
+            enemyX + (isEnemyAggressive ? -zigzagSpeed : zigzagSpeed);
+        transform.y = std::max(200.0f, enemyY + zigzagY * 0.5f);
+
+        // Bounce off screen edges
+        if (enemyX < 50 || enemyX > W_WIDTH - 50) {
+          movementPattern = 3; // Switch to vertical movement
+        }
+      } break;
+
+      case 2: // Vertical bouncing
+      {
+        float bounceSpeed = isEnemyAggressive ? 5.0f : 2.5f;
+        transform.y = std::max(
+            200.0f, enemyY + (sin(enemyMovementTimer * 0.05f) * bounceSpeed));
+      } break;
+
+      case 3: // Chase player (only when aggressive)
+        if (player && isEnemyAggressive) {
+          float dx = player->getX() - enemyX;
+          float dy = player->getY() - enemyY;
+          float dist = sqrt(dx * dx + dy * dy);
+
+          if (dist > 100) { // Don't get too close
+            transform.x = enemyX + (dx / dist) * moveSpeed;
+            transform.y = std::max(200.0f, enemyY + (dy / dist) * moveSpeed);
+          }
         }
+        break;
       }
-      break;
     }
   }
 }
@@ -206,7 +207,7 @@ void LevelLast::render(SDL_Renderer *renderer) {
       isGameOver = true;
       playerWon = false;
     }
-    if (enemy && enemy->getHealth() <= 0) {
+    if (!enemySpawns.empty() && entities.getEnemyCount() == 0) {
       SDL_Log("Late detection - Enemy death in render");
       isGameOver = true;
       playerWon = true;
@@ -234,27 +235,19 @@ void LevelLast::render(SDL_Renderer *renderer) {
     }
   }
 
-  if (enemy && !isGameOver) {
-    enemy->update();
-    enemy->render(renderer);
+  if (!isGameOver) {
+    entities.update(player);
+    entities.render(renderer);
 
-    // Check player bullets hitting enemy
+    // Check player bullets hitting enemies
     if (player) {
-      // Store bullets to remove
-      std::vector<Bullet *> bulletsToRemove;
-
-      // Check collisions
-      for (const auto &bullet : player->getBulletsObj()) {
-        if (enemy->checkBulletCollision(bullet->getX(), bullet->getY())) {
-          enemy->takeDamage(15);
-          bulletsToRemove.push_back(bullet.get());
+      // Backwards, removing swaps the last bullet into the hole
+      const std::vector<Bullet> &bullets = player->getBulletsObj();
+      for (size_t i = bullets.size(); i-- > 0;) {
+        if (entities.hitTest(bullets[i].getX(), bullets[i].getY(), 15)) {
+          player->removeBullet(i);
         }
       }
-
-      // Remove collided bullets through the player interface
-      for (auto bullet : bulletsToRemove) {
-        player->removeBullet(bullet);
-      }
     }
   }
 
@@ -269,10 +262,7 @@ void LevelLast::render(SDL_Renderer *renderer) {
 
     // Apply blur effect by rendering a semi-transparent overlay
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 50); // Semi-transparent black
-    SDL_Rect fullScreen;
-    SDL_GetRendererOutputSize(renderer, &fullScreen.w, &fullScreen.h);
-    fullScreen.x = 0;
-    fullScreen.y = 0;
+    SDL_Rect fullScreen = {0, 0, W_WIDTH, W_HEIGHT};
     SDL_RenderFillRect(renderer, &fullScreen);
   }
 
@@ -290,62 +280,56 @@ void LevelLast::render(SDL_Renderer *renderer) {
   }
 }
 void LevelLast::renderHealthBars(SDL_Renderer *renderer) {
-  // Render enemy health bar
-  if (enemy) {
-    int maxHealth = 400; // Enemy's max health
-    int currentHealth = enemy->getHealth();
-    float healthPercent = static_cast<float>(currentHealth) / maxHealth;
-
-    // Position the health bar above the enemy
-    int barWidth = 100;
-    int barHeight = 10;
-    int barX = enemy->getX() - barWidth / 2;
-    int barY = enemy->getY() - enemy->getRect().h / 2 - 20;
-
-    // Draw background (black)
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_Rect bgRect = {barX, barY, barWidth, barHeight};
-    SDL_RenderFillRect(renderer, &bgRect);
-
-    // Draw health (red to green based on health percentage)
-    int healthWidth = static_cast<int>(barWidth * healthPercent);
-    int r = static_cast<int>(255 * (1 - healthPercent));
-    int g = static_cast<int>(255 * healthPercent);
-    SDL_SetRenderDrawColor(renderer, r, g, 0, 255);
-    SDL_Rect healthRect = {barX, barY, healthWidth, barHeight};
-    SDL_RenderFillRect(renderer, &healthRect);
-
-    // Draw border (white)
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    SDL_RenderDrawRect(renderer, &bgRect);
-
-    // Display enemy health number above health bar
-    if (statsFont) {
-      // Create health text
-      std::string enemyHealthText = std::to_string(currentHealth);
-
-      // Set text color (white)
-      SDL_Color textColor = {255, 255, 255, 255};
-
-      // Render health text
-      SDL_Surface *enemyHealthSurface =
-          TTF_RenderText_Solid(statsFont, enemyHealthText.c_str(), textColor);
-      if (enemyHealthSurface) {
-        SDL_Texture *enemyHealthTexture =
-            SDL_CreateTextureFromSurface(renderer, enemyHealthSurface);
-        if (enemyHealthTexture) {
-          // Position text above the health bar
-          SDL_Rect enemyHealthRect = {
-              barX + (barWidth - enemyHealthSurface->w) /
-                         2,                     // Center text above bar
-              barY - enemyHealthSurface->h - 5, // 5 pixels above the health bar
-              enemyHealthSurface->w, enemyHealthSurface->h};
-          SDL_RenderCopy(renderer, enemyHealthTexture, NULL, &enemyHealthRect);
-          SDL_DestroyTexture(enemyHealthTexture);
+  // Render enemy health bars
+  for (int i = 0; i < entities.healths.size(); i++) {
+      const HealthComponent &health = entities.healths[i];
+      const TransformComponent &transform =
+          entities.transforms.get(entities.healths.owner(i));
+      int maxHealth = health.max;
+      int currentHealth = health.current;
+      float healthPercent = static_cast<float>(currentHealth) / maxHealth;
+
+      // Position the health bar above the enemy
+      int barWidth = 100;
+      int barHeight = 10;
+      int barX = transform.x - barWidth / 2;
+      int barY = transform.y - W_SPRITESIZE / 2 - 20;
+
+      // Draw background (black)
+      SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+      SDL_Rect bgRect = {barX, barY, barWidth, barHeight};
+      SDL_RenderFillRect(renderer, &bgRect);
+
+      // Draw health (red to green based on health percentage)
+      int healthWidth = static_cast<int>(barWidth * healthPercent);
+      int r = static_cast<int>(255 * (1 - healthPercent));
+      int g = static_cast<int>(255 * healthPercent);
+      SDL_SetRenderDrawColor(renderer, r, g, 0, 255);
+      SDL_Rect healthRect = {barX, barY, healthWidth, barHeight};
+      SDL_RenderFillRect(renderer, &healthRect);
+
+      // Draw border (white)
+      SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+      SDL_RenderDrawRect(renderer, &bgRect);
+
+      // Display enemy health number above health bar, only for a lone boss as
+      // text for every enemy would cost more than the rest of the frame
+      if (statsFont && entities.healths.size() == 1) {
+        // Create health text
+        char enemyHealthText[16];
+        snprintf(enemyHealthText, sizeof(enemyHealthText), "%d", currentHealth);
+
+        // Set text color (white)
+        SDL_Color textColor = {255, 255, 255, 255};
+
+        // Render health text, centered 5 pixels above the health bar
+        if (enemyHealthLabel.set(renderer, statsFont, enemyHealthText,
+                                 textColor)) {
+          enemyHealthLabel.render(
+              renderer, barX + (barWidth - enemyHealthLabel.getWidth()) / 2,
+              barY - enemyHealthLabel.getHeight() - 5);
         }
-        SDL_FreeSurface(enemyHealthSurface);
       }
-    }
   }
 
   // Render player health bar
@@ -384,41 +368,27 @@ void LevelLast::renderPlayerStats(SDL_Renderer *renderer) {
     return;
 
   // Create health text in format "currentHealth/maxHealth"
-  std::string healthText = "HEALTH: " + std::to_string(player->getHealth()) +
-                           " / " + std::to_string(player->getMaxHealth());
+  // Formatted on the stack, the labels only redraw when a value changed
+  char healthText[32];
+  snprintf(healthText, sizeof(healthText), "HEALTH: %d / %d",
+           player->getHealth(), player->getMaxHealth());
 
   // Create bullets text
-  std::string bulletsText = "BULLETS: " + std::to_string(player->getBullets()) + " / 10";;
+  char bulletsText[32];
+  snprintf(bulletsText, sizeof(bulletsText), "BULLETS: %d / 10",
+           player->getBullets());
 
   // Set text color
   SDL_Color textColor = {255, 255, 255, 255}; // White
 
   // Render health text
-  SDL_Surface *healthSurface =
-      TTF_RenderText_Solid(statsFont, healthText.c_str(), textColor);
-  if (healthSurface) {
-    SDL_Texture *healthTexture =
-        SDL_CreateTextureFromSurface(renderer, healthSurface);
-    if (healthTexture) {
-      SDL_Rect healthRect = {20, 20, healthSurface->w, healthSurface->h};
-      SDL_RenderCopy(renderer, healthTexture, NULL, &healthRect);
-      SDL_DestroyTexture(healthTexture);
-    }
-    SDL_FreeSurface(healthSurface);
+  if (healthLabel.set(renderer, statsFont, healthText, textColor)) {
+    healthLabel.render(renderer, 20, 20);
   }
 
   // Render bullets text
-  SDL_Surface *bulletsSurface =
-      TTF_RenderText_Solid(statsFont, bulletsText.c_str(), textColor);
-  if (bulletsSurface) {
-    SDL_Texture *bulletsTexture =
-        SDL_CreateTextureFromSurface(renderer, bulletsSurface);
-    if (bulletsTexture) {
-      SDL_Rect bulletsRect = {20, 50, bulletsSurface->w, bulletsSurface->h};
-      SDL_RenderCopy(renderer, bulletsTexture, NULL, &bulletsRect);
-      SDL_DestroyTexture(bulletsTexture);
-    }
-    SDL_FreeSurface(bulletsSurface);
+  if (bulletsLabel.set(renderer, statsFont, bulletsText, textColor)) {
+    bulletsLabel.render(renderer, 20, 50);
   }
 }
 
@@ -428,9 +398,8 @@ void LevelLast::handleEvents(SDL_Event *event, SDL_Renderer *renderer) {
     if (player) {
       SDL_Log("Player health: %d/%d", player->getHealth(), player->getMaxHealth());
     }
-    if (enemy) {
-      SDL_Log("Enemy health: %d/400", enemy->getHealth());
-    }
+    SDL_Log("Enemies: %d, %.0f%% health left", entities.getEnemyCount(),
+            entities.getHealthFraction() * 100.0f);
     SDL_Log("Game over state: %s", isGameOver ? "true" : "false");
     SDL_Log("Current level: %d", GameState::current_level);
   }
@@ -446,7 +415,7 @@ void LevelLast::handleEvents(SDL_Event *event, SDL_Renderer *renderer) {
       }
       else if (event->key.keysym.sym == SDLK_g) {
         SDL_Log("Restarting level after game over");
-        restartLevel(renderer);
+        restartLevel();
         return;
       }
     }
@@ -458,9 +427,8 @@ void LevelLast::handleEvents(SDL_Event *event, SDL_Renderer *renderer) {
 
 }
 void LevelLast::renderGameEndScreen(SDL_Renderer *renderer) {
-  // Get screen dimensions
-  int screenWidth, screenHeight;
-  SDL_GetRendererOutputSize(renderer, &screenWidth, &screenHeight);
+  // Logical screen size, see RenderScaler
+  int screenWidth = W_WIDTH, screenHeight = W_HEIGHT;
 
   // Create semi-transparent overlay
   SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
@@ -468,14 +436,11 @@ void LevelLast::renderGameEndScreen(SDL_Renderer *renderer) {
   SDL_RenderFillRect(renderer, &overlay);
 
   // Prepare text to display
-  std::string mainMessage = playerWon ? "YOU WIN!" : "GAME OVER";
-  std::string subMessage = playerWon ? "Press C for Credits"
+  const char *mainMessage = playerWon ? "YOU WIN!" : "GAME OVER";
+  const char *subMessage = playerWon ? "Press C for Credits"
                                      : // Changed win message
                                "Press G to restart";
 
-  SDL_Log("Rendering end screen with message: %s",
-          mainMessage.c_str()); // Add debug logging
-
   // Set text color
   SDL_Color textColor =
       playerWon ? SDL_Color{255, 215, 0, 255}
@@ -483,66 +448,43 @@ void LevelLast::renderGameEndScreen(SDL_Renderer *renderer) {
   SDL_Color subTextColor = {255, 255, 255, 255}; // White for sub-message
 
   // Render main message (larger font)
-  TTF_Font *largeFont = TTF_OpenFont("assets/fonts/ARCADECLASSIC.ttf", 72);
-  if (largeFont) {
-    SDL_Surface *messageSurface =
-        TTF_RenderText_Solid(largeFont, mainMessage.c_str(), textColor);
-    if (messageSurface) {
-      SDL_Texture *messageTexture =
-          SDL_CreateTextureFromSurface(renderer, messageSurface);
-      if (messageTexture) {
-        SDL_Rect messageRect = {(screenWidth - messageSurface->w) / 2,
-                                (screenHeight - messageSurface->h) / 2 - 50,
-                                messageSurface->w, messageSurface->h};
-        SDL_RenderCopy(renderer, messageTexture, NULL, &messageRect);
-        SDL_DestroyTexture(messageTexture);
-      }
-      SDL_FreeSurface(messageSurface);
-    }
-    TTF_CloseFont(largeFont);
+  if (endMessageLabel.set(renderer, endFont, mainMessage, textColor)) {
+    endMessageLabel.render(
+        renderer, (screenWidth - endMessageLabel.getWidth()) / 2,
+        (screenHeight - endMessageLabel.getHeight()) / 2 - 50);
   }
 
   // Render sub-message
-  if (statsFont) {
-    SDL_Surface *subMessageSurface =
-        TTF_RenderText_Solid(statsFont, subMessage.c_str(), subTextColor);
-    if (subMessageSurface) {
-      SDL_Texture *subMessageTexture =
-          SDL_CreateTextureFromSurface(renderer, subMessageSurface);
-      if (subMessageTexture) {
-        SDL_Rect subMessageRect = {(screenWidth - subMessageSurface->w) / 2,
-                                   (screenHeight - subMessageSurface->h) / 2 +
-                                       50,
-                                   subMessageSurface->w, subMessageSurface->h};
-        SDL_RenderCopy(renderer, subMessageTexture, NULL, &subMessageRect);
-        SDL_DestroyTexture(subMessageTexture);
-      }
-      SDL_FreeSurface(subMessageSurface);
-    }
+  if (endSubMessageLabel.set(renderer, statsFont, subMessage, subTextColor)) {
+    endSubMessageLabel.render(
+        renderer, (screenWidth - endSubMessageLabel.getWidth()) / 2,
+        (screenHeight - endSubMessageLabel.getHeight()) / 2 + 50);
   }
 }
 
-void LevelLast::restartLevel(SDL_Renderer *renderer) {
+void LevelLast::restartLevel() {
   // Reset game state flags
   isGameOver = false;
   playerWon = false;
 
-  // Reload the level
-  readLevel("levels/lvl_last.txt", renderer);
+  // Rewind the world and the player to how the level was loaded. Reading the
+  // file again would add a second copy of every body
+  if (!restoreLoadedState()) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Could not restore the level state");
+    // Heal the player and bring the enemies back instead, or the restart
+    // would end right away, a win leaves none alive
+    if (player) {
+      player->takeDamage(player->getHealth() - player->getMaxHealth());
+    }
+    respawnEnemies();
+  }
 
-  // Reset player and enemy
+  // Reset player, the enemies were respawned with the level state
   if (player) {
-    player->takeDamage(-player->getMaxHealth()); // Heal to full health
     SDL_Log("Reset player health to %d", player->getHealth());
     player->shouldShot(true); // Make sure player can shoot
   }
 
-  if (enemy) {
-    enemy->takeDamage(-enemy->getMaxHealth()); // Heal to full health
-    SDL_Log("Reset enemy health to %d", enemy->getHealth());
-    enemy->linkToPlayer(player);
-  }
-
   // Reset other state variables
   timeScale = 1.0f;
   lastFrameTime = SDL_GetTicks();
@@ -554,5 +496,9 @@ LevelLast::~LevelLast() {
     TTF_CloseFont(statsFont);
     statsFont = nullptr;
   }
+  if (endFont) {
+    TTF_CloseFont(endFont);
+    endFont = nullptr;
+  }
 }
 // Code created by Mouttaki Omar(王明清)
\ No newline at end of file
@@ -2,8 +2,10 @@
 #include "Level.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <renderscaler.hpp>
 #include <soundmanager.hpp>
 #include <string>
+#include <textlabel.hpp>
 
 class LevelOne : public Level {
 public:
@@ -16,6 +18,11 @@ public:
 private:
   TTF_Font *statsFont = nullptr;
   TTF_Font *tutorialFont = nullptr;
+  static const int TUTORIAL_LINES = 8;
+  TextLabel healthLabel;
+  TextLabel bulletsLabel;
+  TextLabel tutorialLabels[TUTORIAL_LINES];
+  TextLabel advanceLabel;
   void renderPlayerStats(SDL_Renderer *renderer);
   void renderTutorial(SDL_Renderer *renderer);
 
@@ -71,7 +78,7 @@ LevelOne::LevelOne(SDL_Renderer *renderer) : Level(renderer) {
 
   // Get initial mouse position
   int x, y;
-  SDL_GetMouseState(&x, &y);
+  RENDER_SCALER.getMouseState(&x, &y);
   lastMouseX = x;
   lastMouseY = y;
 }
@@ -106,42 +113,27 @@ void LevelOne::renderPlayerStats(SDL_Renderer *renderer) {
   if (!player || !statsFont)
     return;
 
-  // Create health text in format "currentHealth/maxHealth"
-  std::string healthText = "HEALTH: " + std::to_string(player->getHealth()) +
-                           " / " + std::to_string(player->getMaxHealth());
+  // Formatted on the stack, the labels only redraw when a value changed
+  char healthText[32];
+  snprintf(healthText, sizeof(healthText), "HEALTH: %d / %d",
+           player->getHealth(), player->getMaxHealth());
 
   // Create bullets text
-  std::string bulletsText = "BULLETS: " + std::to_string(player->getBullets()) + " / 10";;
+  char bulletsText[32];
+  snprintf(bulletsText, sizeof(bulletsText), "BULLETS: %d / 10",
+           player->getBullets());
 
   // Set text color
   SDL_Color textColor = {255, 255, 255, 255}; // White
 
   // Render health text
-  SDL_Surface *healthSurface =
-      TTF_RenderText_Solid(statsFont, healthText.c_str(), textColor);
-  if (healthSurface) {
-    SDL_Texture *healthTexture =
-        SDL_CreateTextureFromSurface(renderer, healthSurface);
-    if (healthTexture) {
-      SDL_Rect healthRect = {20, 20, healthSurface->w, healthSurface->h};
-      SDL_RenderCopy(renderer, healthTexture, NULL, &healthRect);
-      SDL_DestroyTexture(healthTexture);
-    }
-    SDL_FreeSurface(healthSurface);
+  if (healthLabel.set(renderer, statsFont, healthText, textColor)) {
+    healthLabel.render(renderer, 20, 20);
   }
 
   // Render bullets text
-  SDL_Surface *bulletsSurface =
-      TTF_RenderText_Solid(statsFont, bulletsText.c_str(), textColor);
-  if (bulletsSurface) {
-    SDL_Texture *bulletsTexture =
-        SDL_CreateTextureFromSurface(renderer, bulletsSurface);
-    if (bulletsTexture) {
-      SDL_Rect bulletsRect = {20, 50, bulletsSurface->w, bulletsSurface->h};
-      SDL_RenderCopy(renderer, bulletsTexture, NULL, &bulletsRect);
-      SDL_DestroyTexture(bulletsTexture);
-    }
-    SDL_FreeSurface(bulletsSurface);
+  if (bulletsLabel.set(renderer, statsFont, bulletsText, textColor)) {
+    bulletsLabel.render(renderer, 20, 50);
   }
 }
 
@@ -152,140 +144,33 @@ void LevelOne::renderTutorial(SDL_Renderer *renderer) {
   SDL_Color textColor = {255, 255, 0, 255};  // Yellow for instructions
   SDL_Color advanceColor = {255, 0, 0, 255}; // Red for advance message
 
-  std::string instructionText;
+  static const char *const instructions[TUTORIAL_LINES] = {
+      "Use A and D keys to move left and right",
+      "Hold CTRL to walk slowly",
+      "Press SHIFT to dash",
+      "Move the mouse to aim",
+      "Press SPACE to jump",
+      "Press LEFT MOUSE BUTTON to shoot",
+      "Press R to reload",
+      "Press Ctrl+R to restart the parkour level",
+  };
   int yPos = 100;
   int yStep = 40; // Spacing between instructions
 
-  // Movement instructions
-  instructionText = "Use A and D keys to move left and right";
-  SDL_Surface *surface =
-      TTF_RenderText_Solid(tutorialFont, instructionText.c_str(), textColor);
-  if (surface) {
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture) {
-      SDL_Rect rect = {100, yPos, surface->w, surface->h};
-      SDL_RenderCopy(renderer, texture, NULL, &rect);
-      SDL_DestroyTexture(texture);
-    }
-    SDL_FreeSurface(surface);
-  }
-
-  // Walk slow instructions
-  yPos += yStep;
-  instructionText = "Hold CTRL to walk slowly";
-  surface =
-      TTF_RenderText_Solid(tutorialFont, instructionText.c_str(), textColor);
-  if (surface) {
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture) {
-      SDL_Rect rect = {100, yPos, surface->w, surface->h};
-      SDL_RenderCopy(renderer, texture, NULL, &rect);
-      SDL_DestroyTexture(texture);
-    }
-    SDL_FreeSurface(surface);
-  }
-
-  // Dash instructions
-  yPos += yStep;
-  instructionText = "Press SHIFT to dash";
-  surface =
-      TTF_RenderText_Solid(tutorialFont, instructionText.c_str(), textColor);
-  if (surface) {
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture) {
-      SDL_Rect rect = {100, yPos, surface->w, surface->h};
-      SDL_RenderCopy(renderer, texture, NULL, &rect);
-      SDL_DestroyTexture(texture);
-    }
-    SDL_FreeSurface(surface);
-  }
-
-  // Aim instructions
-  yPos += yStep;
-  instructionText = "Move the mouse to aim";
-  surface =
-      TTF_RenderText_Solid(tutorialFont, instructionText.c_str(), textColor);
-  if (surface) {
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture) {
-      SDL_Rect rect = {100, yPos, surface->w, surface->h};
-      SDL_RenderCopy(renderer, texture, NULL, &rect);
-      SDL_DestroyTexture(texture);
-    }
-    SDL_FreeSurface(surface);
-  }
-
-  // Jump instructions
-  yPos += yStep;
-  instructionText = "Press SPACE to jump";
-  surface =
-      TTF_RenderText_Solid(tutorialFont, instructionText.c_str(), textColor);
-  if (surface) {
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture) {
-      SDL_Rect rect = {100, yPos, surface->w, surface->h};
-      SDL_RenderCopy(renderer, texture, NULL, &rect);
-      SDL_DestroyTexture(texture);
-    }
-    SDL_FreeSurface(surface);
-  }
-
-  // Shoot instructions
-  yPos += yStep;
-  instructionText = "Press LEFT MOUSE BUTTON to shoot";
-  surface =
-      TTF_RenderText_Solid(tutorialFont, instructionText.c_str(), textColor);
-  if (surface) {
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture) {
-      SDL_Rect rect = {100, yPos, surface->w, surface->h};
-      SDL_RenderCopy(renderer, texture, NULL, &rect);
-      SDL_DestroyTexture(texture);
-    }
-    SDL_FreeSurface(surface);
-  }
-  yPos += yStep;
-  instructionText = "Press R to reload";
-  surface =
-      TTF_RenderText_Solid(tutorialFont, instructionText.c_str(), textColor);
-  if (surface) {
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture) {
-      SDL_Rect rect = {100, yPos, surface->w, surface->h};
-      SDL_RenderCopy(renderer, texture, NULL, &rect);
-      SDL_DestroyTexture(texture);
-    }
-    SDL_FreeSurface(surface);
-  }
-  yPos += yStep;
-  instructionText = "Press Ctrl+R to restart the parkour level";
-  surface =
-      TTF_RenderText_Solid(tutorialFont, instructionText.c_str(), textColor);
-  if (surface) {
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (texture) {
-      SDL_Rect rect = {100, yPos, surface->w, surface->h};
-      SDL_RenderCopy(renderer, texture, NULL, &rect);
-      SDL_DestroyTexture(texture);
+  for (int i = 0; i < TUTORIAL_LINES; i++) {
+    if (tutorialLabels[i].set(renderer, tutorialFont, instructions[i],
+                              textColor)) {
+      tutorialLabels[i].render(renderer, 100, yPos);
     }
-    SDL_FreeSurface(surface);
+    yPos += yStep;
   }
 
   // Advance to next level message
   if (showAdvanceMessage) {
-    yPos += yStep + 20; // Extra space before the final instruction
-    instructionText = "PRESS G TO CONTINUE";
-
-    surface = TTF_RenderText_Solid(tutorialFont, instructionText.c_str(),
-                                   advanceColor);
-    if (surface) {
-      SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-      if (texture) {
-        SDL_Rect rect = {100, yPos, surface->w, surface->h};
-        SDL_RenderCopy(renderer, texture, NULL, &rect);
-        SDL_DestroyTexture(texture);
-      }
-      SDL_FreeSurface(surface);
+    yPos += 20; // Extra space before the final instruction
+    if (advanceLabel.set(renderer, tutorialFont, "PRESS G TO CONTINUE",
+                         advanceColor)) {
+      advanceLabel.render(renderer, 100, yPos);
     }
   }
 }
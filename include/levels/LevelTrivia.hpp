@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include "soundmanager.hpp"
+#include "textlabel.hpp"
 
 class LevelTrivia : public Level {
 public:
@@ -36,15 +37,20 @@ private:
   // Question order tracking
   std::vector<int> questionOrder;
   
-  // Textures
-  std::vector<SDL_Texture*> questionBackgrounds;
+  // Textures, the question backgrounds are reloadable so the ones not on
+  // screen can be evicted under the texture budget
+  std::vector<TextureId> questionBackgrounds;
   SDL_Texture* inputBoxTexture = nullptr;
   SDL_Rect inputBoxRect;
   
   // Font and timer
   TTF_Font* gameFont = nullptr;
-  uint32_t questionStartTime = 0;
+  TextLabel questionLabel;
+  TextLabel phaseLabel;
+  TextLabel timerLabel;
+  TextLabel inputLabel;
   uint32_t timeLimit = 15000; // 15 seconds per question
+  TimerId phaseTimer = TIMER_NONE; // Ends the current phase, see onPhaseTimeout
   
   // Helper methods
   void renderQuestionInfo(SDL_Renderer *renderer);
@@ -53,22 +59,21 @@ private:
   void nextQuestion();
   void checkAnswer();
   void shuffleQuestions();
+  void enterPhase(GamePhase phase, Uint32 durationMs);
+  void onPhaseTimeout();
 };
 
 LevelTrivia::LevelTrivia(SDL_Renderer *renderer) : Level(renderer) {
   // Load question backgrounds
   for (int i = 1; i <= totalQuestions; i++) {
     std::string path = "assets/trivia/" + std::to_string(i) + ".png";
-    SDL_Texture* texture = nullptr;
-    SDL_Surface* surface = Texture::loadFromFile(path.c_str(), renderer, texture);
+    TextureId texture = TEXTURE_REGISTRY.load(path.c_str(), renderer, "trivia");
     
-    if (!texture) {
+    if (texture == TEXTURE_ID_NONE) {
       SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Error loading question background %d", i);
-    } else {
-      questionBackgrounds.push_back(texture);
     }
-    
-    if (surface) SDL_FreeSurface(surface);
+    // Kept even when missing so indices match the answers
+    questionBackgrounds.push_back(texture);
   }
   
   // Initialize question order
@@ -81,7 +86,7 @@ LevelTrivia::LevelTrivia(SDL_Renderer *renderer) : Level(renderer) {
   shuffleQuestions();
   
   // Load input box texture
-  SDL_Surface* inputBoxSurface = Texture::loadFromFile("assets/input_box/box.png", renderer, inputBoxTexture);
+  SDL_Surface* inputBoxSurface = Texture::loadFromFile("assets/input_box/box.png", renderer, inputBoxTexture, "trivia");
   if (!inputBoxTexture) {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Error loading input box texture");
   } else {
@@ -100,7 +105,7 @@ LevelTrivia::LevelTrivia(SDL_Renderer *renderer) : Level(renderer) {
   }
   
   // Initialize timer
-  questionStartTime = SDL_GetTicks();
+  enterPhase(SHOWING_QUESTION, timeLimit);
   
   SDL_Log("Trivia level loaded successfully");
   SOUND_MANAGER.playMusic("amicitia");
@@ -108,11 +113,11 @@ LevelTrivia::LevelTrivia(SDL_Renderer *renderer) : Level(renderer) {
 
 LevelTrivia::~LevelTrivia() {
   // Clean up textures
-  for (auto texture : questionBackgrounds) {
-    if (texture) SDL_DestroyTexture(texture);
+  for (TextureId texture : questionBackgrounds) {
+    TEXTURE_REGISTRY.release(texture);
   }
   
-  if (inputBoxTexture) SDL_DestroyTexture(inputBoxTexture);
+  if (inputBoxTexture) TEXTURE_REGISTRY.destroy(inputBoxTexture);
   
   // Clean up font
   if (gameFont) TTF_CloseFont(gameFont);
@@ -120,8 +125,13 @@ LevelTrivia::~LevelTrivia() {
 
 void LevelTrivia::render(SDL_Renderer *renderer) {
   // Render current question background instead of calling Level::render()
+  SDL_Texture* background = nullptr;
   if (currentQuestion < totalQuestions && questionOrder[currentQuestion] < questionBackgrounds.size()) {
-    SDL_RenderCopy(renderer, questionBackgrounds[questionOrder[currentQuestion]], NULL, NULL);
+    // Reloads the image if it was evicted
+    background = TEXTURE_REGISTRY.get(questionBackgrounds[questionOrder[currentQuestion]]);
+  }
+  if (background) {
+    SDL_RenderCopy(renderer, background, NULL, NULL);
   } else {
     // Fallback to black background if texture not available
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
@@ -139,31 +149,42 @@ void LevelTrivia::render(SDL_Renderer *renderer) {
 }
 
 void LevelTrivia::update() {
-  uint32_t currentTime = SDL_GetTicks();
+  // There is no world to step, only the phase timer to tick
+  advanceTimers();
+}
 
-  // Check if time limit is reached
-  if (currentPhase == SHOWING_QUESTION && 
-      currentTime - questionStartTime > timeLimit) {
-    // Time's up for this question - move to game over
-    currentPhase = GAME_OVER;
-    questionStartTime = currentTime;
-  }
-  
-  // Handle phase transitions
-  if (currentPhase == GAME_OVER && currentTime - questionStartTime > 2000) {
-    // Reset to first question after showing game over for 2 seconds
-    currentQuestion = 0;
-    playerInput = "";
-    currentPhase = SHOWING_QUESTION;
-    
-    // Shuffle questions for a different order
-    shuffleQuestions();
-    
-    questionStartTime = currentTime;
-  } else if (currentPhase == GAME_WIN && currentTime - questionStartTime > 2000) {
-    // Advance to next level after showing win for 2 seconds
-    GameState::setCurrentLevel(GameState::current_level + 1);
-    GameState::isLoading = true;
+void LevelTrivia::enterPhase(GamePhase phase, Uint32 durationMs) {
+  timers.cancel(phaseTimer);
+  currentPhase = phase;
+  phaseTimer = timers.schedule(TimerWheel::msToTicks(durationMs), [this]() {
+    phaseTimer = TIMER_NONE;
+    onPhaseTimeout();
+  });
+}
+
+void LevelTrivia::onPhaseTimeout() {
+  switch (currentPhase) {
+    case SHOWING_QUESTION:
+      // Time's up for this question - move to game over
+      enterPhase(GAME_OVER, 2000);
+      break;
+
+    case GAME_OVER:
+      // Reset to first question after showing game over for 2 seconds
+      currentQuestion = 0;
+      playerInput = "";
+
+      // Shuffle questions for a different order
+      shuffleQuestions();
+
+      enterPhase(SHOWING_QUESTION, timeLimit);
+      break;
+
+    case GAME_WIN:
+      // Advance to next level after showing win for 2 seconds
+      GameState::setCurrentLevel(GameState::current_level + 1);
+      GameState::isLoading = true;
+      break;
   }
 }
 
@@ -193,22 +214,15 @@ void LevelTrivia::renderQuestionInfo(SDL_Renderer *renderer) {
   SDL_Color textColor = {255, 255, 255, 255};
   
   // Render question number
-  std::string questionText = "Question: " + std::to_string(currentQuestion + 1) + 
-                             " / " + std::to_string(totalQuestions);
-  
-  SDL_Surface* textSurface = TTF_RenderText_Solid(gameFont, questionText.c_str(), textColor);
-  if (textSurface) {
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-    if (textTexture) {
-      SDL_Rect textRect = {(W_WIDTH - textSurface->w) / 2, 30, textSurface->w, textSurface->h};
-      SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-      SDL_DestroyTexture(textTexture);
-    }
-    SDL_FreeSurface(textSurface);
+  char questionText[32];
+  snprintf(questionText, sizeof(questionText), "Question: %d / %d", currentQuestion + 1, totalQuestions);
+  
+  if (questionLabel.set(renderer, gameFont, questionText, textColor)) {
+    questionLabel.render(renderer, (W_WIDTH - questionLabel.getWidth()) / 2, 30);
   }
   
   // Render phase text
-  std::string phaseText;
+  const char *phaseText = "";
   switch (currentPhase) {
     case SHOWING_QUESTION:
       phaseText = "Enter your answer";
@@ -221,27 +235,19 @@ void LevelTrivia::renderQuestionInfo(SDL_Renderer *renderer) {
       break;
   }
   
-  textSurface = TTF_RenderText_Solid(gameFont, phaseText.c_str(), textColor);
-  if (textSurface) {
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-    if (textTexture) {
-      SDL_Rect textRect = {(W_WIDTH - textSurface->w) / 2, 70, textSurface->w, textSurface->h};
-      SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-      SDL_DestroyTexture(textTexture);
-    }
-    SDL_FreeSurface(textSurface);
+  if (phaseLabel.set(renderer, gameFont, phaseText, textColor)) {
+    phaseLabel.render(renderer, (W_WIDTH - phaseLabel.getWidth()) / 2, 70);
   }
 }
 
 void LevelTrivia::renderTimer(SDL_Renderer *renderer) {
   if (!gameFont) return;
   
-  uint32_t currentTime = SDL_GetTicks();
   int timeRemaining = 0;
   
   // Calculate time remaining
   if (currentPhase == SHOWING_QUESTION) {
-    timeRemaining = (timeLimit - (currentTime - questionStartTime)) / 1000 + 1;
+    timeRemaining = (int)TimerWheel::ticksToSeconds(timers.getRemaining(phaseTimer)) + 1;
   } else {
     return; // Don't show timer for other phases
   }
@@ -250,19 +256,13 @@ void LevelTrivia::renderTimer(SDL_Renderer *renderer) {
   if (timeRemaining < 0) timeRemaining = 0;
   
   // Create timer text
-  std::string timerText = "Time: " + std::to_string(timeRemaining);
+  char timerText[32];
+  snprintf(timerText, sizeof(timerText), "Time: %d", timeRemaining);
   SDL_Color textColor = {255, 255, 0, 255}; // Yellow for timer
   
   // Render timer text
-  SDL_Surface* textSurface = TTF_RenderText_Solid(gameFont, timerText.c_str(), textColor);
-  if (textSurface) {
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-    if (textTexture) {
-      SDL_Rect textRect = {(W_WIDTH - textSurface->w) / 2, 110, textSurface->w, textSurface->h};
-      SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-      SDL_DestroyTexture(textTexture);
-    }
-    SDL_FreeSurface(textSurface);
+  if (timerLabel.set(renderer, gameFont, timerText, textColor)) {
+    timerLabel.render(renderer, (W_WIDTH - timerLabel.getWidth()) / 2, 110);
   }
 }
 
@@ -277,20 +277,10 @@ void LevelTrivia::renderInputBox(SDL_Renderer *renderer) {
   
   SDL_Color textColor = {255, 255, 255, 255}; // White text for input
   
-  SDL_Surface* textSurface = TTF_RenderText_Solid(gameFont, playerInput.c_str(), textColor);
-  if (textSurface) {
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-    if (textTexture) {
-      SDL_Rect textRect = {
-        inputBoxRect.x + (inputBoxRect.w - textSurface->w) / 2,
-        inputBoxRect.y + (inputBoxRect.h - textSurface->h) / 2,
-        textSurface->w,
-        textSurface->h
-      };
-      SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-      SDL_DestroyTexture(textTexture);
-    }
-    SDL_FreeSurface(textSurface);
+  if (inputLabel.set(renderer, gameFont, playerInput.c_str(), textColor)) {
+    inputLabel.render(renderer,
+                      inputBoxRect.x + (inputBoxRect.w - inputLabel.getWidth()) / 2,
+                      inputBoxRect.y + (inputBoxRect.h - inputLabel.getHeight()) / 2);
   }
 }
 
@@ -300,10 +290,10 @@ void LevelTrivia::nextQuestion() {
   
   if (currentQuestion >= totalQuestions) {
     // All questions answered correctly
-    currentPhase = GAME_WIN;
+    enterPhase(GAME_WIN, 2000);
   } else {
     // Reset timer for next question
-    questionStartTime = SDL_GetTicks();
+    enterPhase(SHOWING_QUESTION, timeLimit);
   }
 }
 
@@ -314,8 +304,7 @@ void LevelTrivia::checkAnswer() {
       nextQuestion();
     } else {
       // Wrong answer
-      currentPhase = GAME_OVER;
-      questionStartTime = SDL_GetTicks();
+      enterPhase(GAME_OVER, 2000);
     }
   }
 }
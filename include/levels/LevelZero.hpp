@@ -3,82 +3,12 @@
 #include "Level.hpp"
 #include "theora/theoraplay.h"
 #include "soundmanager.hpp"
+#include "introvideo.hpp"
 
+// Streaming textures the decoder writes frames into directly. One is on
+// screen, the others are locked and queued with theoraplay.
+#define VIDEO_TARGET_TEXTURES 3
 
-// Audio queue structure for handling audio packets
-typedef struct AudioQueue {
-  const THEORAPLAY_AudioPacket *audio;
-  int offset;
-  struct AudioQueue *next;
-} AudioQueue;
-
-// Global audio queue variables
-static volatile AudioQueue *audio_queue = NULL;
-static volatile AudioQueue *audio_queue_tail = NULL;
-
-// Audio callback function for SDL
-static void SDLCALL audio_callback(void *userdata, Uint8 *stream, int len) {
-  Sint16 *dst = (Sint16 *)stream;
-
-  while (audio_queue && (len > 0)) {
-    volatile AudioQueue *item = audio_queue;
-    AudioQueue *next = item->next;
-    const int channels = item->audio->channels;
-
-    const float *src = item->audio->samples + (item->offset * channels);
-    int cpy = (item->audio->frames - item->offset) * channels;
-    int i;
-
-    if (cpy > (len / sizeof(Sint16)))
-      cpy = len / sizeof(Sint16);
-
-    for (i = 0; i < cpy; i++) {
-      const float val = *(src++);
-      if (val < -1.0f)
-        *(dst++) = -32768;
-      else if (val > 1.0f)
-        *(dst++) = 32767;
-      else
-        *(dst++) = (Sint16)(val * 32767.0f);
-    }
-
-    item->offset += (cpy / channels);
-    len -= cpy * sizeof(Sint16);
-
-    if (item->offset >= item->audio->frames) {
-      THEORAPLAY_freeAudio(item->audio);
-      SDL_free((void *)item);
-      audio_queue = next;
-    }
-  }
-
-  if (!audio_queue)
-    audio_queue_tail = NULL;
-
-  if (len > 0)
-    memset(dst, '\0', len);
-}
-
-// Function to queue audio packets
-static void queue_audio(const THEORAPLAY_AudioPacket *audio) {
-  AudioQueue *item = (AudioQueue *)SDL_malloc(sizeof(AudioQueue));
-  if (!item) {
-    THEORAPLAY_freeAudio(audio);
-    return;
-  }
-
-  item->audio = audio;
-  item->offset = 0;
-  item->next = NULL;
-
-  SDL_LockAudio();
-  if (audio_queue_tail)
-    audio_queue_tail->next = item;
-  else
-    audio_queue = item;
-  audio_queue_tail = item;
-  SDL_UnlockAudio();
-}
 
 class LevelZero : public Level {
 public:
@@ -89,15 +19,25 @@ public:
   void handleEvents(SDL_Event *event, SDL_Renderer *renderer);
 
 private:
-  SDL_Texture *texture;
+  void pollFirstFrames();
+  void startPlayback();
+  void createTargets(SDL_Renderer *renderer, int w, int h);
+  void lockAndSubmitTarget(int index);
+  void releaseFrame(const THEORAPLAY_VideoFrame *frame);
+  void showFrame(const THEORAPLAY_VideoFrame *frame);
+
+  SDL_Texture *texture; // frames decoded before the targets existed
+  SDL_Texture *targets[VIDEO_TARGET_TEXTURES];
+  THEORAPLAY_VideoTarget lockedTargets[VIDEO_TARGET_TEXTURES];
+  SDL_Texture *shown;
   THEORAPLAY_Decoder *decoder;
   const THEORAPLAY_VideoFrame *video;
   const THEORAPLAY_AudioPacket *audio;
   Uint32 baseticks;
   Uint32 framems;
   bool isOver;
+  bool isStarted;
   bool audioInitialized;
-  SDL_AudioSpec spec;
 };
 
 void LevelZero::render(SDL_Renderer *renderer) {
@@ -111,6 +51,10 @@ void LevelZero::render(SDL_Renderer *renderer) {
     return;
   }
 
+  // Keep the screen black until the first frames are in
+  if (!isStarted)
+    return;
+
   Uint32 now = SDL_GetTicks() - baseticks;
 
   // Get video frames when it's time
@@ -123,7 +67,7 @@ void LevelZero::render(SDL_Renderer *renderer) {
     if (framems && ((now - video->playms) >= framems)) {
       const THEORAPLAY_VideoFrame *last = video;
       while ((video = THEORAPLAY_getVideo(decoder)) != NULL) {
-        THEORAPLAY_freeVideo(last);
+        releaseFrame(last);
         last = video;
         if ((now - video->playms) < framems)
           break;
@@ -134,41 +78,121 @@ void LevelZero::render(SDL_Renderer *renderer) {
     }
 
     if (video) {
-      // Create texture if needed
+      // Create the textures once we know the frame size
       if (!texture) {
-        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_IYUV,
-                                    SDL_TEXTUREACCESS_STREAMING, video->width,
-                                    video->height);
+        texture = TEXTURE_REGISTRY.create(renderer, SDL_PIXELFORMAT_IYUV,
+                                          SDL_TEXTUREACCESS_STREAMING,
+                                          video->width, video->height, "intro");
         if (!texture) {
           SDL_Log("Failed to create texture: %s", SDL_GetError());
           isOver = true;
           return;
         }
+        createTargets(renderer, video->width, video->height);
       }
 
-      // Update texture with video frame data
-      const int w = video->width;
-      const int h = video->height;
-      const Uint8 *y = (const Uint8 *)video->pixels;
-      const Uint8 *u = y + (w * h);
-      const Uint8 *v = u + ((w / 2) * (h / 2));
+      showFrame(video);
+      video = NULL;
+    }
+  }
 
-      SDL_UpdateYUVTexture(texture, NULL, y, w, u, w / 2, v, w / 2);
+  // Always render the last frame, even if we didn't update it this frame
+  if (shown) {
+    SDL_RenderCopy(renderer, shown, NULL, NULL);
+  }
+}
 
-      // Free the video frame and get ready for the next one
-      THEORAPLAY_freeVideo(video);
-      video = NULL;
+void LevelZero::createTargets(SDL_Renderer *renderer, int w, int h) {
+  for (int i = 0; i < VIDEO_TARGET_TEXTURES; i++) {
+    targets[i] = TEXTURE_REGISTRY.create(renderer, SDL_PIXELFORMAT_IYUV,
+                                         SDL_TEXTUREACCESS_STREAMING, w, h,
+                                         "intro");
+    if (!targets[i]) {
+      // Not fatal, frames keep coming through theoraplay's own buffers
+      SDL_Log("Failed to create video target texture: %s", SDL_GetError());
+      continue;
     }
+    lockAndSubmitTarget(i);
+  }
+}
+
+// Hands the texture's planes to the decoder, it stays locked until the frame
+// written into it is shown
+void LevelZero::lockAndSubmitTarget(int index) {
+  void *pixels;
+  int pitch;
+  int h;
+  if (SDL_QueryTexture(targets[index], NULL, NULL, NULL, &h) != 0 ||
+      SDL_LockTexture(targets[index], NULL, &pixels, &pitch) != 0) {
+    SDL_Log("Failed to lock video target texture: %s", SDL_GetError());
+    return;
   }
 
-  // Always render the texture if it exists, even if we didn't update it this
-  // frame
-  if (texture) {
-    SDL_RenderCopy(renderer, texture, NULL, NULL);
+  // IYUV planes are laid out back to back, chroma at half pitch and height
+  THEORAPLAY_VideoTarget &target = lockedTargets[index];
+  target.planes[0] = (unsigned char *)pixels;
+  target.planes[1] = target.planes[0] + (pitch * h);
+  target.planes[2] = target.planes[1] + (((pitch + 1) / 2) * ((h + 1) / 2));
+  target.pitches[0] = pitch;
+  target.pitches[1] = (pitch + 1) / 2;
+  target.pitches[2] = (pitch + 1) / 2;
+  target.userdata = (void *)(intptr_t)(index + 1); // 0 means "no target"
+
+  if (!THEORAPLAY_submitVideoTarget(decoder, &target)) {
+    SDL_UnlockTexture(targets[index]);
+  }
+}
+
+// Drops a frame without showing it, its target (still locked) goes straight
+// back to the decoder
+void LevelZero::releaseFrame(const THEORAPLAY_VideoFrame *frame) {
+  if (frame->target) {
+    const int index = (int)(intptr_t)frame->target - 1;
+    THEORAPLAY_submitVideoTarget(decoder, &lockedTargets[index]);
+  }
+  THEORAPLAY_freeVideo(frame);
+}
+
+void LevelZero::showFrame(const THEORAPLAY_VideoFrame *frame) {
+  SDL_Texture *next;
+
+  if (frame->target) {
+    // The decoder already wrote into the locked planes, unlocking uploads them
+    const int index = (int)(intptr_t)frame->target - 1;
+    SDL_UnlockTexture(targets[index]);
+    next = targets[index];
+  } else {
+    const int w = frame->width;
+    const int h = frame->height;
+    const Uint8 *y = (const Uint8 *)frame->pixels;
+    const Uint8 *u = y + (w * h);
+    const Uint8 *v = u + ((w / 2) * (h / 2));
+
+    SDL_UpdateYUVTexture(texture, NULL, y, w, u, w / 2, v, w / 2);
+    next = texture;
   }
+  THEORAPLAY_freeVideo(frame);
+
+  // The texture that was on screen can take another frame now
+  if (shown != next) {
+    for (int i = 0; i < VIDEO_TARGET_TEXTURES; i++) {
+      if (shown && shown == targets[i])
+        lockAndSubmitTarget(i);
+    }
+  }
+  shown = next;
 }
 
 void LevelZero::update() {
+  if (isOver)
+    return;
+
+  // Still waiting on the decoder thread, don't block the frame for it
+  if (!isStarted) {
+    pollFirstFrames();
+    return;
+  }
+
   // Check if decoder is still working
   if (!THEORAPLAY_isDecoding(decoder) && !video) {
     isOver = true;
@@ -179,8 +203,10 @@ void LevelZero::update() {
 
   // Process audio packets
   while ((audio = THEORAPLAY_getAudio(decoder)) != NULL) {
-    queue_audio(audio);
+    SOUND_MANAGER.queueStream(audio->samples, audio->frames);
+    THEORAPLAY_freeAudio(audio);
   }
+  audio = NULL;
 }
 
 void LevelZero::handleEvents(SDL_Event *event, SDL_Renderer *r) {
@@ -196,14 +222,19 @@ void LevelZero::handleEvents(SDL_Event *event, SDL_Renderer *r) {
 LevelZero::LevelZero(SDL_Renderer *renderer) : Level(renderer) {
   // Initialize variables
   texture = NULL;
+  shown = NULL;
+  for (int i = 0; i < VIDEO_TARGET_TEXTURES; i++)
+    targets[i] = NULL;
   video = NULL;
   audio = NULL;
+  framems = 0;
+  baseticks = 0;
   isOver = false;
+  isStarted = false;
   audioInitialized = false;
 
-  // Start decoding the video file
-  decoder = THEORAPLAY_startDecodeFile("assets/video/video.ogv", 30,
-                                       THEORAPLAY_VIDFMT_IYUV, NULL, 1);
+  // Pick up the decoder the menu has been warming up (or start one now)
+  decoder = INTRO_VIDEO.take();
   if (!decoder) {
     SDL_Log("Failed to start decoding video file");
     isOver = true;
@@ -213,43 +244,34 @@ LevelZero::LevelZero(SDL_Renderer *renderer) : Level(renderer) {
   // Stop playing music
   SOUND_MANAGER.stopMusic();
   SOUND_MANAGER.stopAllSoundEffects();
+}
 
-  // Wait for first video and audio frames
-  while (!video || !audio) {
-    THEORAPLAY_pumpDecode(decoder, 5);
-    if (!video)
-      video = THEORAPLAY_getVideo(decoder);
-    if (!audio)
-      audio = THEORAPLAY_getAudio(decoder);
+void LevelZero::pollFirstFrames() {
+  THEORAPLAY_pumpDecode(decoder, 5);
+  if (!video)
+    video = THEORAPLAY_getVideo(decoder);
+  if (!audio)
+    audio = THEORAPLAY_getAudio(decoder);
 
-    if (!THEORAPLAY_isDecoding(decoder) && (!video || !audio)) {
-      SDL_Log("Failed to decode video or audio frames");
-      isOver = true;
-      return;
-    }
-    SDL_Delay(10);
+  if (video && audio) {
+    startPlayback();
+  } else if (!THEORAPLAY_isDecoding(decoder)) {
+    SDL_Log("Failed to decode video or audio frames");
+    isOver = true;
   }
+}
 
-  // Set up audio
-  memset(&spec, '\0', sizeof(SDL_AudioSpec));
-  spec.freq = audio->freq;
-  spec.format = AUDIO_S16SYS;
-  spec.channels = audio->channels;
-  spec.samples = 2048;
-  spec.callback = audio_callback;
-
-  // Close any existing audio device
-  SDL_CloseAudio();
-
-  if (SDL_OpenAudio(&spec, NULL) != 0) {
-    SDL_Log("Failed to open audio: %s", SDL_GetError());
-  } else {
-    audioInitialized = true;
-    SDL_PauseAudio(0); // Start audio playback
+void LevelZero::startPlayback() {
+  PROFILE_ZONE("LevelZero::startPlayback");
+  // Feed the soundtrack through the mixer, the device stays as it is
+  audioInitialized = SOUND_MANAGER.startStream(audio->freq, audio->channels);
+  if (!audioInitialized) {
+    SDL_Log("Failed to start cutscene audio, playing without sound");
   }
 
   // Queue initial audio
-  queue_audio(audio);
+  SOUND_MANAGER.queueStream(audio->samples, audio->frames);
+  THEORAPLAY_freeAudio(audio);
   audio = NULL;
 
   // Calculate frame duration in milliseconds
@@ -257,6 +279,7 @@ LevelZero::LevelZero(SDL_Renderer *renderer) : Level(renderer) {
 
   // Set base time for playback
   baseticks = SDL_GetTicks();
+  isStarted = true;
 }
 
 LevelZero::~LevelZero() {
@@ -265,16 +288,26 @@ LevelZero::~LevelZero() {
     THEORAPLAY_freeVideo(video);
   }
 
-  if (texture) {
-    SDL_DestroyTexture(texture);
+  if (audio) {
+    THEORAPLAY_freeAudio(audio);
   }
 
+  // Stop the decoder first, it may still be writing into a locked target
   if (decoder) {
     THEORAPLAY_stopDecode(decoder);
   }
 
-  // Clean up audio
+  if (texture) {
+    TEXTURE_REGISTRY.destroy(texture);
+  }
+
+  for (int i = 0; i < VIDEO_TARGET_TEXTURES; i++) {
+    if (targets[i])
+      TEXTURE_REGISTRY.destroy(targets[i]);
+  }
+
+  // Give the music slot back to the mixer
   if (audioInitialized) {
-    SDL_CloseAudio();
+    SOUND_MANAGER.stopStream();
   }
 }
\ No newline at end of file
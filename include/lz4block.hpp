@@ -0,0 +1,170 @@
+#pragma once
+#include <SDL2/SDL_stdinc.h>
+#include <string.h>
+#include <vector>
+
+// Minimal codec for the LZ4 block format, used by the asset pack. Blocks are
+// interchangeable with liblz4's LZ4_compress_default/LZ4_decompress_safe.
+//
+// A block is a run of sequences: a token (literal count in the high nibble,
+// match length - 4 in the low one, 15 meaning more length bytes follow), the
+// literals, a 2-byte little endian match offset and the extra match length
+// bytes. The last sequence stops after its literals.
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_LAST_LITERALS 5 // The block always ends with this many literals
+#define LZ4_MATCH_LIMIT 12  // No match starts in the last 12 bytes
+#define LZ4_MAX_OFFSET 65535
+#define LZ4_HASH_BITS 16
+
+// Worst case size of a compressed block
+inline int lz4CompressBound(int size) { return size + size / 255 + 16; }
+
+inline Uint32 lz4Read32(const Uint8 *p) {
+  Uint32 value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+// Writes the extra length bytes for a nibble that overflowed to 15
+inline Uint8 *lz4WriteLength(Uint8 *out, int length) {
+  while (length >= 255) {
+    *out++ = 255;
+    length -= 255;
+  }
+  *out++ = (Uint8)length;
+  return out;
+}
+
+// Greedy single-probe compressor, fast enough for the offline packer.
+// Returns the compressed size, or 0 if dst is too small
+inline int lz4Compress(const Uint8 *src, int srcSize, Uint8 *dst,
+                       int dstCapacity) {
+  std::vector<int> table(1 << LZ4_HASH_BITS, -1);
+  Uint8 *out = dst;
+  Uint8 *outEnd = dst + dstCapacity;
+  int anchor = 0;
+  int pos = 0;
+
+  while (pos < srcSize - LZ4_MATCH_LIMIT) {
+    Uint32 sequence = lz4Read32(src + pos);
+    Uint32 hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+    int candidate = table[hash];
+    table[hash] = pos;
+    if (candidate < 0 || pos - candidate > LZ4_MAX_OFFSET ||
+        lz4Read32(src + candidate) != sequence) {
+      pos++;
+      continue;
+    }
+
+    int matchLength = LZ4_MIN_MATCH;
+    while (pos + matchLength < srcSize - LZ4_LAST_LITERALS &&
+           src[candidate + matchLength] == src[pos + matchLength]) {
+      matchLength++;
+    }
+
+    int literalLength = pos - anchor;
+    if (outEnd - out < 1 + literalLength / 255 + 1 + literalLength + 2 +
+                           matchLength / 255 + 1) {
+      return 0;
+    }
+
+    Uint8 *token = out++;
+    int literalNibble = SDL_min(literalLength, 15);
+    int matchNibble = SDL_min(matchLength - LZ4_MIN_MATCH, 15);
+    *token = (Uint8)(literalNibble << 4 | matchNibble);
+    if (literalNibble == 15)
+      out = lz4WriteLength(out, literalLength - 15);
+    memcpy(out, src + anchor, literalLength);
+    out += literalLength;
+
+    int offset = pos - candidate;
+    *out++ = (Uint8)(offset & 0xff);
+    *out++ = (Uint8)(offset >> 8);
+    if (matchNibble == 15)
+      out = lz4WriteLength(out, matchLength - LZ4_MIN_MATCH - 15);
+
+    pos += matchLength;
+    anchor = pos;
+  }
+
+  int literalLength = srcSize - anchor;
+  if (outEnd - out < 1 + literalLength / 255 + 1 + literalLength)
+    return 0;
+  int literalNibble = SDL_min(literalLength, 15);
+  *out++ = (Uint8)(literalNibble << 4);
+  if (literalNibble == 15)
+    out = lz4WriteLength(out, literalLength - 15);
+  memcpy(out, src + anchor, literalLength);
+  out += literalLength;
+  return (int)(out - dst);
+}
+
+// Bounds-checked decompressor. Returns the decompressed size, or -1 on a
+// malformed block or one that would not fit in dstSize
+inline int lz4Decompress(const Uint8 *src, int srcSize, Uint8 *dst,
+                         int dstSize) {
+  const Uint8 *in = src;
+  const Uint8 *inEnd = src + srcSize;
+  Uint8 *out = dst;
+  Uint8 *outEnd = dst + dstSize;
+
+  while (in < inEnd) {
+    Uint8 token = *in++;
+
+    size_t literalLength = token >> 4;
+    if (literalLength == 15) {
+      Uint8 extra;
+      do {
+        if (in >= inEnd)
+          return -1;
+        extra = *in++;
+        literalLength += extra;
+      } while (extra == 255);
+    }
+    if (literalLength > (size_t)(inEnd - in) ||
+        literalLength > (size_t)(outEnd - out))
+      return -1;
+    memcpy(out, in, literalLength);
+    in += literalLength;
+    out += literalLength;
+
+    // The last sequence has no match
+    if (in == inEnd)
+      break;
+
+    if (inEnd - in < 2)
+      return -1;
+    size_t offset = in[0] | (in[1] << 8);
+    in += 2;
+    if (offset == 0 || offset > (size_t)(out - dst))
+      return -1;
+
+    size_t matchLength = token & 15;
+    if (matchLength == 15) {
+      Uint8 extra;
+      do {
+        if (in >= inEnd)
+          return -1;
+        extra = *in++;
+        matchLength += extra;
+      } while (extra == 255);
+    }
+    matchLength += LZ4_MIN_MATCH;
+    if (matchLength > (size_t)(outEnd - out))
+      return -1;
+
+    // Overlapping matches repeat the last offset bytes, copy them in order
+    const Uint8 *match = out - offset;
+    if (offset >= matchLength) {
+      memcpy(out, match, matchLength);
+      out += matchLength;
+    } else {
+      for (size_t i = 0; i < matchLength; i++) {
+        *out++ = *match++;
+      }
+    }
+  }
+  return (int)(out - dst);
+}
+// Code created by Mouttaki Omar(王明清)
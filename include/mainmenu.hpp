@@ -6,6 +6,7 @@
 #include <SDL2/SDL_ttf.h>
 #include <functional>
 #include "soundmanager.hpp"
+#include "introvideo.hpp"
 class mainmenu {
 private:
   Button buttons[3];
@@ -28,7 +29,7 @@ mainmenu::mainmenu(SDL_Renderer *renderer, std::function<void()> start_callback,
                    std::function<void()> exit_callback) {
   // menu's background
   SDL_Surface *a = Texture::loadFromFile("assets/backgrounds/menu.png",
-                                         renderer, background_tex);
+                                         renderer, background_tex, "menu");
   if (a == nullptr) {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
                  "Unable to load image %s! SDL_image Error: %s\n",
@@ -43,7 +44,8 @@ mainmenu::mainmenu(SDL_Renderer *renderer, std::function<void()> start_callback,
   this->font = TTF_OpenFont("assets/fonts/ARCADECLASSIC.TTF", 60);
   SDL_Color color = {255, 255, 255};
   SDL_Surface *text_surface = TTF_RenderText_Solid(font, W_NAME, color);
-  text_texture = SDL_CreateTextureFromSurface(renderer, text_surface);
+  text_texture =
+      TEXTURE_REGISTRY.createFromSurface(renderer, text_surface, "menu");
   // centering the text
   text_rect.x = W_WIDTH / 2 - text_surface->w / 2;
   text_rect.y = W_HEIGHT / 4 - text_surface->h / 2;
@@ -58,6 +60,9 @@ mainmenu::mainmenu(SDL_Renderer *renderer, std::function<void()> start_callback,
                          W_HEIGHT / 2 - buttons[1].getRect().h / 2);
   // setting the buttons callback
   buttons[0].setCallback(start_callback);
+  // the intro cutscene is the first thing Play shows, start buffering it as
+  // soon as the player shows interest (covers coming back from the credits)
+  buttons[0].setHoverCallback([] { INTRO_VIDEO.prewarm(); });
 
   buttons[1].loadFromFile("assets/buttons/settings.png", renderer);
   buttons[1].setSize(200, 100);
@@ -72,6 +77,8 @@ mainmenu::mainmenu(SDL_Renderer *renderer, std::function<void()> start_callback,
   buttons[2].setCallback(exit_callback);
   SOUND_MANAGER.playMusic("menu");
   SOUND_MANAGER.setMusicVolume(10);
+  // decode the intro in the background while the menu is up
+  INTRO_VIDEO.prewarm();
 }
 
 mainmenu::~mainmenu() {
@@ -79,8 +86,8 @@ mainmenu::~mainmenu() {
     TTF_CloseFont(font);
     font = nullptr;
   }
-  SDL_DestroyTexture(background_tex);
-  SDL_DestroyTexture(text_texture);
+  TEXTURE_REGISTRY.destroy(background_tex);
+  TEXTURE_REGISTRY.destroy(text_texture);
 }
 
 void mainmenu::render(SDL_Renderer *renderer) {
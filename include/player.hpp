@@ -1,6 +1,7 @@
 #pragma once
 #include "CONSTANTS.hpp"
 #include "bullet.hpp"
+#include "collisionevents.hpp"
 #include "sprite.hpp"
 #include <SDL2/SDL.h>
 #include <box2d/box2d.h>
@@ -21,6 +22,36 @@ enum PlayerState
   DASHING
 };
 
+// Gameplay state of the player rewound by a level restart. The body itself
+// is restored by the level's b2WorldSnapshot
+struct PlayerSnapshot
+{
+  PlayerState state = IDLE;
+  PlayerState previousState = IDLE;
+  int currentSpeed = 0;
+  bool isJumping = false;
+  bool isWalking = false;
+  bool isRunning = true;
+  bool isDashing = false;
+  bool shouldJump = false;
+  bool spacePressed = false;
+  int walkingDirection = 0;
+  bool groundProbeHit = false;
+  int groundForgivenessTimer = 0;
+  int dashTimer = 0;
+  int dashCooldownTimer = 0;
+  bool isFirstDash = true;
+  int currentFrame = 0;
+  int frameTimer = 0;
+  bool facingRight = true;
+  int health = 0;
+  int bulletsCount = 0;
+  int fireTimer = 0;
+  bool canShot = false;
+  bool isReloading = false;
+  int reloadTimer = 0;
+};
+
 class Player : public Sprite
 {
 public:
@@ -28,14 +59,18 @@ public:
   ~Player();
   void render(SDL_Renderer *renderer);
   void update();
-  void handleEvents(SDL_Event *event, SDL_Renderer *renderer);
+  void handleEvents(SDL_Event *event);
   void handleMouseMotion(int x, int y);
-  void fireBullet(SDL_Renderer *renderer);
+  void fireBullet();
   void updateBullets();
   void renderBullets(SDL_Renderer *renderer);
   void updatePhysics();
   bool isOnGround() const;
 
+  // Level restarts, see Level::restoreLoadedState
+  PlayerSnapshot captureState() const;
+  void restoreState(const PlayerSnapshot &snapshot);
+
   // Debug rendering method
   void renderDebugSpriteBounds(SDL_Renderer *renderer);
 
@@ -55,18 +90,22 @@ public:
     if (health < 0)
       health = 0;
   }
-  const std::list<std::unique_ptr<Bullet>> &getBulletsObj() const
+  const std::vector<Bullet> &getBulletsObj() const
   {
     return bullets;
   }
-  void removeBullet(Bullet *bullet)
+  // Swaps the last bullet into index, so walk backwards while removing
+  void removeBullet(size_t index)
   {
-    bullets.remove_if([bullet](const std::unique_ptr<Bullet> &b)
-                      { return b.get() == bullet; });
+    bullets[index] = bullets.back();
+    bullets.pop_back();
   }
 
 
 private:
+  // Casts the ground rays below the hitbox, only the center one if asked
+  bool probeGround(bool centerOnly) const;
+
   PlayerState state;
   PlayerState previousState;
   b2Body *body;
@@ -84,6 +123,7 @@ private:
   bool shouldJump = false;
   bool spacePressed = false; // Track if space key is currently pressed
   int walkingDirection = 0;
+  bool groundProbeHit = false; // Last center ground probe, reused while the body sleeps
   float groundCheckDistance = 1.5f; // Increased from 1.1f for more reliable ground detection
 
   // Ground forgiveness timer allows jumping shortly after leaving the ground
@@ -116,7 +156,12 @@ private:
   int bulletSpeed = 1;
   int fireRate = 10; // Frames between shots
   int fireTimer = 0; //
-  std::list<std::unique_ptr<Bullet>> bullets;
+  // Reserved in the constructor, a steady stream of shots reuses it
+  std::vector<Bullet> bullets;
+  std::vector<b2AABB> bulletBoxes; // Scratch for updateBullets
+  SDL_Texture *bulletTexture = nullptr;
+  int bulletWidth = 8;
+  int bulletHeight = 4;
 
   bool canShot = false;
 
@@ -139,7 +184,7 @@ private:
 };
 
 const float PPM = 32.0f; // Match the PPM value used elsewhere
-void Player::fireBullet(SDL_Renderer *renderer)
+void Player::fireBullet()
 {
   if (fireTimer <= 0 && bulletsCount > 0)
   {
@@ -158,8 +203,8 @@ void Player::fireBullet(SDL_Renderer *renderer)
     float gunPosY = playerCenterY + sin(angle * M_PI / 180) * gunDistance;
 
     // Create bullet at gun position
-    bullets.push_back(std::make_unique<Bullet>(renderer, gunPosX, gunPosY,
-                                               angle, bulletSpeed));
+    bullets.push_back(Bullet(bulletTexture, bulletWidth, bulletHeight,
+                             gunPosX, gunPosY, angle, bulletSpeed));
 
     // Reset fire timer
     fireTimer = fireRate;
@@ -177,24 +222,48 @@ void Player::updateBullets()
     fireTimer--;
   }
 
-  // Get screen dimensions
-  int screenWidth, screenHeight;
-  SDL_GetRendererOutputSize(SDL_GetRenderer(SDL_GetWindowFromID(1)),
-                            &screenWidth, &screenHeight);
+  // Levels play in the logical space, whatever the window or render scale
+  int screenWidth = W_WIDTH, screenHeight = W_HEIGHT;
 
   // Update bullets and remove those that are out of bounds
-  auto it = bullets.begin();
-  while (it != bullets.end())
+  for (size_t i = bullets.size(); i-- > 0;)
   {
-    (*it)->update();
+    bullets[i].update();
 
-    if ((*it)->isOutOfBounds(screenWidth, screenHeight))
+    if (bullets[i].isOutOfBounds(screenWidth, screenHeight))
     {
-      it = bullets.erase(it);
+      removeBullet(i);
     }
-    else
+  }
+
+  // Bullets aren't bodies, but they still wake the sleeping bodies they fly through
+  if (bullets.empty())
+  {
+    return;
+  }
+
+  bulletBoxes.clear();
+  for (auto &bullet : bullets)
+  {
+    b2AABB box;
+    box.lowerBound.Set(bullet.getX() / PPM, bullet.getY() / PPM);
+    box.upperBound = box.lowerBound;
+    bulletBoxes.push_back(box);
+  }
+
+  // Skip player's own fixture
+  b2QueryFilter filter;
+  filter.ignoreBody = body;
+
+  b2AABBOverlap overlaps[16];
+  int overlapCount = body->GetWorld()->QueryAABBBatch(bulletBoxes.data(), (int)bulletBoxes.size(),
+                                                      overlaps, 16, filter);
+  for (int i = 0; i < overlapCount && i < 16; i++)
+  {
+    b2Body *touched = overlaps[i].fixture->GetBody();
+    if (touched->GetType() != b2_staticBody)
     {
-      ++it;
+      touched->SetAwake(true);
     }
   }
 }
@@ -203,7 +272,7 @@ void Player::renderBullets(SDL_Renderer *renderer)
 {
   for (auto &bullet : bullets)
   {
-    bullet->render(renderer);
+    bullet.render(renderer);
   }
 }
 
@@ -244,8 +313,8 @@ Player::Player(SDL_Renderer *renderer, b2World *world, int x, int y)
   // Add higher wall friction to prevent climbing
   fixtureDef.restitution = 0.05f; // Small bounce to match blocks
 
-  // Add user data to identify player fixture
-  fixtureDef.userData.pointer = reinterpret_cast<uintptr_t>(this);
+  // Tag the fixture so collision events can tell the player apart
+  fixtureDef.userData.pointer = makeFixtureTag(FIXTURE_PLAYER, 0);
 
   body->CreateFixture(&fixtureDef);
 
@@ -256,7 +325,8 @@ Player::Player(SDL_Renderer *renderer, b2World *world, int x, int y)
 
   // Load gun texture
   SDL_Surface *gunSurface =
-      Texture::loadFromFile("assets/gun/player.png", renderer, gunTexture);
+      Texture::loadFromFile("assets/gun/player.png", renderer, gunTexture,
+                            "player");
   if (gunSurface)
   {
     gunWidth = W_SPRITESIZE / 10;
@@ -264,6 +334,18 @@ Player::Player(SDL_Renderer *renderer, b2World *world, int x, int y)
     SDL_FreeSurface(gunSurface);
   }
 
+  // Every bullet draws this one texture, loading it per shot hit the disk
+  SDL_Surface *bulletSurface =
+      Texture::loadFromFile("assets/gun/laser_bullet.png", renderer,
+                            bulletTexture, "bullet");
+  if (bulletSurface)
+  {
+    bulletWidth = bulletSurface->w;
+    bulletHeight = bulletSurface->h;
+    SDL_FreeSurface(bulletSurface);
+  }
+  bullets.reserve(64);
+
   // Load animations
   loadAnimations(renderer);
 }
@@ -277,7 +359,7 @@ Player::~Player()
     {
       if (texture)
       {
-        SDL_DestroyTexture(texture);
+        TEXTURE_REGISTRY.destroy(texture);
       }
     }
   }
@@ -285,7 +367,12 @@ Player::~Player()
   // Clean up gun texture
   if (gunTexture)
   {
-    SDL_DestroyTexture(gunTexture);
+    TEXTURE_REGISTRY.destroy(gunTexture);
+  }
+
+  if (bulletTexture)
+  {
+    TEXTURE_REGISTRY.destroy(bulletTexture);
   }
 }
 
@@ -300,7 +387,7 @@ void Player::loadAnimations(SDL_Renderer *renderer)
     char path[100];
     sprintf(path, "assets/player/idle/idle_%d.png", i);
     SDL_Texture *texture = nullptr;
-    SDL_Surface *surface = Texture::loadFromFile(path, renderer, texture);
+    SDL_Surface *surface = Texture::loadFromFile(path, renderer, texture, "player");
     if (surface)
     {
       idleAnim.frames.push_back(texture);
@@ -318,7 +405,7 @@ void Player::loadAnimations(SDL_Renderer *renderer)
     char path[100];
     sprintf(path, "assets/player/walk/walk_%d.png", i);
     SDL_Texture *texture = nullptr;
-    SDL_Surface *surface = Texture::loadFromFile(path, renderer, texture);
+    SDL_Surface *surface = Texture::loadFromFile(path, renderer, texture, "player");
     if (surface)
     {
       walkAnim.frames.push_back(texture);
@@ -336,7 +423,7 @@ void Player::loadAnimations(SDL_Renderer *renderer)
     char path[100];
     sprintf(path, "assets/player/sprint/sprint_%d.png", i);
     SDL_Texture *texture = nullptr;
-    SDL_Surface *surface = Texture::loadFromFile(path, renderer, texture);
+    SDL_Surface *surface = Texture::loadFromFile(path, renderer, texture, "player");
     if (surface)
     {
       sprintAnim.frames.push_back(texture);
@@ -354,7 +441,7 @@ void Player::loadAnimations(SDL_Renderer *renderer)
     char path[100];
     sprintf(path, "assets/player/jump/jump_%d.png", i);
     SDL_Texture *texture = nullptr;
-    SDL_Surface *surface = Texture::loadFromFile(path, renderer, texture);
+    SDL_Surface *surface = Texture::loadFromFile(path, renderer, texture, "player");
     if (surface)
     {
       jumpAnim.frames.push_back(texture);
@@ -372,7 +459,7 @@ void Player::loadAnimations(SDL_Renderer *renderer)
     char path[100];
     sprintf(path, "assets/player/land/land_%d.png", i);
     SDL_Texture *texture = nullptr;
-    SDL_Surface *surface = Texture::loadFromFile(path, renderer, texture);
+    SDL_Surface *surface = Texture::loadFromFile(path, renderer, texture, "player");
     if (surface)
     {
       fallAnim.frames.push_back(texture);
@@ -419,6 +506,67 @@ void Player::updateAnimation()
   }
 }
 
+PlayerSnapshot Player::captureState() const
+{
+  PlayerSnapshot snapshot;
+  snapshot.state = state;
+  snapshot.previousState = previousState;
+  snapshot.currentSpeed = currentSpeed;
+  snapshot.isJumping = isJumping;
+  snapshot.isWalking = isWalking;
+  snapshot.isRunning = isRunning;
+  snapshot.isDashing = isDashing;
+  snapshot.shouldJump = shouldJump;
+  snapshot.spacePressed = spacePressed;
+  snapshot.walkingDirection = walkingDirection;
+  snapshot.groundProbeHit = groundProbeHit;
+  snapshot.groundForgivenessTimer = groundForgivenessTimer;
+  snapshot.dashTimer = dashTimer;
+  snapshot.dashCooldownTimer = dashCooldownTimer;
+  snapshot.isFirstDash = isFirstDash;
+  snapshot.currentFrame = currentFrame;
+  snapshot.frameTimer = frameTimer;
+  snapshot.facingRight = facingRight;
+  snapshot.health = health;
+  snapshot.bulletsCount = bulletsCount;
+  snapshot.fireTimer = fireTimer;
+  snapshot.canShot = canShot;
+  snapshot.isReloading = isReloading;
+  snapshot.reloadTimer = reloadTimer;
+  return snapshot;
+}
+
+void Player::restoreState(const PlayerSnapshot &snapshot)
+{
+  state = snapshot.state;
+  previousState = snapshot.previousState;
+  currentSpeed = snapshot.currentSpeed;
+  isJumping = snapshot.isJumping;
+  isWalking = snapshot.isWalking;
+  isRunning = snapshot.isRunning;
+  isDashing = snapshot.isDashing;
+  shouldJump = snapshot.shouldJump;
+  spacePressed = snapshot.spacePressed;
+  walkingDirection = snapshot.walkingDirection;
+  groundProbeHit = snapshot.groundProbeHit;
+  groundForgivenessTimer = snapshot.groundForgivenessTimer;
+  dashTimer = snapshot.dashTimer;
+  dashCooldownTimer = snapshot.dashCooldownTimer;
+  isFirstDash = snapshot.isFirstDash;
+  currentFrame = snapshot.currentFrame;
+  frameTimer = snapshot.frameTimer;
+  facingRight = snapshot.facingRight;
+  health = snapshot.health;
+  bulletsCount = snapshot.bulletsCount;
+  fireTimer = snapshot.fireTimer;
+  canShot = snapshot.canShot;
+  isReloading = snapshot.isReloading;
+  reloadTimer = snapshot.reloadTimer;
+
+  // Bullets in flight belong to the run that ended
+  bullets.clear();
+}
+
 bool Player::isOnGround() const
 {
   // If we're within the forgiveness time, consider the player on ground
@@ -427,110 +575,56 @@ bool Player::isOnGround() const
     return true;
   }
 
-  const float PPM = 32.0f;        // Match the PPM value used elsewhere
+  return probeGround(false);
+}
+
+bool Player::probeGround(bool centerOnly) const
+{
   const float hitboxScale = 0.7f; // Match the scale used in constructor
 
-  // Create a small ray cast downward from player's position
+  // Cast from the bottom of the player's collision box
   b2Vec2 start = body->GetPosition();
-
-  // Calculate the bottom of the player's collision box
   float playerHeight = getHeight() * hitboxScale;
   float playerWidth = getWidth() * hitboxScale;
-
-  // Cast from the bottom of the player's collision box
   start.y += (playerHeight / 2) / PPM;
 
   // Increase ray length for more reliable ground detection
   float rayLength = 0.5f; // Increased from 0.25f to 0.5f for better detection
-  b2Vec2 end = start + b2Vec2(0, rayLength);
 
   // Calculate width for side checks - use wider spacing for gaps
   float sideOffset1 = (playerWidth / 2) / PPM * 0.7f; // Reduce side check width to prevent wall climbing
   float sideOffset2 = (playerWidth / 4) / PPM * 0.7f; // Reduce side check width
 
-  // Add more ray casts to cover more ground points
-  b2Vec2 startLeft1 = start - b2Vec2(sideOffset1, 0);
-  b2Vec2 endLeft1 = startLeft1 + b2Vec2(0, rayLength);
-
-  b2Vec2 startLeft2 = start - b2Vec2(sideOffset2, 0);
-  b2Vec2 endLeft2 = startLeft2 + b2Vec2(0, rayLength);
-
-  b2Vec2 startRight1 = start + b2Vec2(sideOffset1, 0);
-  b2Vec2 endRight1 = startRight1 + b2Vec2(0, rayLength);
-
-  b2Vec2 startRight2 = start + b2Vec2(sideOffset2, 0);
-  b2Vec2 endRight2 = startRight2 + b2Vec2(0, rayLength);
-
-  // Use Box2D's ray cast to check for ground
-  class GroundRayCastCallback : public b2RayCastCallback
-  {
-  public:
-    bool hit = false;
-    b2Body *playerBody;
-
-    float ReportFixture(b2Fixture *fixture, const b2Vec2 &point,
-                        const b2Vec2 &normal, float fraction) override
-    {
-      // Skip player's own fixture
-      if (fixture->GetBody() == playerBody)
-      {
-        return -1; // Continue checking
-      }
-
-      // Strict check: Only count hits from directly below (normal pointing up)
-      // This prevents detecting walls as ground
-      if (normal.y < -0.85f)
-      { // Almost vertical normal (was -0.5f)
-        hit = true;
-        return 0; // Stop checking
-      }
-      return -1; // Continue checking
-    }
-  };
-
-  // Check center ray first
-  GroundRayCastCallback callback;
-  callback.playerBody = body;
-  body->GetWorld()->RayCast(&callback, start, end);
+  // Center ray first, then the side rays, all traced in one batch
+  const float offsets[] = {0.0f, -sideOffset1, -sideOffset2, sideOffset1, sideOffset2};
+  const int rayCount = centerOnly ? 1 : 5;
 
-  if (callback.hit)
+  b2RayCastInput rays[5];
+  for (int i = 0; i < rayCount; i++)
   {
-    return true;
+    rays[i].p1 = start + b2Vec2(offsets[i], 0);
+    rays[i].p2 = rays[i].p1 + b2Vec2(0, rayLength);
+    rays[i].maxFraction = 1.0f;
   }
 
-  // If center ray didn't hit, try all side rays
-  GroundRayCastCallback callbackLeft1;
-  callbackLeft1.playerBody = body;
-  body->GetWorld()->RayCast(&callbackLeft1, startLeft1, endLeft1);
-
-  if (callbackLeft1.hit)
-  {
-    return true;
-  }
-
-  GroundRayCastCallback callbackLeft2;
-  callbackLeft2.playerBody = body;
-  body->GetWorld()->RayCast(&callbackLeft2, startLeft2, endLeft2);
-
-  if (callbackLeft2.hit)
-  {
-    return true;
-  }
+  // Skip player's own fixture
+  b2QueryFilter filter;
+  filter.ignoreBody = body;
 
-  GroundRayCastCallback callbackRight1;
-  callbackRight1.playerBody = body;
-  body->GetWorld()->RayCast(&callbackRight1, startRight1, endRight1);
+  b2RayCastHit hits[5];
+  body->GetWorld()->RayCastBatch(rays, rayCount, hits, filter);
 
-  if (callbackRight1.hit)
+  for (int i = 0; i < rayCount; i++)
   {
-    return true;
+    // Strict check: Only count hits from directly below (normal pointing up)
+    // This prevents detecting walls as ground
+    if (hits[i].fixture != nullptr && hits[i].normal.y < -0.85f)
+    {
+      return true;
+    }
   }
 
-  GroundRayCastCallback callbackRight2;
-  callbackRight2.playerBody = body;
-  body->GetWorld()->RayCast(&callbackRight2, startRight2, endRight2);
-
-  return callbackRight2.hit;
+  return false;
 }
 
 void Player::updatePhysics()
@@ -574,111 +668,81 @@ void Player::updatePhysics()
       body->SetLinearVelocity(b2Vec2(currentVel.x * 0.5f, currentVel.y));
     }
   }
+  else if (!body->IsAwake() && walkingDirection == 0 && !isJumping)
+  {
+    // Asleep without input: nothing moved, keep the state and skip the probes
+  }
   else
   {
     // Normal movement when not dashing
 
+    // Wall and ceiling probes are traced together, results are applied in order below
+    b2RayCastInput rays[2];
+    int rayCount = 0;
+    int wallRay = -1;
+    int ceilingRay = -1;
+
     // Detect wall climbing attempt - when moving horizontally against a wall but not on ground
     if (!isOnGround() && walkingDirection != 0)
     {
       // Check if there's a wall in the direction of movement
-      b2Vec2 start = body->GetPosition();
-      float playerWidth = getWidth() * 0.7f; // Same hitbox scale as elsewhere
-      float horizontalCheckDistance = 0.2f;  // Short distance to check for walls
+      float horizontalCheckDistance = 0.2f; // Short distance to check for walls
 
       // Position ray at center of player, in direction of movement
-      b2Vec2 end = start + b2Vec2(walkingDirection * horizontalCheckDistance, 0);
-
-      // Check for collision with wall
-      class WallRayCastCallback : public b2RayCastCallback
-      {
-      public:
-        bool hit = false;
-        b2Body *playerBody = nullptr;
-
-        float ReportFixture(b2Fixture *fixture, const b2Vec2 &point,
-                            const b2Vec2 &normal, float fraction) override
-        {
-          // Skip player's own fixture
-          if (fixture->GetBody() == playerBody)
-          {
-            return -1;
-          }
-          hit = true;
-          return 0;
-        }
-      };
-
-      WallRayCastCallback wallCallback;
-      wallCallback.playerBody = body;
-      body->GetWorld()->RayCast(&wallCallback, start, end);
-
-      // If we're trying to move into a wall while in the air
-      if (wallCallback.hit)
-      {
-        // Apply a slight push away from wall to prevent climbing
-        body->ApplyLinearImpulse(
-            b2Vec2(-walkingDirection * 0.05f, 0.05f), // Push away from wall with slight downward force
-            body->GetWorldCenter(),
-            true);
-      }
+      wallRay = rayCount++;
+      rays[wallRay].p1 = body->GetPosition();
+      rays[wallRay].p2 = rays[wallRay].p1 + b2Vec2(walkingDirection * horizontalCheckDistance, 0);
+      rays[wallRay].maxFraction = 1.0f;
     }
 
     // Check for ceiling collisions - if the player is moving upward
     if (vel.y < 0)
     {
-      // Cast a ray upward to check for ceiling
+      // Cast a ray upward from top of player's head
       b2Vec2 start = body->GetPosition();
       float playerHeight = getHeight() * 0.7f; // Same hitbox scale as elsewhere
-
-      // Cast from top of player's head
       start.y -= (playerHeight / 2) / PPM;
 
       float ceilingCheckDistance = 0.2f;
-      b2Vec2 end = start - b2Vec2(0, ceilingCheckDistance);
+      ceilingRay = rayCount++;
+      rays[ceilingRay].p1 = start;
+      rays[ceilingRay].p2 = start - b2Vec2(0, ceilingCheckDistance);
+      rays[ceilingRay].maxFraction = 1.0f;
+    }
 
-      class CeilingRayCastCallback : public b2RayCastCallback
-      {
-      public:
-        bool hit = false;
-        b2Body *playerBody = nullptr;
-
-        float ReportFixture(b2Fixture *fixture, const b2Vec2 &point,
-                            const b2Vec2 &normal, float fraction) override
-        {
-          // Skip player's own fixture
-          if (fixture->GetBody() == playerBody)
-          {
-            return -1;
-          }
-          hit = true;
-          return 0;
-        }
-      };
-
-      CeilingRayCastCallback ceilingCallback;
-      ceilingCallback.playerBody = body;
-      body->GetWorld()->RayCast(&ceilingCallback, start, end);
-
-      // If we hit a ceiling while moving upward
-      if (ceilingCallback.hit)
+    b2RayCastHit hits[2];
+    if (rayCount > 0)
+    {
+      // Skip player's own fixture
+      b2QueryFilter filter;
+      filter.ignoreBody = body;
+      body->GetWorld()->RayCastBatch(rays, rayCount, hits, filter);
+    }
+
+    // If we're trying to move into a wall while in the air
+    if (wallRay != -1 && hits[wallRay].fixture != nullptr)
+    {
+      // Apply a slight push away from wall to prevent climbing
+      body->ApplyLinearImpulse(
+          b2Vec2(-walkingDirection * 0.05f, 0.05f), // Push away from wall with slight downward force
+          body->GetWorldCenter(),
+          true);
+    }
+
+    // If we hit a ceiling while moving upward
+    if (ceilingRay != -1 && hits[ceilingRay].fixture != nullptr)
+    {
+      // Calculate a bounce-back velocity based on current velocity
+      float bounceVelocity = vel.y * -0.2f; // 20% bounce in the opposite direction
+      // Ensure minimum bounce
+      if (bounceVelocity < 0.5f)
       {
-        // Stop upward velocity and apply a small downward velocity
-        if (vel.y < 0)
-        {
-          // Calculate a bounce-back velocity based on current velocity
-          float bounceVelocity = vel.y * -0.2f; // 20% bounce in the opposite direction
-          // Ensure minimum bounce
-          if (bounceVelocity < 0.5f)
-          {
-            bounceVelocity = 0.5f;
-          }
-
-          body->SetLinearVelocity(b2Vec2(vel.x, bounceVelocity)); // Apply downward velocity with bounce
-          isJumping = false;                                      // Stop the jump
-          shouldJump = false;                                     // Prevent immediate re-jump
-        }
+        bounceVelocity = 0.5f;
       }
+
+      body->SetLinearVelocity(b2Vec2(vel.x, bounceVelocity)); // Apply downward velocity with bounce
+      isJumping = false;                                      // Stop the jump
+      shouldJump = false;                                     // Prevent immediate re-jump
     }
 
     // Set current speed based on walk/run state, but only when on ground
@@ -708,6 +772,11 @@ void Player::updatePhysics()
       {
         body->SetLinearVelocity(b2Vec2(newVelX, vel.y));
       }
+      else if (vel.x != 0.0f)
+      {
+        // Too slow to notice, stop so the body can fall asleep
+        body->SetLinearVelocity(b2Vec2(0.0f, vel.y));
+      }
     }
     // For active movement, apply normal impulse but with reduced deceleration
     else
@@ -848,44 +917,13 @@ void Player::update()
   // Check if we're actually on the ground (without using the forgiveness timer)
   bool physicallyOnGround = false;
 
+  // Same center ray isOnGround starts with. A sleeping body hasn't moved,
+  // so the last result still holds
+  if (body->IsAwake())
   {
-    // Simple raycast to check ground - using existing implementation
-    const float hitboxScale = 0.7f;
-    b2Vec2 start = body->GetPosition();
-    float playerHeight = getHeight() * hitboxScale;
-    start.y += (playerHeight / 2) / PPM;
-    float rayLength = 0.5f; // Increased ray length for better detection
-    b2Vec2 end = start + b2Vec2(0, rayLength);
-
-    // Use a local ray cast callback for ground detection
-    class GroundCallback : public b2RayCastCallback
-    {
-    public:
-      bool hit = false;
-      b2Body *playerBody = nullptr;
-
-      float ReportFixture(b2Fixture *fixture, const b2Vec2 &point,
-                          const b2Vec2 &normal, float fraction) override
-      {
-        if (fixture->GetBody() == playerBody)
-        {
-          return -1; // Skip player's own fixture
-        }
-        if (normal.y < -0.85f)
-        { // Strict ground check to prevent wall climbing
-          hit = true;
-          return 0;
-        }
-        return -1;
-      }
-    };
-
-    GroundCallback callback;
-    callback.playerBody = body;
-    body->GetWorld()->RayCast(&callback, start, end);
-
-    physicallyOnGround = callback.hit;
+    groundProbeHit = probeGround(true);
   }
+  physicallyOnGround = groundProbeHit;
 
   // Handle ground forgiveness timer
   if (physicallyOnGround)
@@ -920,10 +958,8 @@ void Player::update()
   position = body->GetPosition();
   bool teleported = false;
 
-  // Get screen dimensions
-  int screenWidth, screenHeight;
-  SDL_GetRendererOutputSize(SDL_GetRenderer(SDL_GetWindowFromID(1)),
-                            &screenWidth, &screenHeight);
+  // Levels play in the logical space, whatever the window or render scale
+  int screenWidth = W_WIDTH, screenHeight = W_HEIGHT;
 
   // Check horizontal boundaries - convert Box2D meters to pixels for comparison
   float playerX = position.x * PPM;
@@ -1161,8 +1197,14 @@ void Player::render(SDL_Renderer *renderer)
   }
 }
 
-void Player::handleEvents(SDL_Event *event, SDL_Renderer *renderer)
+void Player::handleEvents(SDL_Event *event)
 {
+  // Any key may start a movement, the body has to take part in the next step
+  if (event->type == SDL_KEYDOWN || event->type == SDL_KEYUP)
+  {
+    body->SetAwake(true);
+  }
+
   if (event->type == SDL_KEYDOWN)
   {
     switch (event->key.keysym.sym)
@@ -1271,7 +1313,7 @@ void Player::handleEvents(SDL_Event *event, SDL_Renderer *renderer)
         SOUND_MANAGER.playSoundEffect("shoot");
       }
 
-      fireBullet(renderer);
+      fireBullet();
     }
   }
 }
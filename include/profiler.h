@@ -0,0 +1,92 @@
+#pragma once
+#include <SDL2/SDL_stdinc.h>
+
+// Scoped timing zones, recorded on every thread into its own ring buffer.
+// The recorder is always on: it keeps the last PROFILER_WINDOW_SECONDS of
+// zones and, when a frame takes longer than the hitch threshold, writes them
+// to a Chrome trace (chrome://tracing or ui.perfetto.dev) so one-off stalls
+// come with a timeline. Plain C so theoraplay's decoder threads can use it
+#define PROFILER_WINDOW_SECONDS 5.0
+// Zones kept per thread, about 8 s of a busy main thread
+#define PROFILER_EVENTS_PER_THREAD 8192
+// Threads recording at once, a thread's buffer is reused once it exits
+#define PROFILER_MAX_THREADS 16
+// Nesting depth of open zones on one thread
+#define PROFILER_MAX_DEPTH 32
+// Counter samples kept, a few counters a frame for over 10 s
+#define PROFILER_COUNTER_SAMPLES 2048
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// name must outlive the recorder, a string literal or __func__. Zones nest
+// and must end on the thread and in the reverse order they began
+void profilerBeginZone(const char *name);
+void profilerEndZone(void);
+
+// Labels the calling thread in traces, name is copied
+void profilerSetThreadName(const char *name);
+
+// Innermost open zone of the calling thread, NULL outside any zone or on a
+// thread that never recorded. Safe to call from inside an allocation
+const char *profilerCurrentZone(void);
+
+#ifdef __cplusplus
+}
+
+// Times the enclosing scope
+class ProfileZone {
+public:
+  explicit ProfileZone(const char *name) { profilerBeginZone(name); }
+  ~ProfileZone() { profilerEndZone(); }
+
+private:
+  ProfileZone(const ProfileZone &) = delete;
+  ProfileZone &operator=(const ProfileZone &) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+
+// Frame bookkeeping and trace export, main thread only
+class Profiler {
+public:
+  static Profiler &getInstance() {
+    static Profiler instance;
+    return instance;
+  }
+
+  // Call once per frame after the present. Records the frame as a zone and
+  // dumps a trace when it took longer than the hitch threshold
+  void endFrame();
+
+  // Writes the recorded window of every thread as Chrome trace JSON
+  bool dump(const char *path);
+
+  // Adds a sample to the counter track name, drawn as a graph above the
+  // threads. name must outlive the recorder like a zone's
+  void recordCounter(const char *name, double value);
+
+  // 0 turns the automatic dumps off
+  void setHitchThreshold(double ms) { hitchThreshold = ms; }
+  double getHitchThreshold() const { return hitchThreshold; }
+
+private:
+  Profiler() = default;
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  Uint64 frameStart = 0;
+  Uint64 lastDump = 0;
+  double hitchThreshold = 0.0; // Milliseconds, off until set
+  int hitchDumps = 0;
+};
+
+// Helper macro for easier access
+#define PROFILER Profiler::getInstance()
+
+#endif
+// Code created by Mouttaki Omar(王明清)
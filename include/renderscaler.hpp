@@ -0,0 +1,188 @@
+#pragma once
+#include <CONSTANTS.hpp>
+#include <SDL2/SDL.h>
+#include <textureregistry.hpp>
+
+// Bounds of the render scale
+#define RENDER_SCALE_MIN 0.5f
+#define RENDER_SCALE_MAX 1.0f
+
+// Draws the game at the logical resolution (W_WIDTH x W_HEIGHT) into an
+// offscreen texture and stretches that texture over the window. The texture
+// is the logical size times the render scale, so fill-rate follows the render
+// scale instead of the monitor. Integer scaling upscales by whole multiples
+// with nearest filtering and letterboxes the rest, otherwise the texture is
+// filtered linearly to fill the window while keeping the aspect ratio.
+class RenderScaler {
+public:
+  static RenderScaler &getInstance() {
+    static RenderScaler instance;
+    return instance;
+  }
+
+  bool init(SDL_Renderer *target, float scale, bool integer) {
+    renderer = target;
+    integerScale = integer;
+    return setRenderScale(scale);
+  }
+
+  // Recreates the offscreen texture, scale is clamped to the bounds above.
+  // Without render target support the renderer scales to the window itself
+  bool setRenderScale(float scale) {
+    if (renderer == nullptr)
+      return false;
+
+    renderScale = SDL_clamp(scale, RENDER_SCALE_MIN, RENDER_SCALE_MAX);
+    textureWidth = (int)(W_WIDTH * renderScale);
+    textureHeight = (int)(W_HEIGHT * renderScale);
+
+    if (texture != nullptr) {
+      TEXTURE_REGISTRY.destroy(texture);
+      texture = nullptr;
+    }
+    if (SDL_RenderTargetSupported(renderer)) {
+      texture = TEXTURE_REGISTRY.create(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                        SDL_TEXTUREACCESS_TARGET, textureWidth,
+                                        textureHeight, "render target");
+    }
+    if (texture == nullptr) {
+      SDL_Log("RenderScaler: No render target (%s), scaling at full "
+              "resolution",
+              SDL_GetError());
+      SDL_RenderSetLogicalSize(renderer, W_WIDTH, W_HEIGHT);
+      return false;
+    }
+
+    SDL_RenderSetLogicalSize(renderer, 0, 0);
+    updateScaleMode();
+    SDL_Log("RenderScaler: Rendering %dx%d (%d%%) for a %dx%d logical screen",
+            textureWidth, textureHeight, (int)(renderScale * 100.0f + 0.5f),
+            W_WIDTH, W_HEIGHT);
+    return true;
+  }
+  float getRenderScale() const { return renderScale; }
+  // Width of what is actually rendered, images wider than this are wasted
+  int getTargetWidth() const { return texture != nullptr ? textureWidth : W_WIDTH; }
+
+  void setIntegerScale(bool integer) {
+    integerScale = integer;
+    updateScaleMode();
+  }
+  bool getIntegerScale() const { return integerScale; }
+
+  // Redirects drawing to the offscreen texture, in logical coordinates
+  void begin() {
+    if (texture == nullptr)
+      return;
+    SDL_SetRenderTarget(renderer, texture);
+    SDL_RenderSetScale(renderer, renderScale, renderScale);
+  }
+
+  // Copies the offscreen texture to the window, the caller presents
+  void end() {
+    if (texture == nullptr)
+      return;
+    SDL_SetRenderTarget(renderer, nullptr);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    SDL_Rect output = outputRect();
+    SDL_RenderCopy(renderer, texture, nullptr, &output);
+  }
+
+  // Rewrites the coordinates of mouse events from window to logical space
+  void translateEvent(SDL_Event *event) const {
+    switch (event->type) {
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+      windowToLogical(event->button.x, event->button.y);
+      break;
+    case SDL_MOUSEMOTION:
+      windowToLogical(event->motion.x, event->motion.y);
+      event->motion.xrel = event->motion.xrel * W_WIDTH / outputRect().w;
+      event->motion.yrel = event->motion.yrel * W_HEIGHT / outputRect().h;
+      break;
+    default:
+      break;
+    }
+  }
+
+  // SDL_GetMouseState in logical coordinates
+  Uint32 getMouseState(int *x, int *y) const {
+    int mouseX, mouseY;
+    Uint32 buttons = SDL_GetMouseState(&mouseX, &mouseY);
+    if (texture != nullptr) {
+      windowToLogical(mouseX, mouseY);
+    } else if (renderer != nullptr) {
+      float logicalX, logicalY;
+      SDL_RenderWindowToLogical(renderer, mouseX, mouseY, &logicalX, &logicalY);
+      mouseX = (int)logicalX;
+      mouseY = (int)logicalY;
+    }
+    if (x != nullptr)
+      *x = mouseX;
+    if (y != nullptr)
+      *y = mouseY;
+    return buttons;
+  }
+
+  // Must run before the renderer is destroyed
+  void clean() {
+    if (texture != nullptr) {
+      TEXTURE_REGISTRY.destroy(texture);
+      texture = nullptr;
+    }
+    renderer = nullptr;
+  }
+
+private:
+  RenderScaler() = default;
+  RenderScaler(const RenderScaler &) = delete;
+  RenderScaler &operator=(const RenderScaler &) = delete;
+
+  void updateScaleMode() {
+    if (texture != nullptr) {
+      SDL_SetTextureScaleMode(texture, integerScale ? SDL_ScaleModeNearest
+                                                    : SDL_ScaleModeLinear);
+    }
+  }
+
+  // Where the offscreen texture lands in the window, centered
+  SDL_Rect outputRect() const {
+    int windowWidth = W_WINDOW_WIDTH;
+    int windowHeight = W_WINDOW_HEIGHT;
+    SDL_GetRendererOutputSize(renderer, &windowWidth, &windowHeight);
+
+    float fit = SDL_min((float)windowWidth / textureWidth,
+                        (float)windowHeight / textureHeight);
+    // Integer scaling needs a window at least as large as the texture
+    if (integerScale && fit >= 1.0f)
+      fit = SDL_floorf(fit);
+
+    SDL_Rect output;
+    output.w = (int)(textureWidth * fit);
+    output.h = (int)(textureHeight * fit);
+    output.x = (windowWidth - output.w) / 2;
+    output.y = (windowHeight - output.h) / 2;
+    return output;
+  }
+
+  void windowToLogical(int &x, int &y) const {
+    // Without a texture SDL_RenderSetLogicalSize already translated events
+    if (texture == nullptr)
+      return;
+    SDL_Rect output = outputRect();
+    x = (x - output.x) * W_WIDTH / output.w;
+    y = (y - output.y) * W_HEIGHT / output.h;
+  }
+
+  SDL_Renderer *renderer = nullptr;
+  SDL_Texture *texture = nullptr;
+  int textureWidth = 0;
+  int textureHeight = 0;
+  float renderScale = 1.0f;
+  bool integerScale = false;
+};
+
+// Helper macro for easier access
+#define RENDER_SCALER RenderScaler::getInstance()
+// Code created by Mouttaki Omar(王明清)
@@ -3,6 +3,7 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
 #include <SDL2/SDL_log.h> // Make sure SDL_log is included (often via SDL.h)
+#include "profiler.h"
 #include <map>
 #include <string>
 #include <vector>
@@ -58,6 +59,7 @@ public:
 
     ~SoundManager() {
         SDL_Log("SoundManager: Shutting down...");
+        stopStream();
         Mix_HaltMusic();
         Mix_HaltChannel(-1);
 
@@ -184,17 +186,17 @@ public:
      * @param loops Number of times to loop (0 for play once).
      * @return The dedicated channel the sound was played on, or -1 on error.
      */
-    int playSoundEffect(const std::string& name, int loops = 0) {
+    int playSoundEffect(const char* name, int loops = 0) {
         auto it = soundEffectMap.find(name);
         if (it == soundEffectMap.end()) {
-            SDL_Log("SoundManager Error: Cannot play SFX '%s'. Not loaded.", name.c_str());
+            SDL_Log("SoundManager Error: Cannot play SFX '%s'. Not loaded.", name);
             return -1;
         }
 
         const SoundEffectInfo& info = it->second;
 
         if (!info.chunk || info.channel < 0) {
-             SDL_Log("SoundManager Error: Cannot play SFX '%s'. Chunk invalid or no channel assigned (load failed?).", name.c_str());
+             SDL_Log("SoundManager Error: Cannot play SFX '%s'. Chunk invalid or no channel assigned (load failed?).", name);
             return -1;
         }
 
@@ -203,17 +205,17 @@ public:
 
         if (playedChannel == -1) {
              // This might happen if the channel system has an issue, though less likely than channel contention with -1.
-             SDL_Log("SoundManager Error: Failed to play SFX '%s' on its dedicated channel %d! Error: %s", name.c_str(), info.channel, Mix_GetError());
+             SDL_Log("SoundManager Error: Failed to play SFX '%s' on its dedicated channel %d! Error: %s", name, info.channel, Mix_GetError());
              return -1; // Return -1 as playing failed
         } else if (playedChannel != info.channel) {
              // This case *shouldn't* happen with Mix_PlayChannel(specific_channel,...)
-             SDL_Log("SoundManager Warning: Played SFX '%s' on channel %d but expected dedicated channel %d.", name.c_str(), playedChannel, info.channel);
+             SDL_Log("SoundManager Warning: Played SFX '%s' on channel %d but expected dedicated channel %d.", name, playedChannel, info.channel);
              // Still return the actual channel it played on? Or the expected one? Return expected for consistency.
              return info.channel;
         }
 
         // Success
-        // Optional: SDL_Log("SoundManager: Played SFX '%s' on dedicated channel %d", name.c_str(), info.channel);
+        // Optional: SDL_Log("SoundManager: Played SFX '%s' on dedicated channel %d", name, info.channel);
         return info.channel; // Return the dedicated channel number
     }
 
@@ -228,13 +230,13 @@ public:
      * @brief Stops the specific sound effect associated with 'name' by halting its dedicated channel.
      * @param name Identifier of the sound effect to stop.
      */
-    void stopSoundEffect(const std::string& name) {
+    void stopSoundEffect(const char* name) {
         auto it = soundEffectMap.find(name);
         if (it != soundEffectMap.end() && it->second.channel >= 0) {
             Mix_HaltChannel(it->second.channel);
-             // Optional: SDL_Log("SoundManager: Stopped SFX '%s' on dedicated channel %d", name.c_str(), it->second.channel);
+             // Optional: SDL_Log("SoundManager: Stopped SFX '%s' on dedicated channel %d", name, it->second.channel);
         } else {
-            //  SDL_Log("SoundManager Warning: Cannot stop SFX '%s'. Not loaded or no channel assigned.", name.c_str());
+            //  SDL_Log("SoundManager Warning: Cannot stop SFX '%s'. Not loaded or no channel assigned.", name);
         }
     }
 
@@ -257,24 +259,115 @@ public:
     }
 
 
+    // --- Streamed Audio (cutscenes) ---
+
+    /**
+     * @brief Takes over the music slot to play raw float samples pushed with queueStream().
+     * The device opened in init() stays open; samples are converted to the mixer's
+     * format and rate, and SFX channels keep playing on top.
+     * @param frequency Sample rate of the samples that will be queued.
+     * @param channels Number of interleaved channels in the queued samples.
+     * @return True if the stream is ready to receive samples.
+     */
+    bool startStream(int frequency, int channels) {
+        stopStream();
+
+        int mixFrequency = 0;
+        Uint16 mixFormat = 0;
+        int mixChannels = 0;
+        if (Mix_QuerySpec(&mixFrequency, &mixFormat, &mixChannels) == 0) {
+            SDL_Log("SoundManager Error: Cannot start stream, audio is not open! Error: %s", Mix_GetError());
+            return false;
+        }
+
+        stream = SDL_NewAudioStream(AUDIO_F32SYS, (Uint8)channels, frequency,
+                                    mixFormat, (Uint8)mixChannels, mixFrequency);
+        if (!stream) {
+            SDL_Log("SoundManager Error: Failed to create audio stream! Error: %s", SDL_GetError());
+            return false;
+        }
+        streamLock = SDL_CreateMutex();
+        streamChannels = channels;
+
+        // The hook replaces music playback until stopStream()
+        Mix_HaltMusic();
+        currentTrack = "";
+        Mix_HookMusic(streamCallback, this);
+        SDL_Log("SoundManager: Streaming %d Hz/%d ch into the mixer (%d Hz/%d ch).", frequency, channels, mixFrequency, mixChannels);
+        return true;
+    }
+
+    /**
+     * @brief Appends interleaved float samples to the stream started with startStream().
+     * @param samples Interleaved samples, copied before returning.
+     * @param frames Number of sample frames (samples per channel).
+     */
+    void queueStream(const float* samples, int frames) {
+        if (!stream || frames <= 0) {
+            return;
+        }
+        SDL_LockMutex(streamLock);
+        if (SDL_AudioStreamPut(stream, samples, frames * streamChannels * (int)sizeof(float)) != 0) {
+            SDL_Log("SoundManager Warning: Dropped %d streamed frames! Error: %s", frames, SDL_GetError());
+        }
+        SDL_UnlockMutex(streamLock);
+    }
+
+    /**
+     * @brief Releases the music slot taken by startStream(), dropping anything still queued.
+     */
+    void stopStream() {
+        if (!stream) {
+            return;
+        }
+        // Once this returns the mixer thread is no longer inside streamCallback
+        Mix_HookMusic(NULL, NULL);
+        SDL_FreeAudioStream(stream);
+        SDL_DestroyMutex(streamLock);
+        stream = nullptr;
+        streamLock = nullptr;
+        streamChannels = 0;
+        SDL_Log("SoundManager: Stopped streaming.");
+    }
+
+
 private:
     // --- Private Constructor for Singleton ---
-    SoundManager() : musicVolume(MIX_MAX_VOLUME), sfxVolume(MIX_MAX_VOLUME), currentTrack(""), totalMixChannels(0), nextAvailableChannel(0) {}
+    SoundManager() : musicVolume(MIX_MAX_VOLUME), sfxVolume(MIX_MAX_VOLUME), currentTrack(""), totalMixChannels(0), nextAvailableChannel(0), stream(nullptr), streamLock(nullptr), streamChannels(0) {}
     SoundManager(const SoundManager&) = delete;
     SoundManager& operator=(const SoundManager&) = delete;
 
     // --- Data Members ---
     std::map<std::string, Mix_Music*> musicTracks;
-    // Map SFX name to its info (chunk + dedicated channel)
-    std::map<std::string, SoundEffectInfo> soundEffectMap;
+    // Map SFX name to its info (chunk + dedicated channel). std::less<> looks
+    // names up without building a std::string, so playing a sound allocates nothing
+    std::map<std::string, SoundEffectInfo, std::less<>> soundEffectMap;
     std::string currentTrack;
     int musicVolume;
     int sfxVolume;
     int totalMixChannels;     // Total number of mixing channels allocated
     int nextAvailableChannel; // Index of the next channel to assign
+    SDL_AudioStream* stream;  // Converts streamed samples to the mixer's format
+    SDL_mutex* streamLock;    // Guards stream between the game and mixer threads
+    int streamChannels;
+
+    // Runs on the mixer thread in place of music, the buffer arrives silenced
+    static void SDLCALL streamCallback(void* userdata, Uint8* buffer, int len) {
+        SoundManager* self = static_cast<SoundManager*>(userdata);
+        SDL_LockMutex(self->streamLock);
+        int got = SDL_AudioStreamGet(self->stream, buffer, len);
+        SDL_UnlockMutex(self->streamLock);
+        if (got < 0) {
+            got = 0;
+        }
+        if (got < len) {
+            SDL_memset(buffer + got, 0, len - got);
+        }
+    }
 
     // --- Helper Functions --- (Fade logic remains the same)
     void fadeOutAndPlay(const std::string& name, int loops, int fadeInMs) {
+        PROFILE_ZONE("SoundManager::fadeOutAndPlay");
         const int fadeOutMs = 500;
         SDL_Log("SoundManager: Fading out current music (%s) to play '%s'.", currentTrack.c_str(), name.c_str());
         Mix_FadeOutMusic(fadeOutMs);
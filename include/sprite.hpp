@@ -10,7 +10,7 @@ class Sprite {
     int getX() const { return posX; }
     int getY() const { return posY; }
     SDL_Rect getRect() const { return destRect; }
-    bool loadFromFile(const char* path, SDL_Renderer* renderer);
+    bool loadFromFile(const char* path, SDL_Renderer* renderer, const char* owner = "sprite");
     void setTexture(SDL_Texture* texture) { this->texture = texture; }
     void render(SDL_Renderer* renderer, int x, int y);
     void setPosition(int x, int y);
@@ -40,9 +40,9 @@ Sprite::~Sprite() {
     texture = nullptr;
 }
 
-bool Sprite::loadFromFile(const char* path, SDL_Renderer* renderer) {
+bool Sprite::loadFromFile(const char* path, SDL_Renderer* renderer, const char* owner) {
     // Load image at specified path
-    SDL_Surface* loadedSurface = Texture::loadFromFile(path, renderer, texture);
+    SDL_Surface* loadedSurface = Texture::loadFromFile(path, renderer, texture, owner);
     if (loadedSurface == nullptr) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to load image %s! SDL_image Error: %s\n", path, SDL_GetError());
         exit(1);
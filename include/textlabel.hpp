@@ -0,0 +1,74 @@
+#pragma once
+#include "alloctracker.hpp"
+#include "textureregistry.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string.h>
+
+// Longest text a label compares against, longer text is drawn again every
+// frame
+#define TEXT_LABEL_CAPACITY 64
+
+// One line of text kept as a texture. set() only renders it again when the
+// text, font or color changed, so a HUD showing the same values frame after
+// frame creates no surfaces or textures. A redraw is the one allocation a
+// steady frame is allowed, see AllowAllocations
+class TextLabel {
+public:
+  TextLabel() = default;
+  ~TextLabel() { release(); }
+
+  // False when there is nothing to draw, an empty text or a failed render
+  bool set(SDL_Renderer *renderer, TTF_Font *font, const char *text, SDL_Color color) {
+    if (texture != nullptr && font == this->font && strcmp(text, this->text) == 0 &&
+        memcmp(&color, &this->color, sizeof(SDL_Color)) == 0)
+      return true;
+
+    AllowAllocations allow;
+    release();
+    this->font = font;
+    this->color = color;
+    SDL_strlcpy(this->text, text, sizeof(this->text));
+    if (font == nullptr || text[0] == '\0')
+      return false;
+    SDL_Surface *surface = TTF_RenderText_Solid(font, text, color);
+    if (surface == nullptr)
+      return false;
+    texture = TEXTURE_REGISTRY.createFromSurface(renderer, surface, "text");
+    width = surface->w;
+    height = surface->h;
+    SDL_FreeSurface(surface);
+    return texture != nullptr;
+  }
+
+  void render(SDL_Renderer *renderer, int x, int y) const {
+    if (texture == nullptr)
+      return;
+    SDL_Rect rect = {x, y, width, height};
+    SDL_RenderCopy(renderer, texture, NULL, &rect);
+  }
+
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+
+  // Frees the texture, the next set() renders again
+  void release() {
+    if (texture != nullptr) {
+      TEXTURE_REGISTRY.destroy(texture);
+      texture = nullptr;
+    }
+  }
+
+private:
+  TextLabel(const TextLabel &) = delete;
+  TextLabel &operator=(const TextLabel &) = delete;
+
+  SDL_Texture *texture = nullptr;
+  TTF_Font *font = nullptr;
+  SDL_Color color = {0, 0, 0, 0};
+  char text[TEXT_LABEL_CAPACITY] = "";
+  int width = 0;
+  int height = 0;
+};
+
+// Code created by Mouttaki Omar(王明清)
@@ -0,0 +1,222 @@
+#pragma once
+#include <CONSTANTS.hpp>
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Frames a reloadable texture must go unused before the budget may evict it
+#define TEXTURE_COLD_FRAMES 60
+
+// Handle of a reloadable texture, see TextureRegistry::load
+typedef int TextureId;
+#define TEXTURE_ID_NONE -1
+
+// What the registry knows about one live texture
+struct TextureRecord {
+    const char* owner;    // Groups textures in the usage breakdown
+    size_t bytes;         // Estimated GPU memory
+    Uint64 lastUsedFrame; // Last get() of a reloadable, the creation frame otherwise
+};
+
+// Live total of one owner
+struct TextureUsage {
+    const char* owner;
+    size_t bytes;
+    int count;
+};
+
+// Every texture the game creates goes through here so its memory can be
+// accounted for. Most textures are pinned: the caller keeps the SDL_Texture*
+// and hands it back to destroy(). Images loaded with load() are reloadable
+// instead, the caller keeps a TextureId and fetches the texture each frame
+// with get(). When the total goes over the budget, reloadable textures unused
+// for TEXTURE_COLD_FRAMES are evicted coldest first and get() reloads them
+class TextureRegistry {
+  public:
+    static TextureRegistry& getInstance() {
+        static TextureRegistry instance;
+        return instance;
+    }
+
+    // Pinned textures, owner must be a string literal
+    SDL_Texture* create(SDL_Renderer* renderer, Uint32 format, int access, int w, int h, const char* owner) {
+        SDL_Texture* texture = SDL_CreateTexture(renderer, format, access, w, h);
+        track(texture, owner);
+        return texture;
+    }
+    SDL_Texture* createFromSurface(SDL_Renderer* renderer, SDL_Surface* surface, const char* owner) {
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        track(texture, owner);
+        return texture;
+    }
+    // Accounts for a texture created elsewhere
+    void track(SDL_Texture* texture, const char* owner) {
+        if (texture == nullptr)
+            return;
+        TextureRecord record = {owner, textureBytes(texture), frame};
+        records[texture] = record;
+        totalBytes += record.bytes;
+    }
+    // Also destroys textures the registry never saw
+    void destroy(SDL_Texture* texture) {
+        if (texture == nullptr)
+            return;
+        auto it = records.find(texture);
+        if (it != records.end()) {
+            totalBytes -= it->second.bytes;
+            records.erase(it);
+        }
+        SDL_DestroyTexture(texture);
+    }
+
+    // Reloadable images, loaded now and reloaded from path after an eviction.
+    // These load through Texture and are defined after it in textures.hpp
+    TextureId load(const char* path, SDL_Renderer* renderer, const char* owner);
+    // Marks the texture used this frame, reloads it if it was evicted.
+    // The pointer is only good until the next beginFrame
+    SDL_Texture* get(TextureId id);
+    void release(TextureId id) {
+        if (id < 0 || id >= (int)reloadables.size())
+            return;
+        destroy(reloadables[id].texture);
+        reloadables[id] = Reloadable();
+        freeIds.push_back(id);
+    }
+
+    // Call once per frame, before anything is drawn
+    void beginFrame() {
+        frame++;
+        if (totalBytes > budget)
+            enforceBudget();
+    }
+
+    void setBudget(size_t bytes) {
+        budget = bytes;
+        enforceBudget();
+    }
+    size_t getBudget() const { return budget; }
+    size_t getTotalBytes() const { return totalBytes; }
+    int getTextureCount() const { return (int)records.size(); }
+    Uint64 getFrame() const { return frame; }
+
+    // Live bytes per owner, largest first
+    std::vector<TextureUsage> getUsage() const {
+        std::vector<TextureUsage> usage;
+        for (const auto& pair : records) {
+            const TextureRecord& record = pair.second;
+            auto it = std::find_if(usage.begin(), usage.end(), [&](const TextureUsage& u) {
+                return strcmp(u.owner, record.owner) == 0;
+            });
+            if (it == usage.end()) {
+                TextureUsage entry = {record.owner, 0, 0};
+                usage.push_back(entry);
+                it = usage.end() - 1;
+            }
+            it->bytes += record.bytes;
+            it->count++;
+        }
+        std::sort(usage.begin(), usage.end(), [](const TextureUsage& a, const TextureUsage& b) {
+            return a.bytes > b.bytes;
+        });
+        return usage;
+    }
+
+    void logUsage() const {
+        SDL_Log("Textures: %d, %.1f MB of %.1f MB budget, %d evictions", getTextureCount(),
+                toMegabytes(totalBytes), toMegabytes(budget), evictionCount);
+        for (const TextureUsage& usage : getUsage()) {
+            SDL_Log("  %-16s %4d textures %8.1f MB", usage.owner, usage.count, toMegabytes(usage.bytes));
+        }
+    }
+
+    // Must run before the renderer is destroyed, which frees what is left
+    void clean() {
+        if (!records.empty()) {
+            SDL_Log("Textures still alive at exit:");
+            logUsage();
+        }
+        records.clear();
+        reloadables.clear();
+        freeIds.clear();
+        totalBytes = 0;
+    }
+
+  private:
+    TextureRegistry() = default;
+    TextureRegistry(const TextureRegistry&) = delete;
+    TextureRegistry& operator=(const TextureRegistry&) = delete;
+
+    struct Reloadable {
+        std::string path;
+        SDL_Renderer* renderer = nullptr;
+        const char* owner = nullptr;
+        SDL_Texture* texture = nullptr; // nullptr while evicted
+    };
+
+    // (Re)loads the image of a reloadable slot
+    bool reload(TextureId id);
+
+    static double toMegabytes(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+    static size_t textureBytes(SDL_Texture* texture) {
+        Uint32 format;
+        int w, h;
+        if (SDL_QueryTexture(texture, &format, nullptr, &w, &h) != 0)
+            return 0;
+        switch (format) {
+        // Planar YUV, a full luma plane and two quarter chroma planes
+        case SDL_PIXELFORMAT_IYUV:
+        case SDL_PIXELFORMAT_YV12:
+        case SDL_PIXELFORMAT_NV12:
+        case SDL_PIXELFORMAT_NV21:
+            return (size_t)w * h + 2 * (size_t)((w + 1) / 2) * ((h + 1) / 2);
+        default:
+            return (size_t)w * h * SDL_BYTESPERPIXEL(format);
+        }
+    }
+
+    // Evicts cold reloadable textures, least recently used first, until the
+    // total fits the budget
+    void enforceBudget() {
+        std::vector<TextureId> cold;
+        for (TextureId id = 0; id < (int)reloadables.size(); id++) {
+            SDL_Texture* texture = reloadables[id].texture;
+            if (texture != nullptr && records[texture].lastUsedFrame + TEXTURE_COLD_FRAMES <= frame)
+                cold.push_back(id);
+        }
+        std::sort(cold.begin(), cold.end(), [&](TextureId a, TextureId b) {
+            return records[reloadables[a].texture].lastUsedFrame < records[reloadables[b].texture].lastUsedFrame;
+        });
+
+        for (TextureId id : cold) {
+            if (totalBytes <= budget)
+                break;
+            Reloadable& reloadable = reloadables[id];
+            SDL_Log("Textures: Evicting %s (%s)", reloadable.path.c_str(), reloadable.owner);
+            destroy(reloadable.texture);
+            reloadable.texture = nullptr;
+            evictionCount++;
+        }
+        // Everything resident is pinned or in use, say so once per overrun
+        if (totalBytes > budget && !overBudget)
+            SDL_Log("Textures: %.1f MB over the budget with nothing cold to evict",
+                    toMegabytes(totalBytes - budget));
+        overBudget = totalBytes > budget;
+    }
+
+    std::unordered_map<SDL_Texture*, TextureRecord> records;
+    std::vector<Reloadable> reloadables;
+    std::vector<TextureId> freeIds;
+    size_t totalBytes = 0;
+    size_t budget = W_TEXTURE_BUDGET;
+    Uint64 frame = 0;
+    int evictionCount = 0;
+    bool overBudget = false;
+};
+
+// Helper macro for easier access
+#define TEXTURE_REGISTRY TextureRegistry::getInstance()
+// Code created by Mouttaki Omar(王明清)
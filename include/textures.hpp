@@ -2,25 +2,46 @@
 #include <CONSTANTS.hpp>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <assetpack.hpp>
+#include <profiler.h>
+#include <renderscaler.hpp>
+#include <textureregistry.hpp>
 class Texture {
   public:
-    // Load a texture from a file
+    // Load a texture from a file, or from the asset pack when it holds the path
     // @param path The path to the image file
     // @param renderer The renderer to load the texture onto
     // @param texture The texture to load the image onto
-    static SDL_Surface* loadFromFile(const char* path, SDL_Renderer* renderer, SDL_Texture*& texture) {
+    // @param owner Who the texture counts against in TextureRegistry
+    // @return A surface of the image's size to free with SDL_FreeSurface. For
+    // packed images its pixels stay valid only until the next load
+    static SDL_Surface* loadFromFile(const char* path, SDL_Renderer* renderer, SDL_Texture*& texture,
+                                     const char* owner = "image") {
         if (texture != nullptr) {
-            SDL_DestroyTexture(texture);
+            TEXTURE_REGISTRY.destroy(texture);
             texture = nullptr;
         }
 
+        // Packed images are already decoded, backgrounds come pre-scaled to
+        // the render resolution
+        const AssetPackEntry* entry = ASSET_PACK.find(path, RENDER_SCALER.getTargetWidth());
+        if (entry != nullptr) {
+            texture = ASSET_PACK.createTexture(renderer, entry);
+            if (texture != nullptr) {
+                TEXTURE_REGISTRY.track(texture, owner);
+                return SDL_CreateRGBSurfaceWithFormatFrom(ASSET_PACK.getPixels(), entry->width, entry->height,
+                                                          32, entry->width * 4, ASSET_PACK.getPixelFormat());
+            }
+        }
+
+        PROFILE_ZONE("IMG_Load");
         SDL_Surface* loadedSurface = IMG_Load(path);
         if (loadedSurface == nullptr) {
             SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to load image %s! SDL_image Error: %s\n", path, SDL_GetError());
             return nullptr;
         }
 
-        texture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
+        texture = TEXTURE_REGISTRY.createFromSurface(renderer, loadedSurface, owner);
         if (texture == nullptr) {
             SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to create texture from %s! SDL Error: %s\n", path, SDL_GetError());
             return nullptr;
@@ -30,4 +51,49 @@ class Texture {
     }
 };
 
-// Code created by Mouttaki Omar(王明清)
\ No newline at end of file
+TextureId TextureRegistry::load(const char* path, SDL_Renderer* renderer, const char* owner) {
+    TextureId id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        id = (TextureId)reloadables.size();
+        reloadables.push_back(Reloadable());
+    }
+    reloadables[id].path = path;
+    reloadables[id].renderer = renderer;
+    reloadables[id].owner = owner;
+
+    if (!reload(id)) {
+        release(id);
+        return TEXTURE_ID_NONE;
+    }
+    if (totalBytes > budget)
+        enforceBudget();
+    return id;
+}
+
+SDL_Texture* TextureRegistry::get(TextureId id) {
+    if (id < 0 || id >= (int)reloadables.size())
+        return nullptr;
+    Reloadable& reloadable = reloadables[id];
+    if (reloadable.texture == nullptr) {
+        SDL_Log("Textures: Reloading %s (%s)", reloadable.path.c_str(), reloadable.owner);
+        if (!reload(id))
+            return nullptr;
+    }
+    records[reloadable.texture].lastUsedFrame = frame;
+    return reloadable.texture;
+}
+
+bool TextureRegistry::reload(TextureId id) {
+    Reloadable& reloadable = reloadables[id];
+    SDL_Surface* surface = Texture::loadFromFile(reloadable.path.c_str(), reloadable.renderer,
+                                                 reloadable.texture, reloadable.owner);
+    if (surface == nullptr)
+        return false;
+    SDL_FreeSurface(surface);
+    return true;
+}
+
+// Code created by Mouttaki Omar(王明清)
@@ -53,10 +53,21 @@ typedef struct THEORAPLAY_VideoFrame
     unsigned int width;
     unsigned int height;
     THEORAPLAY_VideoFormat format;
-    unsigned char *pixels;
+    unsigned char *pixels;  /* NULL if the frame went to a video target instead. */
+    void *target;  /* userdata of the THEORAPLAY_VideoTarget written to, or NULL. */
     struct THEORAPLAY_VideoFrame *next;
 } THEORAPLAY_VideoFrame;
 
+/* Zero-copy output for YV12/IYUV: memory the decoder writes the next frame's
+   planes into, typically what SDL_LockTexture returns for a streaming texture.
+   planes[0] is Y, planes[1] and planes[2] follow the video format's order. */
+typedef struct THEORAPLAY_VideoTarget
+{
+    unsigned char *planes[3];
+    int pitches[3];
+    void *userdata;  /* handed back in THEORAPLAY_VideoFrame::target. */
+} THEORAPLAY_VideoTarget;
+
 typedef struct THEORAPLAY_AudioPacket
 {
     unsigned int seek_generation;  /* when seeking, throw away any frames from previous seek generation. */
@@ -83,6 +94,20 @@ void THEORAPLAY_stopDecode(THEORAPLAY_Decoder *decoder);
 // call this frequently if not multithreaded! Safe no-op if multithreaded.
 void THEORAPLAY_pumpDecode(THEORAPLAY_Decoder *decoder, const int maxframes);
 
+/* Video frames are recycled through a pool owned by the decoder; freeing a
+   frame hands its buffer back for the next one. The pool is bounded in bytes
+   (frames queued plus frames the app still holds). By default the budget is
+   maxframes frames' worth of pixels; this overrides it, 0 restores it. */
+void THEORAPLAY_setVideoBufferBytes(THEORAPLAY_Decoder *decoder, unsigned int maxbytes);
+
+/* Queue a target for a future frame. The memory must stay valid and untouched
+   until a frame carrying its userdata comes back from THEORAPLAY_getVideo (or
+   the decoder is stopped); after that it's yours again. Once any target was
+   submitted, the decoder stops buffering ahead into its own pool and waits for
+   targets instead. Returns zero if the format isn't planar YUV or too many
+   targets are already queued. */
+int THEORAPLAY_submitVideoTarget(THEORAPLAY_Decoder *decoder, const THEORAPLAY_VideoTarget *target);
+
 int THEORAPLAY_isDecoding(THEORAPLAY_Decoder *decoder);
 int THEORAPLAY_decodingError(THEORAPLAY_Decoder *decoder);
 int THEORAPLAY_isInitialized(THEORAPLAY_Decoder *decoder);
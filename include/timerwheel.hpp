@@ -0,0 +1,266 @@
+#pragma once
+#include <CONSTANTS.hpp>
+#include <SDL2/SDL.h>
+#include <functional>
+#include <vector>
+
+// Four levels of 64 slots. Level k holds the timers due within 64^(k+1)
+// ticks, 64^4 ticks is over three days at W_TARGET_FPS
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_MAX_DELAY ((1u << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1)
+#define TIMER_INDEX_MASK 0xFFFF
+#define TIMER_GENERATION_SHIFT 16
+
+// Like Entity: the low bits index the timer pool, the high bits count how
+// often that index was reused so a stale id never cancels someone else's timer
+typedef Uint32 TimerId;
+#define TIMER_NONE 0xFFFFFFFFu
+
+// An expired scheduleEvent timer, see TimerWheel::pollEvent
+struct TimerEvent {
+  int type; // Whatever the owner passed to scheduleEvent
+  void *data;
+  TimerId id;
+};
+
+// Timers on the simulation clock: one tick per advance, which levels call
+// once per update, so they run at W_TARGET_FPS ticks a second and pause
+// with the game. Timers are hashed into the slots of a hierarchical wheel by
+// expiry. A tick fires the one slot that comes due and, every 64 ticks,
+// spreads a slot of the level above over the level below, so its cost
+// follows the timers that expire and not the timers that exist. An expired
+// timer either runs its callback or queues an event for its owner to poll
+class TimerWheel {
+public:
+  TimerWheel();
+
+  // Delays are in ticks and fire on the advance that reaches them, 0 counts
+  // as 1. Callbacks may schedule and cancel timers themselves
+  TimerId schedule(Uint32 delay, std::function<void()> callback);
+  TimerId scheduleEvent(Uint32 delay, int type, void *data);
+
+  // Stale and TIMER_NONE ids are ignored
+  void cancel(TimerId id);
+  bool isPending(TimerId id) const;
+  // Ticks until the timer fires, 0 if it is not pending
+  Uint32 getRemaining(TimerId id) const;
+
+  // Moves the clock one tick forward and fires what is due
+  void advance();
+  // Pops the oldest expired event, false once there is none
+  bool pollEvent(TimerEvent *event);
+
+  // Drops every timer and queued event
+  void clear();
+
+  Uint32 getNow() const { return now; }
+  int getPendingCount() const { return pendingCount; }
+
+  static Uint32 msToTicks(Uint32 ms) { return (Uint32)(((Uint64)ms * W_TARGET_FPS + 999) / 1000); }
+  static Uint32 secondsToTicks(float seconds) { return (Uint32)SDL_ceilf(seconds * W_TARGET_FPS); }
+  static float ticksToSeconds(Uint32 ticks) { return (float)ticks / W_TARGET_FPS; }
+
+private:
+  struct Node {
+    Uint32 expiry;
+    int slot; // Index into heads, -1 while the node is free
+    int prev, next;
+    Uint16 generation;
+    int eventType;
+    void *data;
+    std::function<void()> callback; // Empty for event timers
+  };
+
+  // Timers of a slot form a doubly linked list through the pool, so cancel
+  // unlinks in constant time. Freed nodes are reused before the pool grows
+  std::vector<Node> nodes;
+  std::vector<int> freeNodes;
+  int heads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+
+  std::vector<TimerEvent> events;
+  size_t eventsRead = 0;
+
+  Uint32 now = 0;
+  int pendingCount = 0;
+
+  int allocate(Uint32 delay);
+  TimerId idOf(int index) const;
+  int find(TimerId id) const;
+  void insert(int index);
+  void unlink(int index);
+  void release(int index);
+  void cascade(int level);
+};
+
+TimerWheel::TimerWheel() {
+  for (int &head : heads)
+    head = -1;
+}
+
+TimerId TimerWheel::schedule(Uint32 delay, std::function<void()> callback) {
+  int index = allocate(delay);
+  nodes[index].callback = std::move(callback);
+  return idOf(index);
+}
+
+TimerId TimerWheel::scheduleEvent(Uint32 delay, int type, void *data) {
+  int index = allocate(delay);
+  nodes[index].eventType = type;
+  nodes[index].data = data;
+  return idOf(index);
+}
+
+void TimerWheel::cancel(TimerId id) {
+  int index = find(id);
+  if (index < 0)
+    return;
+  unlink(index);
+  release(index);
+}
+
+bool TimerWheel::isPending(TimerId id) const { return find(id) >= 0; }
+
+Uint32 TimerWheel::getRemaining(TimerId id) const {
+  int index = find(id);
+  return index < 0 ? 0 : nodes[index].expiry - now;
+}
+
+void TimerWheel::advance() {
+  now++;
+
+  // Higher levels first, what they spread out may land in the slot of the
+  // level below that is about to be spread out too
+  int level = 1;
+  while (level < TIMER_WHEEL_LEVELS && (now & ((1u << (TIMER_WHEEL_BITS * level)) - 1)) == 0)
+    level++;
+  for (level--; level > 0; level--)
+    cascade(level);
+
+  // Pop one at a time, a callback may cancel the next timer in the slot
+  int *head = &heads[now & TIMER_WHEEL_MASK];
+  while (*head >= 0) {
+    int index = *head;
+    unlink(index);
+    Node &node = nodes[index];
+    if (node.callback) {
+      std::function<void()> callback = std::move(node.callback);
+      release(index);
+      callback();
+    } else {
+      events.push_back({node.eventType, node.data, idOf(index)});
+      release(index);
+    }
+  }
+}
+
+bool TimerWheel::pollEvent(TimerEvent *event) {
+  if (eventsRead == events.size()) {
+    events.clear();
+    eventsRead = 0;
+    return false;
+  }
+  *event = events[eventsRead++];
+  return true;
+}
+
+void TimerWheel::clear() {
+  for (size_t i = 0; i < nodes.size(); i++) {
+    if (nodes[i].slot >= 0) {
+      unlink((int)i);
+      release((int)i);
+    }
+  }
+  events.clear();
+  eventsRead = 0;
+}
+
+int TimerWheel::allocate(Uint32 delay) {
+  int index;
+  if (!freeNodes.empty()) {
+    index = freeNodes.back();
+    freeNodes.pop_back();
+  } else {
+    index = (int)nodes.size();
+    nodes.push_back(Node());
+    nodes[index].generation = 0;
+    // Room for every node, release then never allocates mid-game
+    freeNodes.reserve(nodes.capacity());
+  }
+
+  Node &node = nodes[index];
+  node.expiry = now + SDL_clamp(delay, 1u, TIMER_MAX_DELAY);
+  node.eventType = 0;
+  node.data = nullptr;
+  insert(index);
+  pendingCount++;
+  return index;
+}
+
+TimerId TimerWheel::idOf(int index) const {
+  return (TimerId)nodes[index].generation << TIMER_GENERATION_SHIFT | (TimerId)index;
+}
+
+int TimerWheel::find(TimerId id) const {
+  if (id == TIMER_NONE)
+    return -1;
+  int index = id & TIMER_INDEX_MASK;
+  if (index >= (int)nodes.size() || nodes[index].slot < 0 ||
+      nodes[index].generation != (Uint16)(id >> TIMER_GENERATION_SHIFT))
+    return -1;
+  return index;
+}
+
+void TimerWheel::insert(int index) {
+  Node &node = nodes[index];
+  Uint32 delta = node.expiry - now;
+
+  // Lowest level whose span covers the delay, the slot is the expiry's digit
+  // at that level. Due timers (delta 0, while cascading) land in the slot
+  // advance fires next
+  int level = 0;
+  while (level < TIMER_WHEEL_LEVELS - 1 && delta >> (TIMER_WHEEL_BITS * (level + 1)) != 0)
+    level++;
+  int slot = level * TIMER_WHEEL_SLOTS + ((node.expiry >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+
+  node.slot = slot;
+  node.prev = -1;
+  node.next = heads[slot];
+  if (node.next >= 0)
+    nodes[node.next].prev = index;
+  heads[slot] = index;
+}
+
+void TimerWheel::unlink(int index) {
+  Node &node = nodes[index];
+  if (node.prev >= 0)
+    nodes[node.prev].next = node.next;
+  else
+    heads[node.slot] = node.next;
+  if (node.next >= 0)
+    nodes[node.next].prev = node.prev;
+}
+
+void TimerWheel::release(int index) {
+  Node &node = nodes[index];
+  node.slot = -1;
+  node.generation++;
+  node.callback = nullptr;
+  freeNodes.push_back(index);
+  pendingCount--;
+}
+
+void TimerWheel::cascade(int level) {
+  int slot = level * TIMER_WHEEL_SLOTS + ((now >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+  int index = heads[slot];
+  heads[slot] = -1;
+  while (index >= 0) {
+    int next = nodes[index].next;
+    insert(index);
+    index = next;
+  }
+}
+
+// Code created by Mouttaki Omar(王明清)
@@ -0,0 +1,280 @@
+#include "alloctracker.hpp"
+#include "profiler.h"
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <new>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Allocations of the main thread, keyed by zone and caller
+struct AllocationSite
+{
+    const char *zone; // NULL outside any zone
+    void *caller;     // NULL for SDL_malloc, whose caller is SDL itself
+    Uint64 allocations;
+    Uint64 bytes;
+    Uint64 frame; // Last frame the site allocated in
+    Uint64 frameAllocations;
+    Uint64 frameBytes;
+};
+
+static std::atomic<Uint64> totalAllocations(0);
+static std::atomic<Uint64> totalBytes(0);
+static std::atomic<Uint64> totalFrees(0);
+
+// Set by install. Everything below it is touched by the main thread only
+static thread_local bool mainThread = false;
+// Open AllowAllocations scopes of the thread
+static thread_local int allowDepth = 0;
+static Uint64 mainAllocations = 0;
+static Uint64 mainBytes = 0;
+static Uint64 mainAllowed = 0;
+static Uint64 currentFrame = 0;
+static AllocationSite sites[ALLOC_SITE_CAPACITY];
+
+static SDL_malloc_func sdlMalloc = nullptr;
+static SDL_calloc_func sdlCalloc = nullptr;
+static SDL_realloc_func sdlRealloc = nullptr;
+static SDL_free_func sdlFree = nullptr;
+
+// Runs inside every allocation, so it must not allocate itself
+static void countAllocation(size_t size, void *caller)
+{
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(size, std::memory_order_relaxed);
+    if (!mainThread)
+        return;
+    mainAllocations++;
+    mainBytes += size;
+    if (allowDepth > 0)
+        mainAllowed++;
+
+    // Open addressing, a full table still counts in the totals above
+    const char *zone = profilerCurrentZone();
+    size_t hash = ((uintptr_t)caller >> 2) ^ ((uintptr_t)zone >> 3) * 31;
+    for (int probe = 0; probe < ALLOC_SITE_CAPACITY; probe++)
+    {
+        AllocationSite &site = sites[(hash + probe) % ALLOC_SITE_CAPACITY];
+        if (site.allocations == 0)
+        {
+            site.zone = zone;
+            site.caller = caller;
+        }
+        else if (site.zone != zone || site.caller != caller)
+        {
+            continue;
+        }
+        if (site.frame != currentFrame)
+        {
+            site.frame = currentFrame;
+            site.frameAllocations = 0;
+            site.frameBytes = 0;
+        }
+        site.allocations++;
+        site.bytes += size;
+        site.frameAllocations++;
+        site.frameBytes += size;
+        return;
+    }
+}
+
+static void *allocate(size_t size, void *caller)
+{
+    void *pointer = malloc(size != 0 ? size : 1);
+    if (pointer != nullptr)
+        countAllocation(size, caller);
+    return pointer;
+}
+
+static void release(void *pointer)
+{
+    if (pointer == nullptr)
+        return;
+    totalFrees.fetch_add(1, std::memory_order_relaxed);
+    free(pointer);
+}
+
+static void *SDLCALL trackedMalloc(size_t size)
+{
+    void *pointer = sdlMalloc(size);
+    if (pointer != nullptr)
+        countAllocation(size, nullptr);
+    return pointer;
+}
+
+static void *SDLCALL trackedCalloc(size_t count, size_t size)
+{
+    void *pointer = sdlCalloc(count, size);
+    if (pointer != nullptr)
+        countAllocation(count * size, nullptr);
+    return pointer;
+}
+
+static void *SDLCALL trackedRealloc(void *memory, size_t size)
+{
+    void *pointer = sdlRealloc(memory, size);
+    if (pointer != nullptr)
+        countAllocation(size, nullptr);
+    return pointer;
+}
+
+static void SDLCALL trackedFree(void *memory)
+{
+    if (memory != nullptr)
+        totalFrees.fetch_add(1, std::memory_order_relaxed);
+    sdlFree(memory);
+}
+
+void *operator new(size_t size)
+{
+    void *pointer = allocate(size, __builtin_return_address(0));
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void *operator new[](size_t size)
+{
+    void *pointer = allocate(size, __builtin_return_address(0));
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size, __builtin_return_address(0));
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size, __builtin_return_address(0));
+}
+
+void operator delete(void *pointer) noexcept { release(pointer); }
+void operator delete[](void *pointer) noexcept { release(pointer); }
+void operator delete(void *pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { release(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { release(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { release(pointer); }
+
+// Logs the count busiest sites, of the current frame only if frameOnly
+static void logSiteList(int count, bool frameOnly)
+{
+    int order[ALLOC_SITE_CAPACITY];
+    int used = 0;
+    for (int i = 0; i < ALLOC_SITE_CAPACITY; i++)
+    {
+        if (sites[i].allocations != 0 && (!frameOnly || sites[i].frame == currentFrame))
+            order[used++] = i;
+    }
+
+    // Partial selection sort, the table is small and this must not allocate
+    count = SDL_min(count, used);
+    for (int i = 0; i < count; i++)
+    {
+        int best = i;
+        for (int j = i + 1; j < used; j++)
+        {
+            Uint64 a = frameOnly ? sites[order[j]].frameAllocations : sites[order[j]].allocations;
+            Uint64 b = frameOnly ? sites[order[best]].frameAllocations : sites[order[best]].allocations;
+            if (a > b)
+                best = j;
+        }
+        int swap = order[i];
+        order[i] = order[best];
+        order[best] = swap;
+
+        const AllocationSite &site = sites[order[i]];
+        char caller[32];
+        if (site.caller != nullptr)
+            snprintf(caller, sizeof(caller), "%p", site.caller);
+        else
+            snprintf(caller, sizeof(caller), "SDL_malloc");
+        SDL_Log("  %8" SDL_PRIu64 " allocations %10" SDL_PRIu64 " bytes  %s in %s",
+                frameOnly ? site.frameAllocations : site.allocations, frameOnly ? site.frameBytes : site.bytes, caller,
+                site.zone != nullptr ? site.zone : "(no zone)");
+    }
+}
+
+void AllocationTracker::install()
+{
+    mainThread = true;
+    // Twice would chain the hooks to themselves
+    if (sdlMalloc != nullptr)
+        return;
+    SDL_GetMemoryFunctions(&sdlMalloc, &sdlCalloc, &sdlRealloc, &sdlFree);
+    if (SDL_SetMemoryFunctions(trackedMalloc, trackedCalloc, trackedRealloc, trackedFree) < 0)
+        SDL_Log("AllocationTracker: Could not hook SDL_malloc: %s", SDL_GetError());
+}
+
+void AllocationTracker::beginFrame()
+{
+    currentFrame++;
+    frameStart.allocations = mainAllocations;
+    frameStart.bytes = mainBytes;
+    frameStart.allowed = mainAllowed;
+}
+
+void AllocationTracker::endFrame(bool steadyState)
+{
+    frame.allocations = mainAllocations - frameStart.allocations;
+    frame.bytes = mainBytes - frameStart.bytes;
+    frame.allowed = mainAllowed - frameStart.allowed;
+    PROFILER.recordCounter("allocations", (double)frame.allocations);
+    PROFILER.recordCounter("allocated bytes", (double)frame.bytes);
+
+    steadyFrames = steadyState ? steadyFrames + 1 : 0;
+    if (!testMode || steadyFrames <= warmupFrames || frame.allocations == frame.allowed)
+        return;
+
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                 "AllocationTracker: Steady-state frame allocated %" SDL_PRIu64 " times (%" SDL_PRIu64
+                 " allowed), %" SDL_PRIu64 " bytes:",
+                 frame.allocations, frame.allowed, frame.bytes);
+    logSiteList(ALLOC_SITE_CAPACITY, true);
+    exit(1);
+}
+
+AllocationStats AllocationTracker::getTotals() const
+{
+    return {totalAllocations.load(std::memory_order_relaxed), totalBytes.load(std::memory_order_relaxed), 0};
+}
+
+Uint64 AllocationTracker::getFrees() const
+{
+    return totalFrees.load(std::memory_order_relaxed);
+}
+
+void AllocationTracker::setTestMode(bool enabled, int warmupFrames)
+{
+    testMode = enabled;
+    this->warmupFrames = warmupFrames;
+    steadyFrames = 0;
+}
+
+void AllocationTracker::logSites(int count) const
+{
+    AllocationStats totals = getTotals();
+    SDL_Log("AllocationTracker: %" SDL_PRIu64 " allocations, %" SDL_PRIu64 " bytes, %" SDL_PRIu64
+            " frees on all threads. Main thread sites:",
+            totals.allocations, totals.bytes, getFrees());
+    logSiteList(count, false);
+}
+
+void AllocationTracker::resetSites()
+{
+    memset(sites, 0, sizeof(sites));
+}
+
+AllowAllocations::AllowAllocations()
+{
+    allowDepth++;
+}
+
+AllowAllocations::~AllowAllocations()
+{
+    allowDepth--;
+}
@@ -0,0 +1,193 @@
+#include "assetpack.hpp"
+#include "lz4block.hpp"
+#include "profiler.h"
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Maps the whole file read-only, mapping receives what unmapFile needs
+static const Uint8 *mapFile(const char *path, size_t &size, void *&mapping)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+    // The mapping keeps the file open on its own
+    HANDLE fileMapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (fileMapping == NULL)
+        return nullptr;
+    void *view = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL)
+    {
+        CloseHandle(fileMapping);
+        return nullptr;
+    }
+    size = (size_t)fileSize.QuadPart;
+    mapping = fileMapping;
+    return (const Uint8 *)view;
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    // The mapping keeps the file open on its own
+    void *view = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED)
+        return nullptr;
+    size = (size_t)info.st_size;
+    mapping = nullptr;
+    return (const Uint8 *)view;
+#endif
+}
+
+static void unmapFile(const Uint8 *data, size_t size, void *mapping)
+{
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE)mapping);
+#else
+    (void)mapping;
+    munmap((void *)data, size);
+#endif
+}
+
+bool AssetPack::open(const char *path, SDL_Renderer *renderer)
+{
+    close();
+    data = mapFile(path, size, mapping);
+    if (data == nullptr)
+    {
+        SDL_Log("AssetPack: %s not found, loading images from disk", path);
+        return false;
+    }
+
+    header = (const AssetPackHeader *)data;
+    entries = (const AssetPackEntry *)(data + sizeof(AssetPackHeader));
+    bool valid = size >= sizeof(AssetPackHeader) &&
+                 header->magic == ASSET_PACK_MAGIC &&
+                 header->version == ASSET_PACK_VERSION &&
+                 SDL_BYTESPERPIXEL(header->pixelFormat) == 4 &&
+                 size >= sizeof(AssetPackHeader) + (size_t)header->entryCount * sizeof(AssetPackEntry);
+    for (Uint32 i = 0; valid && i < header->entryCount; i++)
+    {
+        const AssetPackEntry &entry = entries[i];
+        valid = entry.name[ASSET_PACK_NAME_SIZE - 1] == '\0' &&
+                (size_t)entry.offset + entry.compressedSize <= size;
+    }
+    if (!valid)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "AssetPack: %s is not a version %d pack, rebuild it with make pack",
+                     path, ASSET_PACK_VERSION);
+        close();
+        return false;
+    }
+
+    // Pixels in another format would be converted on every upload
+    SDL_RendererInfo info;
+    if (renderer != nullptr && SDL_GetRendererInfo(renderer, &info) == 0)
+    {
+        bool native = false;
+        for (Uint32 i = 0; i < info.num_texture_formats; i++)
+        {
+            native = native || info.texture_formats[i] == header->pixelFormat;
+        }
+        if (!native)
+        {
+            SDL_Log("AssetPack: %s is not native to the %s renderer, textures will be converted",
+                    SDL_GetPixelFormatName(header->pixelFormat), info.name);
+        }
+    }
+
+    SDL_Log("AssetPack: Mapped %s, %u images in %u KB", path, header->entryCount,
+            (unsigned)(size / 1024));
+    return true;
+}
+
+void AssetPack::close()
+{
+    if (data != nullptr)
+    {
+        unmapFile(data, size, mapping);
+    }
+    data = nullptr;
+    size = 0;
+    mapping = nullptr;
+    header = nullptr;
+    entries = nullptr;
+    std::vector<Uint8>().swap(pixels);
+}
+
+const AssetPackEntry *AssetPack::find(const char *name, int targetWidth) const
+{
+    if (data == nullptr)
+        return nullptr;
+
+    // First entry with this name
+    int low = 0;
+    int high = (int)header->entryCount;
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+        if (strncmp(entries[middle].name, name, ASSET_PACK_NAME_SIZE) < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    // Variants follow in increasing width
+    const AssetPackEntry *best = nullptr;
+    for (int i = low; i < (int)header->entryCount && strncmp(entries[i].name, name, ASSET_PACK_NAME_SIZE) == 0; i++)
+    {
+        best = entries + i;
+        if ((int)best->width >= targetWidth)
+            break;
+    }
+    return best;
+}
+
+SDL_Texture *AssetPack::createTexture(SDL_Renderer *renderer, const AssetPackEntry *entry)
+{
+    PROFILE_ZONE("AssetPack::createTexture");
+    int pitch = (int)entry->width * 4;
+    int rawSize = pitch * (int)entry->height;
+    if (pixels.size() < (size_t)rawSize)
+        pixels.resize(rawSize);
+
+    int decoded = lz4Decompress(data + entry->offset, (int)entry->compressedSize, pixels.data(), rawSize);
+    if (decoded != rawSize)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "AssetPack: %s is corrupt", entry->name);
+        return nullptr;
+    }
+
+    SDL_Texture *texture = SDL_CreateTexture(renderer, header->pixelFormat, SDL_TEXTUREACCESS_STATIC,
+                                             (int)entry->width, (int)entry->height);
+    if (texture == nullptr)
+        return nullptr;
+    SDL_UpdateTexture(texture, nullptr, pixels.data(), pitch);
+    SDL_SetTextureBlendMode(texture, (entry->flags & ASSET_PACK_ALPHA) ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+    return texture;
+}
@@ -26,6 +26,7 @@
 b2BroadPhase::b2BroadPhase()
 {
 	m_proxyCount = 0;
+	m_staticTreeDirty = false;
 
 	m_pairCapacity = 16;
 	m_pairCount = 0;
@@ -42,9 +43,11 @@ b2BroadPhase::~b2BroadPhase()
 	b2Free(m_pairBuffer);
 }
 
-int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData)
+int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData, bool staticProxy)
 {
-	int32 proxyId = m_tree.CreateProxy(aabb, userData);
+	b2DynamicTree& tree = staticProxy ? m_staticTree : m_dynamicTree;
+	int32 proxyId = EncodeProxyId(tree.CreateProxy(aabb, userData), staticProxy);
+	m_staticTreeDirty = m_staticTreeDirty || staticProxy;
 	++m_proxyCount;
 	BufferMove(proxyId);
 	return proxyId;
@@ -54,14 +57,16 @@ void b2BroadPhase::DestroyProxy(int32 proxyId)
 {
 	UnBufferMove(proxyId);
 	--m_proxyCount;
-	m_tree.DestroyProxy(proxyId);
+	GetTree(proxyId).DestroyProxy(GetNodeId(proxyId));
+	m_staticTreeDirty = m_staticTreeDirty || IsStaticProxy(proxyId);
 }
 
 void b2BroadPhase::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
 {
-	bool buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
+	bool buffer = GetTree(proxyId).MoveProxy(GetNodeId(proxyId), aabb, displacement);
 	if (buffer)
 	{
+		m_staticTreeDirty = m_staticTreeDirty || IsStaticProxy(proxyId);
 		BufferMove(proxyId);
 	}
 }
@@ -106,7 +111,7 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 		return true;
 	}
 
-	const bool moved = m_tree.WasMoved(proxyId);
+	const bool moved = GetTree(proxyId).WasMoved(GetNodeId(proxyId));
 	if (moved && proxyId > m_queryProxyId)
 	{
 		// Both proxies are moving. Avoid duplicate pairs.
@@ -20,6 +20,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 #include "box2d/b2_dynamic_tree.h"
+#include "box2d/b2_simd.h"
 #include <string.h>
 
 b2DynamicTree::b2DynamicTree()
@@ -714,6 +715,146 @@ int32 b2DynamicTree::GetMaxBalance() const
 	return maxBalance;
 }
 
+// Number of centroid bins tested per split.
+#define b2_sahBinCount 16
+
+// Top-down binned SAH split of the leaves, the node is built once both halves are.
+int32 b2DynamicTree::BuildSAH(int32* leaves, int32 count)
+{
+	if (count == 1)
+	{
+		return leaves[0];
+	}
+
+	// Split along the longest axis of the leaf centers.
+	b2Vec2 lower = m_nodes[leaves[0]].aabb.GetCenter();
+	b2Vec2 upper = lower;
+	for (int32 i = 1; i < count; ++i)
+	{
+		b2Vec2 c = m_nodes[leaves[i]].aabb.GetCenter();
+		lower = b2Min(lower, c);
+		upper = b2Max(upper, c);
+	}
+
+	b2Vec2 extent = upper - lower;
+	int32 axis = extent.x >= extent.y ? 0 : 1;
+	float minValue = axis == 0 ? lower.x : lower.y;
+	float width = axis == 0 ? extent.x : extent.y;
+
+	int32 leftCount = count / 2;
+	if (width > 0.0f)
+	{
+		b2AABB binAABBs[b2_sahBinCount];
+		int32 binCounts[b2_sahBinCount] = { 0 };
+		float scale = b2_sahBinCount / width;
+
+		for (int32 i = 0; i < count; ++i)
+		{
+			const b2AABB& aabb = m_nodes[leaves[i]].aabb;
+			b2Vec2 c = aabb.GetCenter();
+			int32 bin = b2Min(int32(((axis == 0 ? c.x : c.y) - minValue) * scale), b2_sahBinCount - 1);
+			if (binCounts[bin] == 0)
+			{
+				binAABBs[bin] = aabb;
+			}
+			else
+			{
+				binAABBs[bin].Combine(aabb);
+			}
+			++binCounts[bin];
+		}
+
+		// Sweep from the right to get the cost of every right side.
+		float rightCosts[b2_sahBinCount];
+		b2AABB rightAABB;
+		int32 rightCount = 0;
+		for (int32 i = b2_sahBinCount - 1; i > 0; --i)
+		{
+			if (binCounts[i] > 0)
+			{
+				if (rightCount == 0)
+				{
+					rightAABB = binAABBs[i];
+				}
+				else
+				{
+					rightAABB.Combine(binAABBs[i]);
+				}
+				rightCount += binCounts[i];
+			}
+			rightCosts[i] = rightCount > 0 ? rightCount * rightAABB.GetPerimeter() : 0.0f;
+		}
+
+		// Sweep from the left and keep the cheapest split with leaves on both sides.
+		float minCost = b2_maxFloat;
+		int32 splitBin = -1;
+		b2AABB leftAABB = m_nodes[leaves[0]].aabb;
+		int32 sweepCount = 0;
+		for (int32 i = 0; i < b2_sahBinCount - 1; ++i)
+		{
+			if (binCounts[i] > 0)
+			{
+				if (sweepCount == 0)
+				{
+					leftAABB = binAABBs[i];
+				}
+				else
+				{
+					leftAABB.Combine(binAABBs[i]);
+				}
+				sweepCount += binCounts[i];
+			}
+
+			if (sweepCount == 0 || sweepCount == count)
+			{
+				continue;
+			}
+
+			float cost = sweepCount * leftAABB.GetPerimeter() + rightCosts[i + 1];
+			if (cost < minCost)
+			{
+				minCost = cost;
+				splitBin = i;
+			}
+		}
+
+		if (splitBin != -1)
+		{
+			// Partition in place, leaves in bins up to the split go left.
+			int32 left = 0;
+			for (int32 i = 0; i < count; ++i)
+			{
+				b2Vec2 c = m_nodes[leaves[i]].aabb.GetCenter();
+				int32 bin = b2Min(int32(((axis == 0 ? c.x : c.y) - minValue) * scale), b2_sahBinCount - 1);
+				if (bin <= splitBin)
+				{
+					b2Swap(leaves[i], leaves[left]);
+					++left;
+				}
+			}
+
+			leftCount = left;
+		}
+	}
+
+	int32 child1 = BuildSAH(leaves, leftCount);
+	int32 child2 = BuildSAH(leaves + leftCount, count - leftCount);
+
+	int32 parentIndex = AllocateNode();
+	b2TreeNode* parent = m_nodes + parentIndex;
+	parent->child1 = child1;
+	parent->child2 = child2;
+	parent->height = 1 + b2Max(m_nodes[child1].height, m_nodes[child2].height);
+	parent->aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+	parent->parent = b2_nullNode;
+	parent->userData = nullptr;
+
+	m_nodes[child1].parent = parentIndex;
+	m_nodes[child2].parent = parentIndex;
+
+	return parentIndex;
+}
+
 void b2DynamicTree::RebuildBottomUp()
 {
 	int32* nodes = (int32*)b2Alloc(m_nodeCount * sizeof(int32));
@@ -740,62 +881,120 @@ void b2DynamicTree::RebuildBottomUp()
 		}
 	}
 
-	while (count > 1)
+	m_root = count > 0 ? BuildSAH(nodes, count) : b2_nullNode;
+	b2Free(nodes);
+
+	Validate();
+}
+
+void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
+{
+	// Build array of leaves. Free the rest.
+	for (int32 i = 0; i < m_nodeCapacity; ++i)
 	{
-		float minCost = b2_maxFloat;
-		int32 iMin = -1, jMin = -1;
-		for (int32 i = 0; i < count; ++i)
-		{
-			b2AABB aabbi = m_nodes[nodes[i]].aabb;
+		m_nodes[i].aabb.lowerBound -= newOrigin;
+		m_nodes[i].aabb.upperBound -= newOrigin;
+	}
+}
 
-			for (int32 j = i + 1; j < count; ++j)
-			{
-				b2AABB aabbj = m_nodes[nodes[j]].aabb;
-				b2AABB b;
-				b.Combine(aabbi, aabbj);
-				float cost = b.GetPerimeter();
-				if (cost < minCost)
-				{
-					iMin = i;
-					jMin = j;
-					minCost = cost;
-				}
-			}
+b2RayPacket::b2RayPacket()
+{
+	// Unused lanes are still loaded by the wide tests.
+	memset(this, 0, sizeof(b2RayPacket));
+}
+
+void b2RayPacket::Add(const b2RayCastInput& input)
+{
+	b2Assert(count < b2_packetSize);
+
+	b2Vec2 d = input.p2 - input.p1;
+	b2Assert(d.LengthSquared() > 0.0f);
+
+	// Axis aligned rays get a huge inverse instead of infinity to keep 0 * inv finite.
+	originX[count] = input.p1.x;
+	originY[count] = input.p1.y;
+	invDirectionX[count] = d.x != 0.0f ? 1.0f / d.x : b2_maxFloat;
+	invDirectionY[count] = d.y != 0.0f ? 1.0f / d.y : b2_maxFloat;
+	maxFraction[count] = input.maxFraction;
+	++count;
+}
+
+uint32 b2RayPacket::TestOverlap(const b2AABB& aabb, uint32 mask) const
+{
+	b2FloatW lowerX = b2SplatW(aabb.lowerBound.x);
+	b2FloatW lowerY = b2SplatW(aabb.lowerBound.y);
+	b2FloatW upperX = b2SplatW(aabb.upperBound.x);
+	b2FloatW upperY = b2SplatW(aabb.upperBound.y);
+	b2FloatW zero = b2SplatW(0.0f);
+
+	uint32 result = 0;
+	for (int32 i = 0; i < count; i += B2_SIMD_WIDTH)
+	{
+		uint32 laneMask = (mask >> i) & ((1u << B2_SIMD_WIDTH) - 1);
+		if (laneMask == 0)
+		{
+			continue;
 		}
 
-		int32 index1 = nodes[iMin];
-		int32 index2 = nodes[jMin];
-		b2TreeNode* child1 = m_nodes + index1;
-		b2TreeNode* child2 = m_nodes + index2;
+		b2FloatW ox = b2LoadW(originX + i);
+		b2FloatW oy = b2LoadW(originY + i);
+		b2FloatW ix = b2LoadW(invDirectionX + i);
+		b2FloatW iy = b2LoadW(invDirectionY + i);
 
-		int32 parentIndex = AllocateNode();
-		b2TreeNode* parent = m_nodes + parentIndex;
-		parent->child1 = index1;
-		parent->child2 = index2;
-		parent->height = 1 + b2Max(child1->height, child2->height);
-		parent->aabb.Combine(child1->aabb, child2->aabb);
-		parent->parent = b2_nullNode;
+		// Slab test, the ray parameter is the fraction along p2 - p1.
+		b2FloatW tx1 = b2MulW(b2SubW(lowerX, ox), ix);
+		b2FloatW tx2 = b2MulW(b2SubW(upperX, ox), ix);
+		b2FloatW ty1 = b2MulW(b2SubW(lowerY, oy), iy);
+		b2FloatW ty2 = b2MulW(b2SubW(upperY, oy), iy);
 
-		child1->parent = parentIndex;
-		child2->parent = parentIndex;
+		b2FloatW tmin = b2MaxW(b2MaxW(b2MinW(tx1, tx2), b2MinW(ty1, ty2)), zero);
+		b2FloatW tmax = b2MinW(b2MinW(b2MaxW(tx1, tx2), b2MaxW(ty1, ty2)), b2LoadW(maxFraction + i));
 
-		nodes[jMin] = nodes[count-1];
-		nodes[iMin] = parentIndex;
-		--count;
+		result |= (uint32(b2MaskBitsW(b2GreaterEqualW(tmax, tmin))) & laneMask) << i;
 	}
 
-	m_root = nodes[0];
-	b2Free(nodes);
+	return result;
+}
 
-	Validate();
+b2AABBPacket::b2AABBPacket()
+{
+	// Unused lanes are still loaded by the wide tests.
+	memset(this, 0, sizeof(b2AABBPacket));
 }
 
-void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
+void b2AABBPacket::Add(const b2AABB& aabb)
 {
-	// Build array of leaves. Free the rest.
-	for (int32 i = 0; i < m_nodeCapacity; ++i)
+	b2Assert(count < b2_packetSize);
+
+	lowerX[count] = aabb.lowerBound.x;
+	lowerY[count] = aabb.lowerBound.y;
+	upperX[count] = aabb.upperBound.x;
+	upperY[count] = aabb.upperBound.y;
+	++count;
+}
+
+uint32 b2AABBPacket::TestOverlap(const b2AABB& aabb, uint32 mask) const
+{
+	b2FloatW nodeLowerX = b2SplatW(aabb.lowerBound.x);
+	b2FloatW nodeLowerY = b2SplatW(aabb.lowerBound.y);
+	b2FloatW nodeUpperX = b2SplatW(aabb.upperBound.x);
+	b2FloatW nodeUpperY = b2SplatW(aabb.upperBound.y);
+
+	uint32 result = 0;
+	for (int32 i = 0; i < count; i += B2_SIMD_WIDTH)
 	{
-		m_nodes[i].aabb.lowerBound -= newOrigin;
-		m_nodes[i].aabb.upperBound -= newOrigin;
+		uint32 laneMask = (mask >> i) & ((1u << B2_SIMD_WIDTH) - 1);
+		if (laneMask == 0)
+		{
+			continue;
+		}
+
+		// Same as b2TestOverlap, for every lane.
+		b2FloatW overlapX = b2AndW(b2GreaterEqualW(nodeUpperX, b2LoadW(lowerX + i)), b2GreaterEqualW(b2LoadW(upperX + i), nodeLowerX));
+		b2FloatW overlapY = b2AndW(b2GreaterEqualW(nodeUpperY, b2LoadW(lowerY + i)), b2GreaterEqualW(b2LoadW(upperY + i), nodeLowerY));
+
+		result |= (uint32(b2MaskBitsW(b2AndW(overlapX, overlapY))) & laneMask) << i;
 	}
+
+	return result;
 }
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "box2d/b2_block_allocator.h"
+#include "box2d/b2_math.h"
 #include <limits.h>
 #include <string.h>
 #include <stddef.h>
@@ -96,6 +97,13 @@ b2BlockAllocator::b2BlockAllocator()
 	
 	memset(m_chunks, 0, m_chunkSpace * sizeof(b2Chunk));
 	memset(m_freeLists, 0, sizeof(m_freeLists));
+
+	memset(m_liveCounts, 0, sizeof(m_liveCounts));
+	memset(m_maxLiveCounts, 0, sizeof(m_maxLiveCounts));
+	m_liveBytes = 0;
+	m_maxLiveBytes = 0;
+	m_largeLiveCount = 0;
+	m_largeAllocationCount = 0;
 }
 
 b2BlockAllocator::~b2BlockAllocator()
@@ -119,12 +127,19 @@ void* b2BlockAllocator::Allocate(int32 size)
 
 	if (size > b2_maxBlockSize)
 	{
+		++m_largeLiveCount;
+		++m_largeAllocationCount;
 		return b2Alloc(size);
 	}
 
 	int32 index = b2_sizeMap.values[size];
 	b2Assert(0 <= index && index < b2_blockSizeCount);
 
+	m_liveCounts[index] += 1;
+	m_maxLiveCounts[index] = b2Max(m_maxLiveCounts[index], m_liveCounts[index]);
+	m_liveBytes += b2_blockSizes[index];
+	m_maxLiveBytes = b2Max(m_maxLiveBytes, m_liveBytes);
+
 	if (m_freeLists[index])
 	{
 		b2Block* block = m_freeLists[index];
@@ -179,6 +194,7 @@ void b2BlockAllocator::Free(void* p, int32 size)
 
 	if (size > b2_maxBlockSize)
 	{
+		--m_largeLiveCount;
 		b2Free(p);
 		return;
 	}
@@ -186,6 +202,9 @@ void b2BlockAllocator::Free(void* p, int32 size)
 	int32 index = b2_sizeMap.values[size];
 	b2Assert(0 <= index && index < b2_blockSizeCount);
 
+	m_liveCounts[index] -= 1;
+	m_liveBytes -= b2_blockSizes[index];
+
 #if defined(_DEBUG)
 	// Verify the memory address and size is valid.
 	int32 blockSize = b2_blockSizes[index];
@@ -227,4 +246,22 @@ void b2BlockAllocator::Clear()
 	m_chunkCount = 0;
 	memset(m_chunks, 0, m_chunkSpace * sizeof(b2Chunk));
 	memset(m_freeLists, 0, sizeof(m_freeLists));
+
+	memset(m_liveCounts, 0, sizeof(m_liveCounts));
+	m_liveBytes = 0;
+}
+
+b2BlockAllocatorStats b2BlockAllocator::GetStats() const
+{
+	b2BlockAllocatorStats stats;
+	stats.chunkCount = m_chunkCount;
+	stats.chunkSize = b2_chunkSize;
+	memcpy(stats.blockSizes, b2_blockSizes, sizeof(stats.blockSizes));
+	memcpy(stats.liveCounts, m_liveCounts, sizeof(stats.liveCounts));
+	memcpy(stats.maxLiveCounts, m_maxLiveCounts, sizeof(stats.maxLiveCounts));
+	stats.liveBytes = m_liveBytes;
+	stats.maxLiveBytes = m_maxLiveBytes;
+	stats.largeLiveCount = m_largeLiveCount;
+	stats.largeAllocationCount = m_largeAllocationCount;
+	return stats;
 }
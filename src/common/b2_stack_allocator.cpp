@@ -25,7 +25,13 @@
 
 b2StackAllocator::b2StackAllocator()
 {
-	m_index = 0;
+	m_segments[0].data = (char*)b2Alloc(b2_stackSize);
+	m_segments[0].size = b2_stackSize;
+	m_segments[0].index = 0;
+	m_segmentCount = 1;
+	m_segmentIndex = 0;
+	m_growCount = 0;
+	m_heapFallbackCount = 0;
 	m_allocation = 0;
 	m_maxAllocation = 0;
 	m_entryCount = 0;
@@ -33,26 +39,53 @@ b2StackAllocator::b2StackAllocator()
 
 b2StackAllocator::~b2StackAllocator()
 {
-	b2Assert(m_index == 0);
+	b2Assert(m_allocation == 0);
 	b2Assert(m_entryCount == 0);
+
+	for (int32 i = 0; i < m_segmentCount; ++i)
+	{
+		b2Free(m_segments[i].data);
+	}
 }
 
 void* b2StackAllocator::Allocate(int32 size)
 {
 	b2Assert(m_entryCount < b2_maxStackEntries);
 
+	// Segments past the current one are always empty.
+	int32 index = m_segmentIndex;
+	while (index < m_segmentCount && m_segments[index].index + size > m_segments[index].size)
+	{
+		++index;
+	}
+
+	if (index == m_segmentCount && m_segmentCount < b2_maxStackSegments)
+	{
+		b2StackSegment* segment = m_segments + m_segmentCount;
+		segment->size = b2Max(2 * m_segments[m_segmentCount - 1].size, size);
+		segment->data = (char*)b2Alloc(segment->size);
+		segment->index = 0;
+		++m_segmentCount;
+		++m_growCount;
+	}
+
 	b2StackEntry* entry = m_entries + m_entryCount;
 	entry->size = size;
-	if (m_index + size > b2_stackSize)
+	if (index == m_segmentCount)
 	{
 		entry->data = (char*)b2Alloc(size);
+		entry->segment = -1;
 		entry->usedMalloc = true;
+		++m_heapFallbackCount;
 	}
 	else
 	{
-		entry->data = m_data + m_index;
+		b2StackSegment* segment = m_segments + index;
+		entry->data = segment->data + segment->index;
+		entry->segment = index;
 		entry->usedMalloc = false;
-		m_index += size;
+		segment->index += size;
+		m_segmentIndex = index;
 	}
 
 	m_allocation += size;
@@ -73,7 +106,14 @@ void b2StackAllocator::Free(void* p)
 	}
 	else
 	{
-		m_index -= entry->size;
+		b2Assert(entry->segment == m_segmentIndex);
+		m_segments[entry->segment].index -= entry->size;
+
+		// Step back over segments that became empty.
+		while (m_segmentIndex > 0 && m_segments[m_segmentIndex].index == 0)
+		{
+			--m_segmentIndex;
+		}
 	}
 	m_allocation -= entry->size;
 	--m_entryCount;
@@ -85,3 +125,19 @@ int32 b2StackAllocator::GetMaxAllocation() const
 {
 	return m_maxAllocation;
 }
+
+b2StackAllocatorStats b2StackAllocator::GetStats() const
+{
+	b2StackAllocatorStats stats;
+	stats.capacity = 0;
+	for (int32 i = 0; i < m_segmentCount; ++i)
+	{
+		stats.capacity += m_segments[i].size;
+	}
+	stats.segmentCount = m_segmentCount;
+	stats.allocation = m_allocation;
+	stats.maxAllocation = m_maxAllocation;
+	stats.growCount = m_growCount;
+	stats.heapFallbackCount = m_heapFallbackCount;
+	return stats;
+}
@@ -0,0 +1,152 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include "box2d/b2_math.h"
+#include "box2d/b2_thread_pool.h"
+
+#include <new>
+
+b2ThreadPool::b2ThreadPool(int32 workerCount)
+{
+	b2Assert(workerCount > 0);
+	m_workerCount = workerCount;
+	m_generation = 0;
+	m_busyCount = 0;
+	m_quit = false;
+
+	m_fcn = nullptr;
+	m_context = nullptr;
+	m_count = 0;
+	m_rangeSize = 0;
+	m_rangeCount = 0;
+	m_nextRange = 0;
+
+	m_threads = nullptr;
+	if (m_workerCount > 1)
+	{
+		m_threads = (std::thread*)b2Alloc((m_workerCount - 1) * sizeof(std::thread));
+		for (int32 i = 1; i < m_workerCount; ++i)
+		{
+			new (m_threads + i - 1) std::thread(&b2ThreadPool::WorkerMain, this, i);
+		}
+	}
+}
+
+b2ThreadPool::~b2ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+
+	for (int32 i = 0; i < m_workerCount - 1; ++i)
+	{
+		m_threads[i].join();
+		m_threads[i].~thread();
+	}
+
+	if (m_threads)
+	{
+		b2Free(m_threads);
+	}
+}
+
+void b2ThreadPool::ParallelFor(int32 count, int32 minRange, b2ParallelForFcn* fcn, void* context)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	minRange = b2Max(minRange, 1);
+
+	// Aim for a few ranges per worker so uneven items balance out.
+	int32 rangeSize = b2Max(minRange, count / (4 * m_workerCount));
+	int32 rangeCount = (count + rangeSize - 1) / rangeSize;
+
+	if (m_workerCount == 1 || rangeCount == 1)
+	{
+		fcn(0, count, 0, context);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_fcn = fcn;
+		m_context = context;
+		m_count = count;
+		m_rangeSize = rangeSize;
+		m_rangeCount = rangeCount;
+		m_nextRange = 0;
+		m_busyCount = m_workerCount - 1;
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	RunRanges(0);
+
+	// Workers may still be inside fcn, the job must outlive them.
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [this] { return m_busyCount == 0; });
+}
+
+void b2ThreadPool::RunRanges(int32 workerIndex)
+{
+	for (;;)
+	{
+		int32 range = m_nextRange.fetch_add(1);
+		if (range >= m_rangeCount)
+		{
+			break;
+		}
+
+		int32 startIndex = range * m_rangeSize;
+		int32 endIndex = b2Min(startIndex + m_rangeSize, m_count);
+		m_fcn(startIndex, endIndex, workerIndex, m_context);
+	}
+}
+
+void b2ThreadPool::WorkerMain(int32 workerIndex)
+{
+	uint32 generation = 0;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;)
+	{
+		m_wake.wait(lock, [this, generation] { return m_quit || m_generation != generation; });
+		if (m_quit)
+		{
+			break;
+		}
+
+		generation = m_generation;
+		lock.unlock();
+
+		RunRanges(workerIndex);
+
+		lock.lock();
+		if (--m_busyCount == 0)
+		{
+			m_done.notify_one();
+		}
+	}
+}
@@ -68,43 +68,30 @@ float b2Timer::GetMilliseconds() const
 
 #elif defined(__linux__) || defined (__APPLE__)
 
-#include <sys/time.h>
+#include <time.h>
+
+// CLOCK_MONOTONIC never jumps with wall clock adjustments and has nanosecond resolution.
+static unsigned long long b2GetNanoseconds()
+{
+	timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (unsigned long long)t.tv_sec * 1000000000ull + (unsigned long long)t.tv_nsec;
+}
 
 b2Timer::b2Timer()
 {
-    Reset();
+	Reset();
 }
 
 void b2Timer::Reset()
 {
-    timeval t;
-    gettimeofday(&t, 0);
-    m_start_sec = t.tv_sec;
-    m_start_usec = t.tv_usec;
+	m_start = b2GetNanoseconds();
 }
 
 float b2Timer::GetMilliseconds() const
 {
-    timeval t;
-    gettimeofday(&t, 0);
-	time_t start_sec = m_start_sec;
-	suseconds_t start_usec = m_start_usec;
-	
-	// http://www.gnu.org/software/libc/manual/html_node/Elapsed-Time.html
-	if (t.tv_usec < start_usec)
-	{
-		int nsec = (start_usec - t.tv_usec) / 1000000 + 1;
-		start_usec -= 1000000 * nsec;
-		start_sec += nsec;
-	}
-	
-	if (t.tv_usec - start_usec > 1000000)
-	{
-		int nsec = (t.tv_usec - start_usec) / 1000000;
-		start_usec += 1000000 * nsec;
-		start_sec -= nsec;
-	}
-	return 1000.0f * (t.tv_sec - start_sec) + 0.001f * (t.tv_usec - start_usec);
+	unsigned long long count = b2GetNanoseconds() - m_start;
+	return float(double(count) * 1.0e-6);
 }
 
 #else
@@ -76,6 +76,7 @@ b2Body::b2Body(const b2BodyDef* bd, b2World* world)
 	m_contactList = nullptr;
 	m_prev = nullptr;
 	m_next = nullptr;
+	m_worldIndex = -1;
 
 	m_linearVelocity = bd->linearVelocity;
 	m_angularVelocity = bd->angularVelocity;
@@ -121,6 +122,7 @@ void b2Body::SetType(b2BodyType type)
 		return;
 	}
 
+	bool wasStatic = m_type == b2_staticBody;
 	m_type = type;
 
 	ResetMassData();
@@ -154,6 +156,14 @@ void b2Body::SetType(b2BodyType type)
 	b2BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
 	for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
 	{
+		// Static proxies live in their own tree. Recreating them also touches them.
+		if (wasStatic != (m_type == b2_staticBody) && f->m_proxyCount > 0)
+		{
+			f->DestroyProxies(broadPhase);
+			f->CreateProxies(broadPhase, m_xf);
+			continue;
+		}
+
 		int32 proxyCount = f->m_proxyCount;
 		for (int32 i = 0; i < proxyCount; ++i)
 		{
@@ -185,6 +195,7 @@ b2Fixture* b2Body::CreateFixture(const b2FixtureDef* def)
 	fixture->m_next = m_fixtureList;
 	m_fixtureList = fixture;
 	++m_fixtureCount;
+	m_world->AddFixture(fixture);
 
 	fixture->m_body = this;
 
@@ -272,6 +283,8 @@ void b2Body::DestroyFixture(b2Fixture* fixture)
 		fixture->DestroyProxies(broadPhase);
 	}
 
+	m_world->RemoveFixture(fixture);
+
 	fixture->m_body = nullptr;
 	fixture->m_next = nullptr;
 	fixture->Destroy(allocator);
@@ -24,8 +24,19 @@
 #include "box2d/b2_contact.h"
 #include "box2d/b2_contact_manager.h"
 #include "box2d/b2_fixture.h"
+#include "box2d/b2_thread_pool.h"
 #include "box2d/b2_world_callbacks.h"
 
+// Contacts per narrow-phase task. Smaller ranges cost more in scheduling than they win.
+const int32 b2_collideMinRange = 32;
+
+struct b2ContactUpdate
+{
+	b2Contact* contact;
+	b2Manifold oldManifold;
+	bool touching;
+};
+
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
 
@@ -36,6 +47,17 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = nullptr;
+	m_threadPool = nullptr;
+	m_updates = nullptr;
+	m_updateCapacity = 0;
+}
+
+b2ContactManager::~b2ContactManager()
+{
+	if (m_updates)
+	{
+		b2Free(m_updates);
+	}
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -106,9 +128,34 @@ void b2ContactManager::Destroy(b2Contact* c)
 // This is the top level collision call for the time step. Here
 // all the narrow phase collision is processed for the world
 // contact list.
+void b2ContactManager::UpdateManifolds(int32 startIndex, int32 endIndex, int32 workerIndex, void* context)
+{
+	B2_NOT_USED(workerIndex);
+
+	b2ContactUpdate* updates = (b2ContactUpdate*)context;
+	for (int32 i = startIndex; i < endIndex; ++i)
+	{
+		b2ContactUpdate* update = updates + i;
+		update->touching = update->contact->UpdateManifold(&update->oldManifold);
+	}
+}
+
 void b2ContactManager::Collide()
 {
-	// Update awake contacts.
+	// Make room for every contact, most of them persist.
+	if (m_updateCapacity < m_contactCount)
+	{
+		if (m_updates)
+		{
+			b2Free(m_updates);
+		}
+		m_updateCapacity = b2Max(2 * m_contactCount, 64);
+		m_updates = (b2ContactUpdate*)b2Alloc(m_updateCapacity * sizeof(b2ContactUpdate));
+	}
+
+	int32 updateCount = 0;
+
+	// Filter awake contacts and gather the ones that persist.
 	b2Contact* c = m_contactList;
 	while (c)
 	{
@@ -168,9 +215,28 @@ void b2ContactManager::Collide()
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		b2Assert(updateCount < m_updateCapacity);
+		m_updates[updateCount].contact = c;
+		++updateCount;
 		c = c->GetNext();
 	}
+
+	// Compute the manifolds. Each task only writes its own contacts.
+	if (m_threadPool)
+	{
+		m_threadPool->ParallelFor(updateCount, b2_collideMinRange, UpdateManifolds, m_updates);
+	}
+	else
+	{
+		UpdateManifolds(0, updateCount, 0, m_updates);
+	}
+
+	// Apply the results in list order so callbacks stay deterministic.
+	for (int32 i = 0; i < updateCount; ++i)
+	{
+		b2ContactUpdate* update = m_updates + i;
+		update->contact->FinishUpdate(m_contactListener, update->oldManifold, update->touching);
+	}
 }
 
 void b2ContactManager::FindNewContacts()
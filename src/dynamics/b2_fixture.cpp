@@ -35,6 +35,7 @@ b2Fixture::b2Fixture()
 {
 	m_body = nullptr;
 	m_next = nullptr;
+	m_worldIndex = -1;
 	m_proxies = nullptr;
 	m_proxyCount = 0;
 	m_shape = nullptr;
@@ -129,12 +130,13 @@ void b2Fixture::CreateProxies(b2BroadPhase* broadPhase, const b2Transform& xf)
 
 	// Create proxies in the broad-phase.
 	m_proxyCount = m_shape->GetChildCount();
+	bool staticProxy = m_body->GetType() == b2_staticBody;
 
 	for (int32 i = 0; i < m_proxyCount; ++i)
 	{
 		b2FixtureProxy* proxy = m_proxies + i;
 		m_shape->ComputeAABB(&proxy->aabb, xf, i);
-		proxy->proxyId = broadPhase->CreateProxy(proxy->aabb, proxy);
+		proxy->proxyId = broadPhase->CreateProxy(proxy->aabb, proxy, staticProxy);
 		proxy->fixture = this;
 		proxy->childIndex = i;
 	}
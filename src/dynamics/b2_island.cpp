@@ -31,6 +31,7 @@
 
 #include "b2_contact_solver.h"
 #include "b2_island.h"
+#include "b2_wide_contact_solver.h"
 
 /*
 Position Correction Notes
@@ -166,6 +167,8 @@ b2Island::b2Island(
 
 	m_allocator = allocator;
 	m_listener = listener;
+	m_contactIndices = nullptr;
+	m_impulses = nullptr;
 
 	m_bodies = (b2Body**)m_allocator->Allocate(bodyCapacity * sizeof(b2Body*));
 	m_contacts = (b2Contact**)m_allocator->Allocate(contactCapacity	 * sizeof(b2Contact*));
@@ -185,6 +188,22 @@ b2Island::~b2Island()
 	m_allocator->Free(m_bodies);
 }
 
+void b2Island::Set(b2Body** bodies, int32 bodyCount, b2Contact** contacts, const int32* contactIndices,
+				   int32 contactCount, b2Joint** joints, int32 jointCount)
+{
+	b2Assert(bodyCount <= m_bodyCapacity);
+	b2Assert(contactCount <= m_contactCapacity);
+	b2Assert(jointCount <= m_jointCapacity);
+
+	memcpy(m_bodies, bodies, bodyCount * sizeof(b2Body*));
+	memcpy(m_contacts, contacts, contactCount * sizeof(b2Contact*));
+	memcpy(m_joints, joints, jointCount * sizeof(b2Joint*));
+	m_bodyCount = bodyCount;
+	m_contactCount = contactCount;
+	m_jointCount = jointCount;
+	m_contactIndices = contactIndices;
+}
+
 void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep)
 {
 	b2Timer timer;
@@ -201,9 +220,13 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		b2Vec2 v = b->m_linearVelocity;
 		float w = b->m_angularVelocity;
 
-		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		// Store positions for continuous collision. Static bodies never move
+		// and may be shared with other islands, so leave them alone.
+		if (b->m_type != b2_staticBody)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
 
 		if (b->m_type == b2_dynamicBody)
 		{
@@ -244,6 +267,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
 	contactSolverDef.allocator = m_allocator;
+	contactSolverDef.indices = m_contactIndices;
 
 	b2ContactSolver contactSolver(&contactSolverDef);
 	contactSolver.InitializeVelocityConstraints();
@@ -252,6 +276,12 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	{
 		contactSolver.WarmStart();
 	}
+
+	b2WideContactSolver wideSolver(&contactSolver);
+	if (step.wideContactSolver)
+	{
+		wideSolver.Prepare();
+	}
 	
 	for (int32 i = 0; i < m_jointCount; ++i)
 	{
@@ -269,10 +299,21 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 			m_joints[j]->SolveVelocityConstraints(solverData);
 		}
 
-		contactSolver.SolveVelocityConstraints();
+		if (step.wideContactSolver)
+		{
+			wideSolver.SolveVelocityConstraints();
+		}
+		else
+		{
+			contactSolver.SolveVelocityConstraints();
+		}
 	}
 
 	// Store impulses for warm starting
+	if (step.wideContactSolver)
+	{
+		wideSolver.StoreImpulses();
+	}
 	contactSolver.StoreImpulses();
 	profile->solveVelocity = timer.GetMilliseconds();
 
@@ -314,7 +355,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	bool positionSolved = false;
 	for (int32 i = 0; i < step.positionIterations; ++i)
 	{
-		bool contactsOkay = contactSolver.SolvePositionConstraints();
+		bool contactsOkay = step.wideContactSolver ? wideSolver.SolvePositionConstraints() : contactSolver.SolvePositionConstraints();
 
 		bool jointsOkay = true;
 		for (int32 j = 0; j < m_jointCount; ++j)
@@ -335,6 +376,11 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
+		if (body->m_type == b2_staticBody)
+		{
+			continue;
+		}
+
 		body->m_sweep.c = m_positions[i].c;
 		body->m_sweep.a = m_positions[i].a;
 		body->m_linearVelocity = m_velocities[i].v;
@@ -408,6 +454,7 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 	contactSolverDef.step = subStep;
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
+	contactSolverDef.indices = nullptr;
 	b2ContactSolver contactSolver(&contactSolverDef);
 
 	// Solve position constraints.
@@ -520,7 +567,7 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 
 void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 {
-	if (m_listener == nullptr)
+	if (m_listener == nullptr && m_impulses == nullptr)
 	{
 		return;
 	}
@@ -539,6 +586,13 @@ void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 			impulse.tangentImpulses[j] = vc->points[j].tangentImpulse;
 		}
 
-		m_listener->PostSolve(c, &impulse);
+		if (m_impulses)
+		{
+			m_impulses[i] = impulse;
+		}
+		else
+		{
+			m_listener->PostSolve(c, &impulse);
+		}
 	}
 }
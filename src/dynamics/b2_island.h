@@ -33,6 +33,7 @@ class b2StackAllocator;
 class b2ContactListener;
 struct b2ContactVelocityConstraint;
 struct b2Profile;
+struct b2ContactImpulse;
 
 /// This is an internal class.
 class b2Island
@@ -47,6 +48,20 @@ public:
 		m_bodyCount = 0;
 		m_contactCount = 0;
 		m_jointCount = 0;
+		m_contactIndices = nullptr;
+		m_impulses = nullptr;
+	}
+
+	// Fill the island from lists gathered by b2World::Solve. Body island indices are
+	// not touched: static bodies may be shared with islands solved on other threads,
+	// so contacts use contactIndices (two per contact) instead.
+	void Set(b2Body** bodies, int32 bodyCount, b2Contact** contacts, const int32* contactIndices,
+			int32 contactCount, b2Joint** joints, int32 jointCount);
+
+	// Collect the PostSolve impulses here, one per contact, instead of reporting them.
+	void SetImpulseBuffer(b2ContactImpulse* impulses)
+	{
+		m_impulses = impulses;
 	}
 
 	void Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep);
@@ -81,6 +96,8 @@ public:
 	b2Body** m_bodies;
 	b2Contact** m_contacts;
 	b2Joint** m_joints;
+	const int32* m_contactIndices;
+	b2ContactImpulse* m_impulses;
 
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
@@ -0,0 +1,609 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "b2_wide_contact_solver.h"
+#include "b2_contact_solver.h"
+
+#include "box2d/b2_simd.h"
+#include "box2d/b2_stack_allocator.h"
+
+#include <string.h>
+
+extern B2_API bool g_blockSolve;
+
+// Lane values of one body, gathered before a group is solved and scattered after.
+struct b2WideBody
+{
+	float x[B2_SIMD_WIDTH];
+	float y[B2_SIMD_WIDTH];
+	float a[B2_SIMD_WIDTH];
+};
+
+static inline bool b2IsMoving(float invMass, float invI)
+{
+	return invMass != 0.0f || invI != 0.0f;
+}
+
+b2WideContactSolver::b2WideContactSolver(b2ContactSolver* solver)
+{
+	m_solver = solver;
+	m_bodyColors = nullptr;
+	m_constraintColors = nullptr;
+	m_constraints = nullptr;
+	m_bodyCount = 0;
+	m_groupCount = 0;
+	m_colorCount = 0;
+}
+
+b2WideContactSolver::~b2WideContactSolver()
+{
+	b2StackAllocator* allocator = m_solver->m_allocator;
+	if (m_constraints)
+	{
+		allocator->Free(m_constraints);
+	}
+
+	if (m_constraintColors)
+	{
+		allocator->Free(m_constraintColors);
+	}
+
+	if (m_bodyColors)
+	{
+		allocator->Free(m_bodyColors);
+	}
+}
+
+void b2WideContactSolver::Prepare()
+{
+	b2Assert(m_constraints == nullptr);
+
+	int32 count = m_solver->m_count;
+	if (count == 0)
+	{
+		return;
+	}
+
+	const b2ContactVelocityConstraint* vcs = m_solver->m_velocityConstraints;
+	b2StackAllocator* allocator = m_solver->m_allocator;
+
+	m_bodyCount = 0;
+	for (int32 i = 0; i < count; ++i)
+	{
+		m_bodyCount = b2Max(m_bodyCount, b2Max(vcs[i].indexA, vcs[i].indexB) + 1);
+	}
+
+	m_bodyColors = (uint32*)allocator->Allocate(m_bodyCount * sizeof(uint32));
+	m_constraintColors = (int32*)allocator->Allocate(count * sizeof(int32));
+	memset(m_bodyColors, 0, m_bodyCount * sizeof(uint32));
+
+	// Greedy coloring. A body holds one bit per color it already appears in, static and
+	// kinematic bodies are never written by the solver so they don't block a color.
+	int32 colorCounts[B2_WIDE_MAX_COLORS] = { 0 };
+	int32 overflowCount = 0;
+	m_colorCount = 0;
+	for (int32 i = 0; i < count; ++i)
+	{
+		const b2ContactVelocityConstraint* vc = vcs + i;
+		bool movingA = b2IsMoving(vc->invMassA, vc->invIA);
+		bool movingB = b2IsMoving(vc->invMassB, vc->invIB);
+
+		uint32 used = 0;
+		if (movingA)
+		{
+			used |= m_bodyColors[vc->indexA];
+		}
+
+		if (movingB)
+		{
+			used |= m_bodyColors[vc->indexB];
+		}
+
+		int32 color = -1;
+		for (int32 c = 0; c < B2_WIDE_MAX_COLORS; ++c)
+		{
+			if ((used & (1u << c)) == 0)
+			{
+				color = c;
+				break;
+			}
+		}
+
+		m_constraintColors[i] = color;
+		if (color == -1)
+		{
+			++overflowCount;
+			continue;
+		}
+
+		uint32 bit = 1u << color;
+		if (movingA)
+		{
+			m_bodyColors[vc->indexA] |= bit;
+		}
+
+		if (movingB)
+		{
+			m_bodyColors[vc->indexB] |= bit;
+		}
+
+		++colorCounts[color];
+		m_colorCount = b2Max(m_colorCount, color + 1);
+	}
+
+	// Each color fills whole groups, constraints that ran out of colors get a group each.
+	int32 groupStarts[B2_WIDE_MAX_COLORS + 1];
+	m_groupCount = 0;
+	for (int32 c = 0; c < m_colorCount; ++c)
+	{
+		groupStarts[c] = m_groupCount;
+		m_groupCount += (colorCounts[c] + B2_SIMD_WIDTH - 1) / B2_SIMD_WIDTH;
+	}
+	groupStarts[m_colorCount] = m_groupCount;
+	m_groupCount += overflowCount;
+
+	m_constraints = (b2WideConstraint*)allocator->Allocate(m_groupCount * sizeof(b2WideConstraint));
+	memset(m_constraints, 0, m_groupCount * sizeof(b2WideConstraint));
+	for (int32 g = 0; g < m_groupCount; ++g)
+	{
+		for (int32 lane = 0; lane < B2_SIMD_WIDTH; ++lane)
+		{
+			m_constraints[g].constraintIndex[lane] = -1;
+		}
+	}
+
+	int32 fill[B2_WIDE_MAX_COLORS] = { 0 };
+	int32 overflowGroup = groupStarts[m_colorCount];
+	for (int32 i = 0; i < count; ++i)
+	{
+		int32 color = m_constraintColors[i];
+		b2WideConstraint* wc;
+		int32 lane;
+		if (color == -1)
+		{
+			wc = m_constraints + overflowGroup++;
+			lane = 0;
+		}
+		else
+		{
+			wc = m_constraints + groupStarts[color] + fill[color] / B2_SIMD_WIDTH;
+			lane = fill[color] % B2_SIMD_WIDTH;
+			++fill[color];
+		}
+
+		const b2ContactVelocityConstraint* vc = vcs + i;
+		wc->constraintIndex[lane] = i;
+		wc->indexA[lane] = vc->indexA;
+		wc->indexB[lane] = vc->indexB;
+		wc->invMassA[lane] = vc->invMassA;
+		wc->invMassB[lane] = vc->invMassB;
+		wc->invIA[lane] = vc->invIA;
+		wc->invIB[lane] = vc->invIB;
+		wc->normalX[lane] = vc->normal.x;
+		wc->normalY[lane] = vc->normal.y;
+		wc->friction[lane] = vc->friction;
+		wc->tangentSpeed[lane] = vc->tangentSpeed;
+
+		// InitializeVelocityConstraints drops ill conditioned manifolds to one point.
+		if (vc->pointCount == 2 && g_blockSolve)
+		{
+			wc->K11[lane] = vc->K.ex.x;
+			wc->K12[lane] = vc->K.ey.x;
+			wc->K22[lane] = vc->K.ey.y;
+			wc->normalMass11[lane] = vc->normalMass.ex.x;
+			wc->normalMass12[lane] = vc->normalMass.ey.x;
+			wc->normalMass22[lane] = vc->normalMass.ey.y;
+			wc->blockSolve[lane] = 1.0f;
+		}
+
+		// Missing second points keep zero mass and impulse.
+		for (int32 j = 0; j < vc->pointCount; ++j)
+		{
+			const b2VelocityConstraintPoint* vcp = vc->points + j;
+			b2WidePoint* wp = wc->points + j;
+			wp->rAx[lane] = vcp->rA.x;
+			wp->rAy[lane] = vcp->rA.y;
+			wp->rBx[lane] = vcp->rB.x;
+			wp->rBy[lane] = vcp->rB.y;
+			wp->normalMass[lane] = vcp->normalMass;
+			wp->tangentMass[lane] = vcp->tangentMass;
+			wp->velocityBias[lane] = vcp->velocityBias;
+			wp->normalImpulse[lane] = vcp->normalImpulse;
+			wp->tangentImpulse[lane] = vcp->tangentImpulse;
+		}
+	}
+}
+
+void b2WideContactSolver::SolveVelocityConstraints()
+{
+	b2Velocity* velocities = m_solver->m_velocities;
+
+	for (int32 g = 0; g < m_groupCount; ++g)
+	{
+		b2WideConstraint* wc = m_constraints + g;
+
+		b2WideBody bodyA, bodyB;
+		for (int32 lane = 0; lane < B2_SIMD_WIDTH; ++lane)
+		{
+			if (wc->constraintIndex[lane] == -1)
+			{
+				bodyA.x[lane] = bodyA.y[lane] = bodyA.a[lane] = 0.0f;
+				bodyB.x[lane] = bodyB.y[lane] = bodyB.a[lane] = 0.0f;
+				continue;
+			}
+
+			const b2Velocity& velA = velocities[wc->indexA[lane]];
+			const b2Velocity& velB = velocities[wc->indexB[lane]];
+			bodyA.x[lane] = velA.v.x;
+			bodyA.y[lane] = velA.v.y;
+			bodyA.a[lane] = velA.w;
+			bodyB.x[lane] = velB.v.x;
+			bodyB.y[lane] = velB.v.y;
+			bodyB.a[lane] = velB.w;
+		}
+
+		b2FloatW vAx = b2LoadW(bodyA.x), vAy = b2LoadW(bodyA.y), wA = b2LoadW(bodyA.a);
+		b2FloatW vBx = b2LoadW(bodyB.x), vBy = b2LoadW(bodyB.y), wB = b2LoadW(bodyB.a);
+
+		b2FloatW mA = b2LoadW(wc->invMassA), iA = b2LoadW(wc->invIA);
+		b2FloatW mB = b2LoadW(wc->invMassB), iB = b2LoadW(wc->invIB);
+		b2FloatW nx = b2LoadW(wc->normalX), ny = b2LoadW(wc->normalY);
+		b2FloatW zero = b2SplatW(0.0f);
+
+		// tangent = b2Cross(normal, 1.0f)
+		b2FloatW tx = ny;
+		b2FloatW ty = b2SubW(zero, nx);
+		b2FloatW friction = b2LoadW(wc->friction);
+		b2FloatW tangentSpeed = b2LoadW(wc->tangentSpeed);
+
+		// Solve tangent constraints first because non-penetration is more important
+		// than friction.
+		for (int32 j = 0; j < b2_maxManifoldPoints; ++j)
+		{
+			b2WidePoint* wp = wc->points + j;
+			b2FloatW rAx = b2LoadW(wp->rAx), rAy = b2LoadW(wp->rAy);
+			b2FloatW rBx = b2LoadW(wp->rBx), rBy = b2LoadW(wp->rBy);
+
+			// Relative velocity at contact
+			b2FloatW dvx = b2AddW(b2SubW(b2SubW(vBx, b2MulW(wB, rBy)), vAx), b2MulW(wA, rAy));
+			b2FloatW dvy = b2SubW(b2SubW(b2AddW(vBy, b2MulW(wB, rBx)), vAy), b2MulW(wA, rAx));
+
+			// Compute tangent force
+			b2FloatW vt = b2SubW(b2AddW(b2MulW(dvx, tx), b2MulW(dvy, ty)), tangentSpeed);
+			b2FloatW lambda = b2MulW(b2LoadW(wp->tangentMass), b2SubW(zero, vt));
+
+			// b2Clamp the accumulated force
+			b2FloatW maxFriction = b2MulW(friction, b2LoadW(wp->normalImpulse));
+			b2FloatW oldImpulse = b2LoadW(wp->tangentImpulse);
+			b2FloatW newImpulse = b2MaxW(b2SubW(zero, maxFriction), b2MinW(b2AddW(oldImpulse, lambda), maxFriction));
+			lambda = b2SubW(newImpulse, oldImpulse);
+			b2StoreW(wp->tangentImpulse, newImpulse);
+
+			// Apply contact impulse
+			b2FloatW Px = b2MulW(lambda, tx);
+			b2FloatW Py = b2MulW(lambda, ty);
+
+			vAx = b2SubW(vAx, b2MulW(mA, Px));
+			vAy = b2SubW(vAy, b2MulW(mA, Py));
+			wA = b2SubW(wA, b2MulW(iA, b2SubW(b2MulW(rAx, Py), b2MulW(rAy, Px))));
+
+			vBx = b2AddW(vBx, b2MulW(mB, Px));
+			vBy = b2AddW(vBy, b2MulW(mB, Py));
+			wB = b2AddW(wB, b2MulW(iB, b2SubW(b2MulW(rBx, Py), b2MulW(rBy, Px))));
+		}
+
+		// Solve normal constraints one point at a time where the block solver doesn't apply.
+		// This covers all lanes when g_blockSolve is off.
+		b2FloatW blockSolve = b2GreaterW(b2LoadW(wc->blockSolve), zero);
+		for (int32 j = 0; j < b2_maxManifoldPoints; ++j)
+		{
+			b2WidePoint* wp = wc->points + j;
+			b2FloatW rAx = b2LoadW(wp->rAx), rAy = b2LoadW(wp->rAy);
+			b2FloatW rBx = b2LoadW(wp->rBx), rBy = b2LoadW(wp->rBy);
+
+			// Relative velocity at contact
+			b2FloatW dvx = b2AddW(b2SubW(b2SubW(vBx, b2MulW(wB, rBy)), vAx), b2MulW(wA, rAy));
+			b2FloatW dvy = b2SubW(b2SubW(b2AddW(vBy, b2MulW(wB, rBx)), vAy), b2MulW(wA, rAx));
+
+			// Compute normal impulse
+			b2FloatW vn = b2AddW(b2MulW(dvx, nx), b2MulW(dvy, ny));
+			b2FloatW lambda = b2MulW(b2LoadW(wp->normalMass), b2SubW(b2LoadW(wp->velocityBias), vn));
+
+			// b2Clamp the accumulated impulse
+			b2FloatW oldImpulse = b2LoadW(wp->normalImpulse);
+			b2FloatW newImpulse = b2BlendW(b2MaxW(b2AddW(oldImpulse, lambda), zero), oldImpulse, blockSolve);
+			lambda = b2SubW(newImpulse, oldImpulse);
+			b2StoreW(wp->normalImpulse, newImpulse);
+
+			// Apply contact impulse
+			b2FloatW Px = b2MulW(lambda, nx);
+			b2FloatW Py = b2MulW(lambda, ny);
+
+			vAx = b2SubW(vAx, b2MulW(mA, Px));
+			vAy = b2SubW(vAy, b2MulW(mA, Py));
+			wA = b2SubW(wA, b2MulW(iA, b2SubW(b2MulW(rAx, Py), b2MulW(rAy, Px))));
+
+			vBx = b2AddW(vBx, b2MulW(mB, Px));
+			vBy = b2AddW(vBy, b2MulW(mB, Py));
+			wB = b2AddW(wB, b2MulW(iB, b2SubW(b2MulW(rBx, Py), b2MulW(rBy, Px))));
+		}
+
+		// Block solver, see b2ContactSolver::SolveVelocityConstraints. All four cases of the
+		// mini LCP are evaluated and the first valid one is kept. Lanes outside the block
+		// solve keep their impulse, which makes the update a no-op for them.
+		{
+			b2WidePoint* cp1 = wc->points + 0;
+			b2WidePoint* cp2 = wc->points + 1;
+			b2FloatW r1Ax = b2LoadW(cp1->rAx), r1Ay = b2LoadW(cp1->rAy);
+			b2FloatW r1Bx = b2LoadW(cp1->rBx), r1By = b2LoadW(cp1->rBy);
+			b2FloatW r2Ax = b2LoadW(cp2->rAx), r2Ay = b2LoadW(cp2->rAy);
+			b2FloatW r2Bx = b2LoadW(cp2->rBx), r2By = b2LoadW(cp2->rBy);
+
+			b2FloatW ax = b2LoadW(cp1->normalImpulse);
+			b2FloatW ay = b2LoadW(cp2->normalImpulse);
+
+			// Relative velocity at contact
+			b2FloatW dv1x = b2AddW(b2SubW(b2SubW(vBx, b2MulW(wB, r1By)), vAx), b2MulW(wA, r1Ay));
+			b2FloatW dv1y = b2SubW(b2SubW(b2AddW(vBy, b2MulW(wB, r1Bx)), vAy), b2MulW(wA, r1Ax));
+			b2FloatW dv2x = b2AddW(b2SubW(b2SubW(vBx, b2MulW(wB, r2By)), vAx), b2MulW(wA, r2Ay));
+			b2FloatW dv2y = b2SubW(b2SubW(b2AddW(vBy, b2MulW(wB, r2Bx)), vAy), b2MulW(wA, r2Ax));
+
+			// Compute normal velocity
+			b2FloatW vn1 = b2AddW(b2MulW(dv1x, nx), b2MulW(dv1y, ny));
+			b2FloatW vn2 = b2AddW(b2MulW(dv2x, nx), b2MulW(dv2y, ny));
+
+			// Compute b'
+			b2FloatW K11 = b2LoadW(wc->K11), K12 = b2LoadW(wc->K12), K22 = b2LoadW(wc->K22);
+			b2FloatW bx = b2SubW(b2SubW(vn1, b2LoadW(cp1->velocityBias)), b2AddW(b2MulW(K11, ax), b2MulW(K12, ay)));
+			b2FloatW by = b2SubW(b2SubW(vn2, b2LoadW(cp2->velocityBias)), b2AddW(b2MulW(K12, ax), b2MulW(K22, ay)));
+
+			// Cases are applied from last to first so the first valid one wins.
+			b2FloatW xx = ax;
+			b2FloatW xy = ay;
+
+			// Case 4: x = 0
+			b2FloatW valid = b2AndW(b2GreaterEqualW(bx, zero), b2GreaterEqualW(by, zero));
+			xx = b2BlendW(xx, zero, valid);
+			xy = b2BlendW(xy, zero, valid);
+
+			// Case 3: vn2 = 0 and x1 = 0
+			b2FloatW x2 = b2SubW(zero, b2MulW(b2LoadW(cp2->normalMass), by));
+			b2FloatW vn = b2AddW(b2MulW(K12, x2), bx);
+			valid = b2AndW(b2GreaterEqualW(x2, zero), b2GreaterEqualW(vn, zero));
+			xx = b2BlendW(xx, zero, valid);
+			xy = b2BlendW(xy, x2, valid);
+
+			// Case 2: vn1 = 0 and x2 = 0
+			b2FloatW x1 = b2SubW(zero, b2MulW(b2LoadW(cp1->normalMass), bx));
+			vn = b2AddW(b2MulW(K12, x1), by);
+			valid = b2AndW(b2GreaterEqualW(x1, zero), b2GreaterEqualW(vn, zero));
+			xx = b2BlendW(xx, x1, valid);
+			xy = b2BlendW(xy, zero, valid);
+
+			// Case 1: vn = 0
+			b2FloatW N11 = b2LoadW(wc->normalMass11), N12 = b2LoadW(wc->normalMass12), N22 = b2LoadW(wc->normalMass22);
+			x1 = b2SubW(zero, b2AddW(b2MulW(N11, bx), b2MulW(N12, by)));
+			x2 = b2SubW(zero, b2AddW(b2MulW(N12, bx), b2MulW(N22, by)));
+			valid = b2AndW(b2GreaterEqualW(x1, zero), b2GreaterEqualW(x2, zero));
+			xx = b2BlendW(xx, x1, valid);
+			xy = b2BlendW(xy, x2, valid);
+
+			xx = b2BlendW(ax, xx, blockSolve);
+			xy = b2BlendW(ay, xy, blockSolve);
+
+			// Get the incremental impulse
+			b2FloatW dx = b2SubW(xx, ax);
+			b2FloatW dy = b2SubW(xy, ay);
+
+			// Apply incremental impulse
+			b2FloatW P1x = b2MulW(dx, nx), P1y = b2MulW(dx, ny);
+			b2FloatW P2x = b2MulW(dy, nx), P2y = b2MulW(dy, ny);
+
+			vAx = b2SubW(vAx, b2MulW(mA, b2AddW(P1x, P2x)));
+			vAy = b2SubW(vAy, b2MulW(mA, b2AddW(P1y, P2y)));
+			b2FloatW crossA = b2AddW(b2SubW(b2MulW(r1Ax, P1y), b2MulW(r1Ay, P1x)), b2SubW(b2MulW(r2Ax, P2y), b2MulW(r2Ay, P2x)));
+			wA = b2SubW(wA, b2MulW(iA, crossA));
+
+			vBx = b2AddW(vBx, b2MulW(mB, b2AddW(P1x, P2x)));
+			vBy = b2AddW(vBy, b2MulW(mB, b2AddW(P1y, P2y)));
+			b2FloatW crossB = b2AddW(b2SubW(b2MulW(r1Bx, P1y), b2MulW(r1By, P1x)), b2SubW(b2MulW(r2Bx, P2y), b2MulW(r2By, P2x)));
+			wB = b2AddW(wB, b2MulW(iB, crossB));
+
+			// Accumulate
+			b2StoreW(cp1->normalImpulse, xx);
+			b2StoreW(cp2->normalImpulse, xy);
+		}
+
+		b2StoreW(bodyA.x, vAx);
+		b2StoreW(bodyA.y, vAy);
+		b2StoreW(bodyA.a, wA);
+		b2StoreW(bodyB.x, vBx);
+		b2StoreW(bodyB.y, vBy);
+		b2StoreW(bodyB.a, wB);
+
+		for (int32 lane = 0; lane < B2_SIMD_WIDTH; ++lane)
+		{
+			if (wc->constraintIndex[lane] == -1)
+			{
+				continue;
+			}
+
+			b2Velocity& velA = velocities[wc->indexA[lane]];
+			b2Velocity& velB = velocities[wc->indexB[lane]];
+			velA.v.Set(bodyA.x[lane], bodyA.y[lane]);
+			velA.w = bodyA.a[lane];
+			velB.v.Set(bodyB.x[lane], bodyB.y[lane]);
+			velB.w = bodyB.a[lane];
+		}
+	}
+}
+
+void b2WideContactSolver::StoreImpulses()
+{
+	b2ContactVelocityConstraint* vcs = m_solver->m_velocityConstraints;
+
+	for (int32 g = 0; g < m_groupCount; ++g)
+	{
+		const b2WideConstraint* wc = m_constraints + g;
+		for (int32 lane = 0; lane < B2_SIMD_WIDTH; ++lane)
+		{
+			int32 index = wc->constraintIndex[lane];
+			if (index == -1)
+			{
+				continue;
+			}
+
+			b2ContactVelocityConstraint* vc = vcs + index;
+			for (int32 j = 0; j < vc->pointCount; ++j)
+			{
+				vc->points[j].normalImpulse = wc->points[j].normalImpulse[lane];
+				vc->points[j].tangentImpulse = wc->points[j].tangentImpulse[lane];
+			}
+		}
+	}
+}
+
+// Same sequential position solve as b2ContactSolver, the manifold is evaluated per
+// lane and the correction is applied to all lanes at once.
+bool b2WideContactSolver::SolvePositionConstraints()
+{
+	b2Position* positions = m_solver->m_positions;
+	b2ContactPositionConstraint* pcs = m_solver->m_positionConstraints;
+	float minSeparation = 0.0f;
+
+	for (int32 g = 0; g < m_groupCount; ++g)
+	{
+		const b2WideConstraint* wc = m_constraints + g;
+
+		b2WideBody bodyA, bodyB;
+		for (int32 lane = 0; lane < B2_SIMD_WIDTH; ++lane)
+		{
+			if (wc->constraintIndex[lane] == -1)
+			{
+				bodyA.x[lane] = bodyA.y[lane] = bodyA.a[lane] = 0.0f;
+				bodyB.x[lane] = bodyB.y[lane] = bodyB.a[lane] = 0.0f;
+				continue;
+			}
+
+			const b2Position& posA = positions[wc->indexA[lane]];
+			const b2Position& posB = positions[wc->indexB[lane]];
+			bodyA.x[lane] = posA.c.x;
+			bodyA.y[lane] = posA.c.y;
+			bodyA.a[lane] = posA.a;
+			bodyB.x[lane] = posB.c.x;
+			bodyB.y[lane] = posB.c.y;
+			bodyB.a[lane] = posB.a;
+		}
+
+		b2FloatW mA = b2LoadW(wc->invMassA), iA = b2LoadW(wc->invIA);
+		b2FloatW mB = b2LoadW(wc->invMassB), iB = b2LoadW(wc->invIB);
+
+		// Solve normal constraints
+		for (int32 j = 0; j < b2_maxManifoldPoints; ++j)
+		{
+			float normalX[B2_SIMD_WIDTH], normalY[B2_SIMD_WIDTH];
+			float pointX[B2_SIMD_WIDTH], pointY[B2_SIMD_WIDTH];
+			float C[B2_SIMD_WIDTH];
+			for (int32 lane = 0; lane < B2_SIMD_WIDTH; ++lane)
+			{
+				int32 index = wc->constraintIndex[lane];
+				if (index == -1 || j >= pcs[index].pointCount)
+				{
+					normalX[lane] = normalY[lane] = 0.0f;
+					pointX[lane] = bodyA.x[lane];
+					pointY[lane] = bodyA.y[lane];
+					C[lane] = 0.0f;
+					continue;
+				}
+
+				b2ContactPositionConstraint* pc = pcs + index;
+
+				b2Transform xfA, xfB;
+				xfA.q.Set(bodyA.a[lane]);
+				xfB.q.Set(bodyB.a[lane]);
+				xfA.p = b2Vec2(bodyA.x[lane], bodyA.y[lane]) - b2Mul(xfA.q, pc->localCenterA);
+				xfB.p = b2Vec2(bodyB.x[lane], bodyB.y[lane]) - b2Mul(xfB.q, pc->localCenterB);
+
+				b2PositionSolverManifold psm;
+				psm.Initialize(pc, xfA, xfB, j);
+
+				normalX[lane] = psm.normal.x;
+				normalY[lane] = psm.normal.y;
+				pointX[lane] = psm.point.x;
+				pointY[lane] = psm.point.y;
+
+				// Track max constraint error.
+				minSeparation = b2Min(minSeparation, psm.separation);
+
+				// Prevent large corrections and allow slop.
+				C[lane] = b2Clamp(b2_baumgarte * (psm.separation + b2_linearSlop), -b2_maxLinearCorrection, 0.0f);
+			}
+
+			b2FloatW cAx = b2LoadW(bodyA.x), cAy = b2LoadW(bodyA.y), aA = b2LoadW(bodyA.a);
+			b2FloatW cBx = b2LoadW(bodyB.x), cBy = b2LoadW(bodyB.y), aB = b2LoadW(bodyB.a);
+			b2FloatW nx = b2LoadW(normalX), ny = b2LoadW(normalY);
+			b2FloatW px = b2LoadW(pointX), py = b2LoadW(pointY);
+
+			b2FloatW rAx = b2SubW(px, cAx), rAy = b2SubW(py, cAy);
+			b2FloatW rBx = b2SubW(px, cBx), rBy = b2SubW(py, cBy);
+
+			// Compute the effective mass.
+			b2FloatW rnA = b2SubW(b2MulW(rAx, ny), b2MulW(rAy, nx));
+			b2FloatW rnB = b2SubW(b2MulW(rBx, ny), b2MulW(rBy, nx));
+			b2FloatW K = b2AddW(b2AddW(mA, mB), b2AddW(b2MulW(iA, b2MulW(rnA, rnA)), b2MulW(iB, b2MulW(rnB, rnB))));
+
+			// Compute normal impulse
+			b2FloatW zero = b2SplatW(0.0f);
+			b2FloatW impulse = b2BlendW(zero, b2DivW(b2SubW(zero, b2LoadW(C)), K), b2GreaterW(K, zero));
+
+			b2FloatW Px = b2MulW(impulse, nx);
+			b2FloatW Py = b2MulW(impulse, ny);
+
+			b2StoreW(bodyA.x, b2SubW(cAx, b2MulW(mA, Px)));
+			b2StoreW(bodyA.y, b2SubW(cAy, b2MulW(mA, Py)));
+			b2StoreW(bodyA.a, b2SubW(aA, b2MulW(iA, b2SubW(b2MulW(rAx, Py), b2MulW(rAy, Px)))));
+
+			b2StoreW(bodyB.x, b2AddW(cBx, b2MulW(mB, Px)));
+			b2StoreW(bodyB.y, b2AddW(cBy, b2MulW(mB, Py)));
+			b2StoreW(bodyB.a, b2AddW(aB, b2MulW(iB, b2SubW(b2MulW(rBx, Py), b2MulW(rBy, Px)))));
+		}
+
+		for (int32 lane = 0; lane < B2_SIMD_WIDTH; ++lane)
+		{
+			if (wc->constraintIndex[lane] == -1)
+			{
+				continue;
+			}
+
+			b2Position& posA = positions[wc->indexA[lane]];
+			b2Position& posB = positions[wc->indexB[lane]];
+			posA.c.Set(bodyA.x[lane], bodyA.y[lane]);
+			posA.a = bodyA.a[lane];
+			posB.c.Set(bodyB.x[lane], bodyB.y[lane]);
+			posB.a = bodyB.a[lane];
+		}
+	}
+
+	// We can't expect minSpeparation >= -b2_linearSlop because we don't
+	// push the separation above -b2_linearSlop.
+	return minSeparation >= -3.0f * b2_linearSlop;
+}
@@ -0,0 +1,97 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_WIDE_CONTACT_SOLVER_H
+#define B2_WIDE_CONTACT_SOLVER_H
+
+#include "box2d/b2_math.h"
+#include "box2d/b2_simd.h"
+
+class b2ContactSolver;
+
+// Colors handed out before constraints spill into single-lane groups.
+#define B2_WIDE_MAX_COLORS 24
+
+// Structure of arrays for one contact point across the lanes of a group.
+struct b2WidePoint
+{
+	float rAx[B2_SIMD_WIDTH], rAy[B2_SIMD_WIDTH];
+	float rBx[B2_SIMD_WIDTH], rBy[B2_SIMD_WIDTH];
+	float normalMass[B2_SIMD_WIDTH];
+	float tangentMass[B2_SIMD_WIDTH];
+	float velocityBias[B2_SIMD_WIDTH];
+	float normalImpulse[B2_SIMD_WIDTH];
+	float tangentImpulse[B2_SIMD_WIDTH];
+};
+
+// Up to B2_SIMD_WIDTH contact constraints that share no moving body. Unused lanes
+// have a constraint index of -1 and zero mass, so they solve to nothing.
+struct b2WideConstraint
+{
+	int32 constraintIndex[B2_SIMD_WIDTH];
+	int32 indexA[B2_SIMD_WIDTH], indexB[B2_SIMD_WIDTH];
+	float invMassA[B2_SIMD_WIDTH], invMassB[B2_SIMD_WIDTH];
+	float invIA[B2_SIMD_WIDTH], invIB[B2_SIMD_WIDTH];
+	float normalX[B2_SIMD_WIDTH], normalY[B2_SIMD_WIDTH];
+	float friction[B2_SIMD_WIDTH];
+	float tangentSpeed[B2_SIMD_WIDTH];
+	float K11[B2_SIMD_WIDTH], K12[B2_SIMD_WIDTH], K22[B2_SIMD_WIDTH];
+	float normalMass11[B2_SIMD_WIDTH], normalMass12[B2_SIMD_WIDTH], normalMass22[B2_SIMD_WIDTH];
+	float blockSolve[B2_SIMD_WIDTH];
+	b2WidePoint points[b2_maxManifoldPoints];
+};
+
+/// Alternative to b2ContactSolver's velocity and position iterations. The constraint
+/// graph is colored so constraints of one color share no moving body, then each color
+/// is packed into groups solved B2_SIMD_WIDTH at a time with SSE2/AVX2 (or plain
+/// floats elsewhere). Two point manifolds go through the same block solver as
+/// b2ContactSolver, evaluated for every lane and selected with masks.
+/// Constraint setup, warm starting and impulse storage stay with b2ContactSolver.
+class b2WideContactSolver
+{
+public:
+	b2WideContactSolver(b2ContactSolver* solver);
+	~b2WideContactSolver();
+
+	// Color and pack the initialized constraints. Call after warm starting.
+	void Prepare();
+
+	void SolveVelocityConstraints();
+
+	// Copy the accumulated impulses back into the velocity constraints.
+	void StoreImpulses();
+
+	bool SolvePositionConstraints();
+
+	int32 GetColorCount() const { return m_colorCount; }
+
+private:
+	b2ContactSolver* m_solver;
+	uint32* m_bodyColors;
+	int32* m_constraintColors;
+	b2WideConstraint* m_constraints;
+	int32 m_bodyCount;
+	int32 m_groupCount;
+	int32 m_colorCount;
+};
+
+#endif
@@ -34,11 +34,14 @@
 #include "box2d/b2_fixture.h"
 #include "box2d/b2_polygon_shape.h"
 #include "box2d/b2_pulley_joint.h"
+#include "box2d/b2_thread_pool.h"
 #include "box2d/b2_time_of_impact.h"
 #include "box2d/b2_timer.h"
 #include "box2d/b2_world.h"
 
+#include <algorithm>
 #include <new>
+#include <string.h>
 
 b2World::b2World(const b2Vec2& gravity)
 {
@@ -51,9 +54,16 @@ b2World::b2World(const b2Vec2& gravity)
 	m_bodyCount = 0;
 	m_jointCount = 0;
 
+	m_bodies = nullptr;
+	m_bodyCapacity = 0;
+	m_fixtures = nullptr;
+	m_fixtureCount = 0;
+	m_fixtureCapacity = 0;
+
 	m_warmStarting = true;
 	m_continuousPhysics = true;
 	m_subStepping = false;
+	m_wideContactSolver = false;
 
 	m_stepComplete = true;
 
@@ -67,6 +77,8 @@ b2World::b2World(const b2Vec2& gravity)
 	m_inv_dt0 = 0.0f;
 
 	m_contactManager.m_allocator = &m_blockAllocator;
+	m_threadPool = nullptr;
+	m_workerStacks = nullptr;
 
 	memset(&m_profile, 0, sizeof(b2Profile));
 }
@@ -90,6 +102,73 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	b2Free(m_bodies);
+	b2Free(m_fixtures);
+
+	SetWorkerCount(1);
+}
+
+// Doubles a full pointer array, returns the new array.
+static void** b2GrowArray(void** array, int32 count, int32* capacity)
+{
+	*capacity = b2Max(2 * *capacity, 64);
+	void** newArray = (void**)b2Alloc(*capacity * sizeof(void*));
+	if (count > 0)
+	{
+		memcpy(newArray, array, count * sizeof(void*));
+	}
+	b2Free(array);
+	return newArray;
+}
+
+void b2World::AddBody(b2Body* body)
+{
+	if (m_bodyCount == m_bodyCapacity)
+	{
+		m_bodies = (b2Body**)b2GrowArray((void**)m_bodies, m_bodyCount, &m_bodyCapacity);
+	}
+
+	body->m_worldIndex = m_bodyCount;
+	m_bodies[m_bodyCount] = body;
+	++m_bodyCount;
+}
+
+void b2World::RemoveBody(b2Body* body)
+{
+	b2Assert(0 <= body->m_worldIndex && body->m_worldIndex < m_bodyCount);
+	b2Assert(m_bodies[body->m_worldIndex] == body);
+
+	// Swap-remove, the last body takes the slot.
+	--m_bodyCount;
+	b2Body* last = m_bodies[m_bodyCount];
+	m_bodies[body->m_worldIndex] = last;
+	last->m_worldIndex = body->m_worldIndex;
+	body->m_worldIndex = -1;
+}
+
+void b2World::AddFixture(b2Fixture* fixture)
+{
+	if (m_fixtureCount == m_fixtureCapacity)
+	{
+		m_fixtures = (b2Fixture**)b2GrowArray((void**)m_fixtures, m_fixtureCount, &m_fixtureCapacity);
+	}
+
+	fixture->m_worldIndex = m_fixtureCount;
+	m_fixtures[m_fixtureCount] = fixture;
+	++m_fixtureCount;
+}
+
+void b2World::RemoveFixture(b2Fixture* fixture)
+{
+	b2Assert(0 <= fixture->m_worldIndex && fixture->m_worldIndex < m_fixtureCount);
+	b2Assert(m_fixtures[fixture->m_worldIndex] == fixture);
+
+	--m_fixtureCount;
+	b2Fixture* last = m_fixtures[m_fixtureCount];
+	m_fixtures[fixture->m_worldIndex] = last;
+	last->m_worldIndex = fixture->m_worldIndex;
+	fixture->m_worldIndex = -1;
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -131,7 +210,7 @@ b2Body* b2World::CreateBody(const b2BodyDef* def)
 		m_bodyList->m_prev = b;
 	}
 	m_bodyList = b;
-	++m_bodyCount;
+	AddBody(b);
 
 	return b;
 }
@@ -186,6 +265,7 @@ void b2World::DestroyBody(b2Body* b)
 		}
 
 		f0->DestroyProxies(&m_contactManager.m_broadPhase);
+		RemoveFixture(f0);
 		f0->Destroy(&m_blockAllocator);
 		f0->~b2Fixture();
 		m_blockAllocator.Free(f0, sizeof(b2Fixture));
@@ -212,7 +292,7 @@ void b2World::DestroyBody(b2Body* b)
 		m_bodyList = b->m_next;
 	}
 
-	--m_bodyCount;
+	RemoveBody(b);
 	b->~b2Body();
 	m_blockAllocator.Free(b, sizeof(b2Body));
 }
@@ -383,11 +463,101 @@ void b2World::SetAllowSleeping(bool flag)
 	m_allowSleep = flag;
 	if (m_allowSleep == false)
 	{
-		for (b2Body* b = m_bodyList; b; b = b->m_next)
+		for (int32 i = 0; i < m_bodyCount; ++i)
+		{
+			m_bodies[i]->SetAwake(true);
+		}
+	}
+}
+
+void b2World::SetWorkerCount(int32 workerCount)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	workerCount = b2Max(workerCount, 1);
+	if (workerCount == GetWorkerCount())
+	{
+		return;
+	}
+
+	if (m_threadPool)
+	{
+		for (int32 i = 0; i < m_threadPool->GetWorkerCount() - 1; ++i)
+		{
+			m_workerStacks[i].~b2StackAllocator();
+		}
+		b2Free(m_workerStacks);
+		m_workerStacks = nullptr;
+
+		m_threadPool->~b2ThreadPool();
+		b2Free(m_threadPool);
+		m_threadPool = nullptr;
+	}
+
+	if (workerCount > 1)
+	{
+		void* mem = b2Alloc(sizeof(b2ThreadPool));
+		m_threadPool = new (mem) b2ThreadPool(workerCount);
+
+		m_workerStacks = (b2StackAllocator*)b2Alloc((workerCount - 1) * sizeof(b2StackAllocator));
+		for (int32 i = 0; i < workerCount - 1; ++i)
 		{
-			b->SetAwake(true);
+			new (m_workerStacks + i) b2StackAllocator;
 		}
 	}
+
+	m_contactManager.m_threadPool = m_threadPool;
+}
+
+int32 b2World::GetWorkerCount() const
+{
+	return m_threadPool ? m_threadPool->GetWorkerCount() : 1;
+}
+
+// An island found by b2World::Solve, as ranges into the shared lists.
+struct b2IslandRange
+{
+	int32 bodyStart, bodyCount;
+	int32 contactStart, contactCount;
+	int32 jointStart, jointCount;
+	b2Profile profile;
+};
+
+struct b2IslandSolveContext
+{
+	b2World* world;
+	const b2TimeStep* step;
+	b2IslandRange* ranges;
+	const int32* order;
+	b2Body** bodies;
+	b2Contact** contacts;
+	const int32* contactIndices;
+	b2ContactImpulse* impulses;
+	b2Joint** joints;
+};
+
+void b2World::SolveIslands(int32 startIndex, int32 endIndex, int32 workerIndex, void* context)
+{
+	b2IslandSolveContext* ctx = (b2IslandSolveContext*)context;
+	b2World* world = ctx->world;
+	b2StackAllocator* allocator = workerIndex == 0 ? &world->m_stackAllocator : world->m_workerStacks + workerIndex - 1;
+
+	for (int32 i = startIndex; i < endIndex; ++i)
+	{
+		b2IslandRange* range = ctx->ranges + ctx->order[i];
+
+		// PostSolve is reported after all islands are done.
+		b2Island island(range->bodyCount, range->contactCount, range->jointCount, allocator, nullptr);
+		island.Set(ctx->bodies + range->bodyStart, range->bodyCount,
+				   ctx->contacts + range->contactStart, ctx->contactIndices + 2 * range->contactStart, range->contactCount,
+				   ctx->joints + range->jointStart, range->jointCount);
+		island.SetImpulseBuffer(ctx->impulses + range->contactStart);
+		island.Solve(&range->profile, *ctx->step, world->m_gravity, world->m_allowSleep);
+	}
 }
 
 // Find islands, integrate and solve constraints, solve position constraints
@@ -397,17 +567,10 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
-	// Size the island for the worst case.
-	b2Island island(m_bodyCount,
-					m_contactManager.m_contactCount,
-					m_jointCount,
-					&m_stackAllocator,
-					m_contactManager.m_contactListener);
-
 	// Clear all the island flags.
-	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
-		b->m_flags &= ~b2Body::e_islandFlag;
+		m_bodies[i]->m_flags &= ~b2Body::e_islandFlag;
 	}
 	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
 	{
@@ -418,11 +581,33 @@ void b2World::Solve(const b2TimeStep& step)
 		j->m_islandFlag = false;
 	}
 
-	// Build and simulate all awake islands.
+	// Islands are gathered first and solved afterwards, possibly in parallel.
+	// Static bodies show up once in every island they touch.
+	int32 contactCapacity = m_contactManager.m_contactCount;
+	int32 bodyCapacity = m_bodyCount + contactCapacity + m_jointCount;
+	b2Body** bodies = (b2Body**)m_stackAllocator.Allocate(bodyCapacity * sizeof(b2Body*));
+	b2Contact** contacts = (b2Contact**)m_stackAllocator.Allocate(contactCapacity * sizeof(b2Contact*));
+	int32* contactIndices = (int32*)m_stackAllocator.Allocate(2 * contactCapacity * sizeof(int32));
+	b2ContactImpulse* impulses = (b2ContactImpulse*)m_stackAllocator.Allocate(contactCapacity * sizeof(b2ContactImpulse));
+	b2Joint** joints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+	b2IslandRange* ranges = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+	int32* order = (int32*)m_stackAllocator.Allocate(m_bodyCount * sizeof(int32));
+	int32 bodyCount = 0;
+	int32 contactCount = 0;
+	int32 jointCount = 0;
+	int32 rangeCount = 0;
+
+	// Joints read island indices straight from the bodies, so islands with a joint
+	// to a static body are solved on this thread after the others.
+	int32 serialCount = 0;
+
+	// Build all awake islands. Seeds are visited newest first like the body list,
+	// which keeps the island order unchanged until a body is destroyed.
 	int32 stackSize = m_bodyCount;
 	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
-	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	for (int32 seedIndex = m_bodyCount - 1; seedIndex >= 0; --seedIndex)
 	{
+		b2Body* seed = m_bodies[seedIndex];
 		if (seed->m_flags & b2Body::e_islandFlag)
 		{
 			continue;
@@ -439,8 +624,13 @@ void b2World::Solve(const b2TimeStep& step)
 			continue;
 		}
 
-		// Reset island and stack.
-		island.Clear();
+		// Start a new island and reset the stack.
+		b2IslandRange* range = ranges + rangeCount;
+		range->bodyStart = bodyCount;
+		range->contactStart = contactCount;
+		range->jointStart = jointCount;
+		bool staticJoint = false;
+
 		int32 stackCount = 0;
 		stack[stackCount++] = seed;
 		seed->m_flags |= b2Body::e_islandFlag;
@@ -451,7 +641,9 @@ void b2World::Solve(const b2TimeStep& step)
 			// Grab the next body off the stack and add it to the island.
 			b2Body* b = stack[--stackCount];
 			b2Assert(b->IsEnabled() == true);
-			island.Add(b);
+			b2Assert(bodyCount < bodyCapacity);
+			b->m_islandIndex = bodyCount - range->bodyStart;
+			bodies[bodyCount++] = b;
 
 			// To keep islands as small as possible, we don't
 			// propagate islands across static bodies.
@@ -489,7 +681,8 @@ void b2World::Solve(const b2TimeStep& step)
 					continue;
 				}
 
-				island.Add(contact);
+				b2Assert(contactCount < contactCapacity);
+				contacts[contactCount++] = contact;
 				contact->m_flags |= b2Contact::e_islandFlag;
 
 				b2Body* other = ce->other;
@@ -521,8 +714,9 @@ void b2World::Solve(const b2TimeStep& step)
 					continue;
 				}
 
-				island.Add(je->joint);
+				joints[jointCount++] = je->joint;
 				je->joint->m_islandFlag = true;
+				staticJoint = staticJoint || other->GetType() == b2_staticBody;
 
 				if (other->m_flags & b2Body::e_islandFlag)
 				{
@@ -535,31 +729,122 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		range->bodyCount = bodyCount - range->bodyStart;
+		range->contactCount = contactCount - range->contactStart;
+		range->jointCount = jointCount - range->jointStart;
 
-		// Post solve cleanup.
-		for (int32 i = 0; i < island.m_bodyCount; ++i)
+		// Every body of this island has its index now, record them for the contacts
+		// before another island claims the static ones.
+		for (int32 i = range->contactStart; i < contactCount; ++i)
+		{
+			contactIndices[2 * i + 0] = contacts[i]->m_fixtureA->m_body->m_islandIndex;
+			contactIndices[2 * i + 1] = contacts[i]->m_fixtureB->m_body->m_islandIndex;
+		}
+
+		// Allow static bodies to participate in other islands.
+		for (int32 i = range->bodyStart; i < bodyCount; ++i)
 		{
-			// Allow static bodies to participate in other islands.
-			b2Body* b = island.m_bodies[i];
+			b2Body* b = bodies[i];
 			if (b->GetType() == b2_staticBody)
 			{
 				b->m_flags &= ~b2Body::e_islandFlag;
 			}
 		}
+
+		// Parallel islands are listed from the front, serial ones from the back.
+		if (staticJoint)
+		{
+			++serialCount;
+			order[m_bodyCount - serialCount] = rangeCount;
+		}
+		else
+		{
+			order[rangeCount - serialCount] = rangeCount;
+		}
+		++rangeCount;
+	}
+
+	int32 parallelCount = rangeCount - serialCount;
+
+	// Hand out the biggest islands first so one of them doesn't finish last on its own.
+	if (m_threadPool)
+	{
+		std::sort(order, order + parallelCount, [ranges](int32 a, int32 b)
+		{
+			int32 sizeA = ranges[a].bodyCount + ranges[a].contactCount;
+			int32 sizeB = ranges[b].bodyCount + ranges[b].contactCount;
+			return sizeA > sizeB || (sizeA == sizeB && a < b);
+		});
+	}
+
+	b2IslandSolveContext context;
+	context.world = this;
+	context.step = &step;
+	context.ranges = ranges;
+	context.order = order;
+	context.bodies = bodies;
+	context.contacts = contacts;
+	context.contactIndices = contactIndices;
+	context.impulses = impulses;
+	context.joints = joints;
+
+	if (m_threadPool)
+	{
+		m_threadPool->ParallelFor(parallelCount, 1, SolveIslands, &context);
+	}
+	else
+	{
+		SolveIslands(0, parallelCount, 0, &context);
+	}
+
+	for (int32 i = 0; i < serialCount; ++i)
+	{
+		int32 index = order[m_bodyCount - 1 - i];
+		b2IslandRange* range = ranges + index;
+		for (int32 j = 0; j < range->bodyCount; ++j)
+		{
+			bodies[range->bodyStart + j]->m_islandIndex = j;
+		}
+		context.order = &index;
+		SolveIslands(0, 1, 0, &context);
+	}
+
+	// Report impulses in the order the islands were found.
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	for (int32 i = 0; i < rangeCount; ++i)
+	{
+		b2IslandRange* range = ranges + i;
+		m_profile.solveInit += range->profile.solveInit;
+		m_profile.solveVelocity += range->profile.solveVelocity;
+		m_profile.solvePosition += range->profile.solvePosition;
+
+		if (listener == nullptr)
+		{
+			continue;
+		}
+
+		for (int32 j = range->contactStart; j < range->contactStart + range->contactCount; ++j)
+		{
+			listener->PostSolve(contacts[j], impulses + j);
+		}
 	}
 
 	m_stackAllocator.Free(stack);
+	m_stackAllocator.Free(order);
+	m_stackAllocator.Free(ranges);
+	m_stackAllocator.Free(joints);
+	m_stackAllocator.Free(impulses);
+	m_stackAllocator.Free(contactIndices);
+	m_stackAllocator.Free(contacts);
+	m_stackAllocator.Free(bodies);
 
 	{
 		b2Timer timer;
-		// Synchronize fixtures, check for out of range bodies.
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		// Synchronize fixtures, check for out of range bodies. Same order as the seeds.
+		for (int32 i = m_bodyCount - 1; i >= 0; --i)
 		{
+			b2Body* b = m_bodies[i];
+
 			// If a body was not in an island then it did not move.
 			if ((b->m_flags & b2Body::e_islandFlag) == 0)
 			{
@@ -588,8 +873,9 @@ void b2World::SolveTOI(const b2TimeStep& step)
 
 	if (m_stepComplete)
 	{
-		for (b2Body* b = m_bodyList; b; b = b->m_next)
+		for (int32 i = 0; i < m_bodyCount; ++i)
 		{
+			b2Body* b = m_bodies[i];
 			b->m_flags &= ~b2Body::e_islandFlag;
 			b->m_sweep.alpha0 = 0.0f;
 		}
@@ -868,6 +1154,7 @@ void b2World::SolveTOI(const b2TimeStep& step)
 		subStep.positionIterations = 20;
 		subStep.velocityIterations = step.velocityIterations;
 		subStep.warmStarting = false;
+		subStep.wideContactSolver = false;
 		island.SolveTOI(subStep, bA->m_islandIndex, bB->m_islandIndex);
 
 		// Reset island flags and synchronize broad-phase proxies.
@@ -931,6 +1218,7 @@ void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 	step.dtRatio = m_inv_dt0 * dt;
 
 	step.warmStarting = m_warmStarting;
+	step.wideContactSolver = m_wideContactSolver;
 	
 	// Update contacts. This is where some contacts are destroyed.
 	{
@@ -972,8 +1260,9 @@ void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 
 void b2World::ClearForces()
 {
-	for (b2Body* body = m_bodyList; body; body = body->GetNext())
+	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
+		b2Body* body = m_bodies[i];
 		body->m_force.SetZero();
 		body->m_torque = 0.0f;
 	}
@@ -1036,6 +1325,161 @@ void b2World::RayCast(b2RayCastCallback* callback, const b2Vec2& point1, const b
 	m_contactManager.m_broadPhase.RayCast(&wrapper, input);
 }
 
+static bool b2ShouldQuery(const b2QueryFilter* filter, const b2Fixture* fixture)
+{
+	if (fixture->GetBody() == filter->ignoreBody)
+	{
+		return false;
+	}
+
+	if (filter->ignoreSensors && fixture->IsSensor())
+	{
+		return false;
+	}
+
+	return (fixture->GetFilterData().categoryBits & filter->maskBits) != 0;
+}
+
+struct b2WorldRayCastBatchWrapper
+{
+	void PacketCallback(int32 proxyId, uint32 mask)
+	{
+		b2FixtureProxy* proxy = (b2FixtureProxy*)broadPhase->GetUserData(proxyId);
+		b2Fixture* fixture = proxy->fixture;
+		if (b2ShouldQuery(filter, fixture) == false)
+		{
+			return;
+		}
+
+		for (int32 i = 0; mask != 0; ++i, mask >>= 1)
+		{
+			if ((mask & 1) == 0)
+			{
+				continue;
+			}
+
+			b2RayCastInput input = inputs[i];
+			input.maxFraction = packet->maxFraction[i];
+
+			b2RayCastOutput output;
+			if (fixture->RayCast(&output, input, proxy->childIndex) == false)
+			{
+				continue;
+			}
+
+			// Clip the ray so farther nodes get culled.
+			float fraction = output.fraction;
+			packet->maxFraction[i] = fraction;
+
+			b2RayCastHit* hit = hits + i;
+			hit->fixture = fixture;
+			hit->point = (1.0f - fraction) * input.p1 + fraction * input.p2;
+			hit->normal = output.normal;
+			hit->fraction = fraction;
+		}
+	}
+
+	const b2BroadPhase* broadPhase;
+	const b2QueryFilter* filter;
+	const b2RayCastInput* inputs;
+	b2RayCastHit* hits;
+	b2RayPacket* packet;
+};
+
+void b2World::RayCastBatch(const b2RayCastInput* inputs, int32 count, b2RayCastHit* hits, const b2QueryFilter& filter) const
+{
+	for (int32 base = 0; base < count; base += b2_packetSize)
+	{
+		int32 packetCount = b2Min(count - base, b2_packetSize);
+
+		b2RayPacket packet;
+		for (int32 i = 0; i < packetCount; ++i)
+		{
+			const b2RayCastInput& input = inputs[base + i];
+			packet.Add(input);
+
+			b2RayCastHit* hit = hits + base + i;
+			hit->fixture = nullptr;
+			hit->point = input.p1 + input.maxFraction * (input.p2 - input.p1);
+			hit->normal.SetZero();
+			hit->fraction = input.maxFraction;
+		}
+
+		b2WorldRayCastBatchWrapper wrapper;
+		wrapper.broadPhase = &m_contactManager.m_broadPhase;
+		wrapper.filter = &filter;
+		wrapper.inputs = inputs + base;
+		wrapper.hits = hits + base;
+		wrapper.packet = &packet;
+		m_contactManager.m_broadPhase.QueryPacket(&wrapper, &packet);
+	}
+}
+
+struct b2WorldQueryBatchWrapper
+{
+	void PacketCallback(int32 proxyId, uint32 mask)
+	{
+		b2FixtureProxy* proxy = (b2FixtureProxy*)broadPhase->GetUserData(proxyId);
+		b2Fixture* fixture = proxy->fixture;
+		if (b2ShouldQuery(filter, fixture) == false)
+		{
+			return;
+		}
+
+		// The broad-phase tested fat AABBs, narrow it down to the fixture AABB.
+		mask = packet->TestOverlap(proxy->aabb, mask);
+		for (int32 i = 0; mask != 0; ++i, mask >>= 1)
+		{
+			if ((mask & 1) == 0)
+			{
+				continue;
+			}
+
+			if (count < capacity)
+			{
+				overlaps[count].index = base + i;
+				overlaps[count].fixture = fixture;
+			}
+			++count;
+		}
+	}
+
+	const b2BroadPhase* broadPhase;
+	const b2QueryFilter* filter;
+	const b2AABBPacket* packet;
+	b2AABBOverlap* overlaps;
+	int32 capacity;
+	int32 count;
+	int32 base;
+};
+
+int32 b2World::QueryAABBBatch(const b2AABB* aabbs, int32 count, b2AABBOverlap* overlaps, int32 capacity, const b2QueryFilter& filter) const
+{
+	b2WorldQueryBatchWrapper wrapper;
+	wrapper.broadPhase = &m_contactManager.m_broadPhase;
+	wrapper.filter = &filter;
+	wrapper.overlaps = overlaps;
+	wrapper.capacity = capacity;
+	wrapper.count = 0;
+
+	for (int32 base = 0; base < count; base += b2_packetSize)
+	{
+		int32 packetCount = b2Min(count - base, b2_packetSize);
+
+		b2AABBPacket packet;
+		for (int32 i = 0; i < packetCount; ++i)
+		{
+			packet.Add(aabbs[base + i]);
+		}
+
+		wrapper.packet = &packet;
+		wrapper.base = base;
+		m_contactManager.m_broadPhase.QueryPacket(&wrapper, &packet);
+	}
+
+	return wrapper.count;
+}
+
 void b2World::DrawShape(b2Fixture* fixture, const b2Transform& xf, const b2Color& color)
 {
 	switch (fixture->GetType())
@@ -1173,32 +1617,46 @@ void b2World::DebugDraw()
 		}
 	}
 
-	if (flags & b2Draw::e_aabbBit)
+	if (flags & b2Draw::e_contactPointBit)
 	{
-		b2Color color(0.9f, 0.3f, 0.9f);
-		b2BroadPhase* bp = &m_contactManager.m_broadPhase;
-
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		b2Color color(0.9f, 0.9f, 0.3f);
+		for (b2Contact* c = m_contactManager.m_contactList; c; c = c->GetNext())
 		{
-			if (b->IsEnabled() == false)
+			if (c->IsTouching() == false)
 			{
 				continue;
 			}
 
-			for (b2Fixture* f = b->GetFixtureList(); f; f = f->GetNext())
+			b2WorldManifold worldManifold;
+			c->GetWorldManifold(&worldManifold);
+			int32 pointCount = c->GetManifold()->pointCount;
+			for (int32 i = 0; i < pointCount; ++i)
 			{
-				for (int32 i = 0; i < f->m_proxyCount; ++i)
-				{
-					b2FixtureProxy* proxy = f->m_proxies + i;
-					b2AABB aabb = bp->GetFatAABB(proxy->proxyId);
-					b2Vec2 vs[4];
-					vs[0].Set(aabb.lowerBound.x, aabb.lowerBound.y);
-					vs[1].Set(aabb.upperBound.x, aabb.lowerBound.y);
-					vs[2].Set(aabb.upperBound.x, aabb.upperBound.y);
-					vs[3].Set(aabb.lowerBound.x, aabb.upperBound.y);
-
-					m_debugDraw->DrawPolygon(vs, 4, color);
-				}
+				m_debugDraw->DrawPoint(worldManifold.points[i], 5.0f, color);
+			}
+		}
+	}
+
+	if (flags & b2Draw::e_aabbBit)
+	{
+		b2Color color(0.9f, 0.3f, 0.9f);
+		b2BroadPhase* bp = &m_contactManager.m_broadPhase;
+
+		// Disabled bodies have no proxies.
+		for (int32 fixtureIndex = 0; fixtureIndex < m_fixtureCount; ++fixtureIndex)
+		{
+			b2Fixture* f = m_fixtures[fixtureIndex];
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				b2FixtureProxy* proxy = f->m_proxies + i;
+				b2AABB aabb = bp->GetFatAABB(proxy->proxyId);
+				b2Vec2 vs[4];
+				vs[0].Set(aabb.lowerBound.x, aabb.lowerBound.y);
+				vs[1].Set(aabb.upperBound.x, aabb.lowerBound.y);
+				vs[2].Set(aabb.upperBound.x, aabb.upperBound.y);
+				vs[3].Set(aabb.lowerBound.x, aabb.upperBound.y);
+
+				m_debugDraw->DrawPolygon(vs, 4, color);
 			}
 		}
 	}
@@ -1234,6 +1692,44 @@ float b2World::GetTreeQuality() const
 	return m_contactManager.m_broadPhase.GetTreeQuality();
 }
 
+int32 b2World::GetStaticTreeHeight() const
+{
+	return m_contactManager.m_broadPhase.GetStaticTreeHeight();
+}
+
+int32 b2World::GetStaticTreeBalance() const
+{
+	return m_contactManager.m_broadPhase.GetStaticTreeBalance();
+}
+
+float b2World::GetStaticTreeQuality() const
+{
+	return m_contactManager.m_broadPhase.GetStaticTreeQuality();
+}
+
+b2MemoryStats b2World::GetMemoryStats() const
+{
+	b2MemoryStats stats;
+	stats.stack = m_stackAllocator.GetStats();
+	stats.block = m_blockAllocator.GetStats();
+
+	b2StackAllocatorStats& workers = stats.workerStacks;
+	memset(&workers, 0, sizeof(workers));
+	int32 workerStackCount = m_threadPool ? m_threadPool->GetWorkerCount() - 1 : 0;
+	for (int32 i = 0; i < workerStackCount; ++i)
+	{
+		b2StackAllocatorStats worker = m_workerStacks[i].GetStats();
+		workers.capacity += worker.capacity;
+		workers.segmentCount += worker.segmentCount;
+		workers.allocation += worker.allocation;
+		workers.maxAllocation = b2Max(workers.maxAllocation, worker.maxAllocation);
+		workers.growCount += worker.growCount;
+		workers.heapFallbackCount += worker.heapFallbackCount;
+	}
+
+	return stats;
+}
+
 void b2World::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	b2Assert(m_locked == false);
@@ -1242,8 +1738,9 @@ void b2World::ShiftOrigin(const b2Vec2& newOrigin)
 		return;
 	}
 
-	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
+		b2Body* b = m_bodies[i];
 		b->m_xf.p -= newOrigin;
 		b->m_sweep.c0 -= newOrigin;
 		b->m_sweep.c -= newOrigin;
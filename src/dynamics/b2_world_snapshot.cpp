@@ -0,0 +1,305 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "box2d/b2_world_snapshot.h"
+#include "box2d/b2_body.h"
+#include "box2d/b2_broad_phase.h"
+#include "box2d/b2_contact.h"
+#include "box2d/b2_world.h"
+
+#include <string.h>
+
+// Grow an array to hold at least count elements. The contents are not kept.
+template <typename T>
+static void b2Reserve(T*& array, int32& capacity, int32 count)
+{
+	if (count <= capacity)
+	{
+		return;
+	}
+
+	b2Free(array);
+	capacity = b2Max(count, 2 * capacity);
+	array = (T*)b2Alloc(capacity * sizeof(T));
+}
+
+b2WorldSnapshot::b2WorldSnapshot()
+{
+	m_world = nullptr;
+
+	m_bodies = nullptr;
+	m_bodyCount = 0;
+	m_bodyCapacity = 0;
+
+	m_fixtures = nullptr;
+	m_fixtureCount = 0;
+	m_fixtureCapacity = 0;
+
+	m_contacts = nullptr;
+	m_contactCount = 0;
+	m_contactCapacity = 0;
+}
+
+b2WorldSnapshot::~b2WorldSnapshot()
+{
+	b2Free(m_bodies);
+	b2Free(m_fixtures);
+	b2Free(m_contacts);
+}
+
+void b2WorldSnapshot::Clear()
+{
+	m_world = nullptr;
+	m_bodyCount = 0;
+	m_fixtureCount = 0;
+	m_contactCount = 0;
+}
+
+void b2WorldSnapshot::Capture(const b2World* world)
+{
+	b2Assert(world->IsLocked() == false);
+
+	int32 fixtureCount = 0;
+	for (const b2Body* b = world->m_bodyList; b; b = b->m_next)
+	{
+		fixtureCount += b->m_fixtureCount;
+	}
+
+	int32 contactCount = 0;
+	for (const b2Contact* c = world->m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		contactCount += c->IsTouching() ? 1 : 0;
+	}
+
+	b2Reserve(m_bodies, m_bodyCapacity, world->m_bodyCount);
+	b2Reserve(m_fixtures, m_fixtureCapacity, fixtureCount);
+	b2Reserve(m_contacts, m_contactCapacity, contactCount);
+
+	m_world = world;
+	m_bodyCount = 0;
+	m_fixtureCount = 0;
+	m_contactCount = 0;
+
+	// Bodies and fixtures in list order, Matches relies on it
+	for (b2Body* b = world->m_bodyList; b; b = b->m_next)
+	{
+		b2BodyState* state = m_bodies + m_bodyCount++;
+		state->body = b;
+		state->xf = b->m_xf;
+		state->sweep = b->m_sweep;
+		state->linearVelocity = b->m_linearVelocity;
+		state->angularVelocity = b->m_angularVelocity;
+		state->force = b->m_force;
+		state->torque = b->m_torque;
+		state->gravityScale = b->m_gravityScale;
+		state->sleepTime = b->m_sleepTime;
+		state->flags = b->m_flags & ~b2Body::e_islandFlag;
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			b2FixtureState* fixtureState = m_fixtures + m_fixtureCount++;
+			fixtureState->fixture = f;
+			fixtureState->friction = f->m_friction;
+			fixtureState->restitution = f->m_restitution;
+			fixtureState->restitutionThreshold = f->m_restitutionThreshold;
+			fixtureState->filter = f->m_filter;
+			fixtureState->isSensor = f->m_isSensor;
+		}
+	}
+
+	for (b2Contact* c = world->m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		if (c->IsTouching() == false)
+		{
+			continue;
+		}
+
+		b2ContactState* state = m_contacts + m_contactCount++;
+		state->fixtureA = c->m_fixtureA;
+		state->fixtureB = c->m_fixtureB;
+		state->indexA = c->m_indexA;
+		state->indexB = c->m_indexB;
+		state->manifold = c->m_manifold;
+		state->flags = c->m_flags & ~b2Contact::e_islandFlag;
+		state->toiCount = c->m_toiCount;
+		state->toi = c->m_toi;
+		state->friction = c->m_friction;
+		state->restitution = c->m_restitution;
+		state->restitutionThreshold = c->m_restitutionThreshold;
+		state->tangentSpeed = c->m_tangentSpeed;
+	}
+
+	b2Assert(m_fixtureCount == fixtureCount);
+	b2Assert(m_contactCount == contactCount);
+}
+
+bool b2WorldSnapshot::Matches(const b2World* world) const
+{
+	if (world != m_world || world->m_bodyCount != m_bodyCount)
+	{
+		return false;
+	}
+
+	const b2BodyState* state = m_bodies;
+	const b2FixtureState* fixtureState = m_fixtures;
+	const b2FixtureState* fixtureEnd = m_fixtures + m_fixtureCount;
+	for (const b2Body* b = world->m_bodyList; b; b = b->m_next, ++state)
+	{
+		if (state->body != b)
+		{
+			return false;
+		}
+
+		for (const b2Fixture* f = b->m_fixtureList; f; f = f->m_next, ++fixtureState)
+		{
+			if (fixtureState == fixtureEnd || fixtureState->fixture != f)
+			{
+				return false;
+			}
+		}
+	}
+
+	return fixtureState == fixtureEnd;
+}
+
+bool b2WorldSnapshot::Restore(b2World* world) const
+{
+	b2Assert(world->IsLocked() == false);
+	if (world->IsLocked() || Matches(world) == false)
+	{
+		return false;
+	}
+
+	// All contacts are rebuilt from the broad-phase once the bodies are back in place.
+	// Destroy reports touching contacts as ended, so the listener is detached meanwhile.
+	b2ContactManager& contactManager = world->m_contactManager;
+	b2ContactListener* listener = contactManager.m_contactListener;
+	contactManager.m_contactListener = nullptr;
+	b2Contact* c = contactManager.m_contactList;
+	while (c)
+	{
+		b2Contact* next = c->m_next;
+		contactManager.Destroy(c);
+		c = next;
+	}
+	contactManager.m_contactListener = listener;
+
+	b2BroadPhase* broadPhase = &contactManager.m_broadPhase;
+	const b2FixtureState* fixtureState = m_fixtures;
+	for (int32 i = 0; i < m_bodyCount; ++i)
+	{
+		const b2BodyState* state = m_bodies + i;
+		b2Body* b = state->body;
+
+		bool moved = memcmp(&b->m_xf, &state->xf, sizeof(b2Transform)) != 0;
+		b->m_xf = state->xf;
+		b->m_sweep = state->sweep;
+		b->m_linearVelocity = state->linearVelocity;
+		b->m_angularVelocity = state->angularVelocity;
+		b->m_force = state->force;
+		b->m_torque = state->torque;
+		b->m_gravityScale = state->gravityScale;
+		b->m_sleepTime = state->sleepTime;
+
+		// The enabled flag is changed through SetEnabled so the proxies follow.
+		bool enabled = (state->flags & b2Body::e_enabledFlag) == b2Body::e_enabledFlag;
+		bool wasEnabled = b->IsEnabled();
+		b->m_flags = (state->flags & ~b2Body::e_enabledFlag) | (b->m_flags & b2Body::e_enabledFlag);
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next, ++fixtureState)
+		{
+			f->m_friction = fixtureState->friction;
+			f->m_restitution = fixtureState->restitution;
+			f->m_restitutionThreshold = fixtureState->restitutionThreshold;
+			f->m_filter = fixtureState->filter;
+			f->m_isSensor = fixtureState->isSensor;
+		}
+
+		if (enabled != wasEnabled)
+		{
+			// Creating proxies buffers them for the pair search
+			b->SetEnabled(enabled);
+			continue;
+		}
+
+		// Static proxies don't need a touch, every pair they are part of is found
+		// by the other proxy querying the static tree.
+		bool touch = b->m_type != b2_staticBody;
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			if (moved)
+			{
+				f->Synchronize(broadPhase, b->m_xf, b->m_xf);
+			}
+
+			for (int32 j = 0; touch && j < f->m_proxyCount; ++j)
+			{
+				broadPhase->TouchProxy(f->m_proxies[j].proxyId);
+			}
+		}
+	}
+
+	contactManager.FindNewContacts();
+	world->m_newContacts = false;
+
+	// Give the touching contacts their manifolds back. A pair created in the other
+	// order starts without warm starting, but keeps its touching state so no begin
+	// event is reported for it.
+	for (int32 i = 0; i < m_contactCount; ++i)
+	{
+		const b2ContactState* state = m_contacts + i;
+		b2Body* bodyA = state->fixtureA->m_body;
+		for (b2ContactEdge* edge = bodyA->m_contactList; edge; edge = edge->next)
+		{
+			b2Contact* contact = edge->contact;
+			bool same = contact->m_fixtureA == state->fixtureA && contact->m_indexA == state->indexA &&
+						contact->m_fixtureB == state->fixtureB && contact->m_indexB == state->indexB;
+			bool swapped = contact->m_fixtureA == state->fixtureB && contact->m_indexA == state->indexB &&
+						contact->m_fixtureB == state->fixtureA && contact->m_indexB == state->indexA;
+			if (same == false && swapped == false)
+			{
+				continue;
+			}
+
+			if (same)
+			{
+				contact->m_manifold = state->manifold;
+			}
+			contact->m_flags = state->flags;
+			contact->m_toiCount = state->toiCount;
+			contact->m_toi = state->toi;
+			contact->m_friction = state->friction;
+			contact->m_restitution = state->restitution;
+			contact->m_restitutionThreshold = state->restitutionThreshold;
+			contact->m_tangentSpeed = state->tangentSpeed;
+			break;
+		}
+	}
+
+	return true;
+}
+
+int32 b2WorldSnapshot::GetByteCount() const
+{
+	return m_bodyCount * sizeof(b2BodyState) + m_fixtureCount * sizeof(b2FixtureState) +
+		m_contactCount * sizeof(b2ContactState);
+}
@@ -0,0 +1,254 @@
+#include "profiler.h"
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <stdio.h>
+#include <vector>
+
+// Hitch traces one session writes at most, and the seconds between two
+#define PROFILER_MAX_HITCH_DUMPS 10
+#define PROFILER_HITCH_COOLDOWN 5.0
+
+struct ProfilerEvent
+{
+    const char *name;
+    Uint64 start;
+    Uint64 end;
+};
+
+// Ring buffer of one recording thread. Only the owner writes: it fills the
+// slot at head, then publishes head + 1. A reader copies the last
+// PROFILER_EVENTS_PER_THREAD events without a lock, reads head again and
+// drops whatever the owner may have overwritten in the meantime
+struct ProfilerThread
+{
+    std::atomic<int> owned;         // 1 while a live thread records here
+    std::atomic<int> id;            // tid in the trace, 0 if never used
+    std::atomic<Uint64> head;       // Events written so far
+    std::atomic<Uint64> firstEvent; // First event of the current owner
+    char name[32];
+    ProfilerEvent events[PROFILER_EVENTS_PER_THREAD];
+
+    // Zones begun and not ended yet, touched by the owner only
+    const char *openNames[PROFILER_MAX_DEPTH];
+    Uint64 openStarts[PROFILER_MAX_DEPTH];
+    int depth;
+};
+
+struct ProfilerCounter
+{
+    const char *name;
+    Uint64 time;
+    double value;
+};
+
+static ProfilerThread threads[PROFILER_MAX_THREADS];
+// Main thread only like the rest of Profiler, so a plain ring
+static ProfilerCounter counters[PROFILER_COUNTER_SAMPLES];
+static Uint64 counterHead = 0;
+static std::atomic<int> nextThreadId(1);
+// Trace timestamps count from here
+static const Uint64 baseCounter = SDL_GetPerformanceCounter();
+
+// Gives the buffer back when its thread exits, so decoder threads that come
+// and go do not run out of slots
+struct ProfilerThreadSlot
+{
+    ProfilerThread *thread = nullptr;
+    bool unrecorded = false; // Every slot was taken when the thread started
+
+    ~ProfilerThreadSlot()
+    {
+        if (thread != nullptr)
+            thread->owned.store(0, std::memory_order_release);
+    }
+};
+static thread_local ProfilerThreadSlot currentThread;
+
+static ProfilerThread *getThread()
+{
+    if (currentThread.thread != nullptr || currentThread.unrecorded)
+        return currentThread.thread;
+
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++)
+    {
+        ProfilerThread *thread = &threads[i];
+        int expected = 0;
+        if (!thread->owned.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+            continue;
+        // The previous owner's events stay behind head but are not exported
+        // under the new name
+        thread->firstEvent.store(thread->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        thread->depth = 0;
+        int id = nextThreadId++;
+        snprintf(thread->name, sizeof(thread->name), "thread %d", id);
+        thread->id.store(id, std::memory_order_release);
+        currentThread.thread = thread;
+        return thread;
+    }
+
+    currentThread.unrecorded = true;
+    SDL_Log("Profiler: All %d thread buffers in use, not recording this thread", PROFILER_MAX_THREADS);
+    return nullptr;
+}
+
+static void record(ProfilerThread *thread, const char *name, Uint64 start, Uint64 end)
+{
+    Uint64 head = thread->head.load(std::memory_order_relaxed);
+    ProfilerEvent &event = thread->events[head % PROFILER_EVENTS_PER_THREAD];
+    event.name = name;
+    event.start = start;
+    event.end = end;
+    thread->head.store(head + 1, std::memory_order_release);
+}
+
+void profilerBeginZone(const char *name)
+{
+    ProfilerThread *thread = getThread();
+    if (thread == nullptr)
+        return;
+    // Zones nested deeper are counted but not recorded, so the ends still pair up
+    if (thread->depth < PROFILER_MAX_DEPTH)
+    {
+        thread->openNames[thread->depth] = name;
+        thread->openStarts[thread->depth] = SDL_GetPerformanceCounter();
+    }
+    thread->depth++;
+}
+
+void profilerEndZone(void)
+{
+    ProfilerThread *thread = getThread();
+    if (thread == nullptr || thread->depth == 0)
+        return;
+    thread->depth--;
+    if (thread->depth < PROFILER_MAX_DEPTH)
+        record(thread, thread->openNames[thread->depth], thread->openStarts[thread->depth], SDL_GetPerformanceCounter());
+}
+
+void profilerSetThreadName(const char *name)
+{
+    ProfilerThread *thread = getThread();
+    if (thread != nullptr)
+        snprintf(thread->name, sizeof(thread->name), "%s", name);
+}
+
+const char *profilerCurrentZone(void)
+{
+    // Not getThread, an allocation must not claim a buffer or log
+    ProfilerThread *thread = currentThread.thread;
+    if (thread == nullptr || thread->depth == 0)
+        return nullptr;
+    return thread->openNames[SDL_min(thread->depth, PROFILER_MAX_DEPTH) - 1];
+}
+
+void Profiler::recordCounter(const char *name, double value)
+{
+    ProfilerCounter &counter = counters[counterHead++ % PROFILER_COUNTER_SAMPLES];
+    counter.name = name;
+    counter.time = SDL_GetPerformanceCounter();
+    counter.value = value;
+}
+
+void Profiler::endFrame()
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (frameStart == 0)
+    {
+        frameStart = now;
+        return;
+    }
+
+    ProfilerThread *thread = getThread();
+    if (thread != nullptr)
+        record(thread, "frame", frameStart, now);
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    double frameMs = (now - frameStart) * 1000.0 / frequency;
+    frameStart = now;
+    if (hitchThreshold <= 0.0 || frameMs < hitchThreshold || hitchDumps >= PROFILER_MAX_HITCH_DUMPS)
+        return;
+    if (lastDump != 0 && now - lastDump < (Uint64)(PROFILER_HITCH_COOLDOWN * frequency))
+        return;
+
+    char path[64];
+    snprintf(path, sizeof(path), "hitch-%u.json", SDL_GetTicks());
+    if (dump(path))
+    {
+        hitchDumps++;
+        SDL_Log("Profiler: %.1f ms frame, trace written to %s", frameMs, path);
+    }
+    lastDump = now;
+    // Writing the trace is not the next frame's fault
+    frameStart = SDL_GetPerformanceCounter();
+}
+
+bool Profiler::dump(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        SDL_Log("Profiler: Could not write %s", path);
+        return false;
+    }
+
+    double toMicroseconds = 1000000.0 / SDL_GetPerformanceFrequency();
+    Uint64 window = (Uint64)(PROFILER_WINDOW_SECONDS * SDL_GetPerformanceFrequency());
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 windowStart = now > window ? now - window : 0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"El Captcha Oscuro\"}}");
+
+    std::vector<ProfilerEvent> events;
+    int eventCount = 0;
+    for (int i = 0; i < PROFILER_MAX_THREADS; i++)
+    {
+        ProfilerThread *thread = &threads[i];
+        int id = thread->id.load(std::memory_order_acquire);
+        if (id == 0)
+            continue;
+
+        Uint64 head = thread->head.load(std::memory_order_acquire);
+        Uint64 first = thread->firstEvent.load(std::memory_order_relaxed);
+        if (head > PROFILER_EVENTS_PER_THREAD)
+            first = SDL_max(first, head - PROFILER_EVENTS_PER_THREAD);
+        events.clear();
+        for (Uint64 index = first; index < head; index++)
+            events.push_back(thread->events[index % PROFILER_EVENTS_PER_THREAD]);
+
+        // Events the owner wrapped around onto while they were copied are torn
+        std::atomic_thread_fence(std::memory_order_acquire);
+        Uint64 after = thread->head.load(std::memory_order_relaxed);
+        size_t skip = 0;
+        if (after >= PROFILER_EVENTS_PER_THREAD && after - PROFILER_EVENTS_PER_THREAD + 1 > first)
+            skip = (size_t)SDL_min(after - PROFILER_EVENTS_PER_THREAD + 1 - first, (Uint64)events.size());
+
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", id,
+                thread->name);
+        for (size_t e = skip; e < events.size(); e++)
+        {
+            const ProfilerEvent &event = events[e];
+            if (event.end < windowStart || event.start < baseCounter)
+                continue;
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", event.name,
+                    id, (event.start - baseCounter) * toMicroseconds, (event.end - event.start) * toMicroseconds);
+            eventCount++;
+        }
+    }
+
+    Uint64 firstCounter = counterHead > PROFILER_COUNTER_SAMPLES ? counterHead - PROFILER_COUNTER_SAMPLES : 0;
+    for (Uint64 index = firstCounter; index < counterHead; index++)
+    {
+        const ProfilerCounter &counter = counters[index % PROFILER_COUNTER_SAMPLES];
+        if (counter.time < windowStart || counter.time < baseCounter)
+            continue;
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"value\":%.15g}}",
+                counter.name, (counter.time - baseCounter) * toMicroseconds, counter.value);
+    }
+
+    fprintf(file, "\n]}\n");
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    SDL_Log("Profiler: %d zones of the last %.0f s written to %s", eventCount, PROFILER_WINDOW_SECONDS, path);
+    return ok;
+}
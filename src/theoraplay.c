@@ -18,18 +18,18 @@
 #ifdef _WIN32
 #include <windows.h>
 #define THEORAPLAY_THREAD_T    HANDLE
-#define THEORAPLAY_MUTEX_T     HANDLE
-#define sleepms(x) Sleep(x)
+#define THEORAPLAY_MUTEX_T     CRITICAL_SECTION *
+#define THEORAPLAY_COND_T      CONDITION_VARIABLE *
 #elif defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
 #define THEORAPLAY_ONLY_SINGLE_THREADED 1
 #define THEORAPLAY_THREAD_T    int
 #define THEORAPLAY_MUTEX_T     int
+#define THEORAPLAY_COND_T      int
 #else
 #include <pthread.h>
-#include <unistd.h>
-#define sleepms(x) usleep((x) * 1000)
 #define THEORAPLAY_THREAD_T    pthread_t
 #define THEORAPLAY_MUTEX_T     pthread_mutex_t *
+#define THEORAPLAY_COND_T      pthread_cond_t *
 #endif
 
 #if defined(__ARM_NEON__) || defined(__ARM_NEON)
@@ -44,6 +44,7 @@
 #include "theora/theoraplay.h"
 #include "theora/theoradec.h"
 #include "vorbis/codec.h"
+#include "profiler.h"
 
 #define THEORAPLAY_INTERNAL 1
 
@@ -52,9 +53,27 @@ typedef THEORAPLAY_AudioPacket AudioPacket;
 
 // !!! FIXME: these all count on the pixel format being TH_PF_420 for now.
 
-typedef unsigned char *(*ConvertVideoFrameFn)(const THEORAPLAY_Allocator *allocator, const th_info *tinfo, const th_ycbcr_buffer ycbcr);
+// Converters write into a buffer of VideoFrameBufferSize() bytes that the
+//  caller got from the frame pool.
+typedef unsigned char *(*ConvertVideoFrameFn)(unsigned char *dst, const th_info *tinfo, const th_ycbcr_buffer ycbcr);
 
-static unsigned char *ConvertVideoFrame420ToYUVPlanar(const THEORAPLAY_Allocator *allocator,
+static unsigned int VideoFrameBufferSize(const THEORAPLAY_VideoFormat vidfmt, const unsigned int w, const unsigned int h)
+{
+    switch (vidfmt)
+    {
+        case THEORAPLAY_VIDFMT_YV12:
+        case THEORAPLAY_VIDFMT_IYUV: return (w * h) + ((w / 2) * (h / 2) * 2);
+        case THEORAPLAY_VIDFMT_RGB: return w * h * 3;
+        case THEORAPLAY_VIDFMT_RGBA:
+        case THEORAPLAY_VIDFMT_BGRA: return w * h * 4;
+        case THEORAPLAY_VIDFMT_RGB565: return w * h * 2;
+    } // switch
+    return 0;
+} // VideoFrameBufferSize
+
+// Copies the picture region into three separate planes with their own pitch,
+//  which is what a locked streaming texture hands us.
+static void ConvertVideoFrame420ToYUVPlanes(unsigned char *const *planes, const int *pitches,
                             const th_info *tinfo, const th_ycbcr_buffer ycbcr,
                             const int p0, const int p1, const int p2)
 {
@@ -63,7 +82,6 @@ static unsigned char *ConvertVideoFrame420ToYUVPlanar(const THEORAPLAY_Allocator
     const int h = tinfo->pic_height;
     const int yoff = (tinfo->pic_x & ~1) + ycbcr[0].stride * (tinfo->pic_y & ~1);
     const int uvoff = (tinfo->pic_x / 2) + (ycbcr[1].stride) * (tinfo->pic_y / 2);
-    unsigned char *yuv = (unsigned char *) allocator->allocate(allocator, w * h * 2);
     const unsigned char *p0data = ycbcr[p0].data + yoff;
     const int p0stride = ycbcr[p0].stride;
     const unsigned char *p1data = ycbcr[p1].data + uvoff;
@@ -71,30 +89,43 @@ static unsigned char *ConvertVideoFrame420ToYUVPlanar(const THEORAPLAY_Allocator
     const unsigned char *p2data = ycbcr[p2].data + uvoff;
     const int p2stride = ycbcr[p2].stride;
 
-    if (yuv)
-    {
-        unsigned char *dst = yuv;
-        for (i = 0; i < h; i++, dst += w)
-            memcpy(dst, p0data + (p0stride * i), w);
-        for (i = 0; i < (h / 2); i++, dst += w/2)
-            memcpy(dst, p1data + (p1stride * i), w / 2);
-        for (i = 0; i < (h / 2); i++, dst += w/2)
-            memcpy(dst, p2data + (p2stride * i), w / 2);
-    } // if
+    for (i = 0; i < h; i++)
+        memcpy(planes[0] + (pitches[0] * i), p0data + (p0stride * i), w);
+    for (i = 0; i < (h / 2); i++)
+        memcpy(planes[1] + (pitches[1] * i), p1data + (p1stride * i), w / 2);
+    for (i = 0; i < (h / 2); i++)
+        memcpy(planes[2] + (pitches[2] * i), p2data + (p2stride * i), w / 2);
+} // ConvertVideoFrame420ToYUVPlanes
+
 
+static unsigned char *ConvertVideoFrame420ToYUVPlanar(unsigned char *yuv,
+                            const th_info *tinfo, const th_ycbcr_buffer ycbcr,
+                            const int p0, const int p1, const int p2)
+{
+    const int w = tinfo->pic_width;
+    const int h = tinfo->pic_height;
+    unsigned char *planes[3];
+    int pitches[3];
+
+    planes[0] = yuv;
+    planes[1] = planes[0] + (w * h);
+    planes[2] = planes[1] + ((w / 2) * (h / 2));
+    pitches[0] = w;
+    pitches[1] = pitches[2] = w / 2;
+    ConvertVideoFrame420ToYUVPlanes(planes, pitches, tinfo, ycbcr, p0, p1, p2);
     return yuv;
 } // ConvertVideoFrame420ToYUVPlanar
 
 
-static unsigned char *ConvertVideoFrame420ToYV12(const THEORAPLAY_Allocator *allocator, const th_info *tinfo, const th_ycbcr_buffer ycbcr)
+static unsigned char *ConvertVideoFrame420ToYV12(unsigned char *dst, const th_info *tinfo, const th_ycbcr_buffer ycbcr)
 {
-    return ConvertVideoFrame420ToYUVPlanar(allocator, tinfo, ycbcr, 0, 2, 1);
+    return ConvertVideoFrame420ToYUVPlanar(dst, tinfo, ycbcr, 0, 2, 1);
 } // ConvertVideoFrame420ToYV12
 
 
-static unsigned char *ConvertVideoFrame420ToIYUV(const THEORAPLAY_Allocator *allocator, const th_info *tinfo, const th_ycbcr_buffer ycbcr)
+static unsigned char *ConvertVideoFrame420ToIYUV(unsigned char *dst, const th_info *tinfo, const th_ycbcr_buffer ycbcr)
 {
-    return ConvertVideoFrame420ToYUVPlanar(allocator, tinfo, ycbcr, 0, 1, 2);
+    return ConvertVideoFrame420ToYUVPlanar(dst, tinfo, ycbcr, 0, 1, 2);
 } // ConvertVideoFrame420ToIYUV
 
 
@@ -206,20 +237,88 @@ static unsigned char *ConvertVideoFrame420ToIYUV(const THEORAPLAY_Allocator *all
 #endif
 #include "theora/theoraplay_cvtrgb.h"
 
+// Video frames come out of a recycled pool, so steady-state playback doesn't
+//  touch the allocator at all. Each pool buffer is a single allocation: the
+//  VideoFrame, some bookkeeping, then the pixels. Buffers are grouped into
+//  size classes (four steps per power of two) and the whole pool is bounded
+//  by a byte budget instead of a frame count.
+#define FRAMEPOOL_NUM_CLASSES 128
+
+typedef struct FramePoolItem
+{
+    VideoFrame frame;  // must be first! THEORAPLAY_freeVideo casts back to this.
+    struct TheoraDecoder *owner;
+    unsigned int sizeclass;
+    unsigned int capacity;
+    struct FramePoolItem *nextfree;
+} FramePoolItem;
+
+#define FRAMEPOOL_HEADER_SIZE ((sizeof (FramePoolItem) + 15) & ~((size_t) 15))
+
+// Max app-provided planes (THEORAPLAY_submitVideoTarget) waiting to be filled.
+#define MAX_VIDEO_TARGETS 8
+
+// Multithreaded decoding is a pipeline. The worker thread demuxes Ogg pages
+//  into a packet queue per stream, a video thread runs the Theora decoder and
+//  an audio thread runs Vorbis synthesis. For the packed RGB formats a fourth
+//  thread does the colorspace conversion, so it overlaps with decoding the
+//  next frame. Every queue is bounded: a stalled stage pushes back on the
+//  ones feeding it instead of buffering without limit.
+#define PIPELINE_MAX_PACKETS 64
+#define PIPELINE_MAX_RAW_FRAMES 4
+
+typedef struct PipelineItem
+{
+    ogg_packet packet;  // a copy; packet.packet points into buf.
+    unsigned char *buf;
+    long bufcap;
+    VideoFrame *frame;  // raw YUV frame on its way to the convert stage.
+    int is_seek;  // marker: everything after this is for a new seek target.
+    unsigned int seek_generation;
+    unsigned long seek_target;
+    struct PipelineItem *next;
+} PipelineItem;
+
+typedef struct PipelineQueue
+{
+    THEORAPLAY_MUTEX_T lock;
+    THEORAPLAY_COND_T cond;  // broadcast whenever anything changes.
+    PipelineItem *head;
+    PipelineItem *tail;
+    PipelineItem *freelist;
+    unsigned int count;
+    unsigned int maxcount;
+    int eos;  // the producer is done, consumer drains and quits.
+} PipelineQueue;
+
 // !!! FIXME: these volatiles really need to become atomics.
 typedef struct TheoraDecoder
 {
     // Thread wrangling...
     int thread_created;
     THEORAPLAY_MUTEX_T lock;
+    THEORAPLAY_COND_T cond;  // video output space (pool bytes or targets) freed up.
     volatile int halt;
     int thread_done;
     THEORAPLAY_THREAD_T worker;
 
+    // Pipeline stages, only when multithreaded. worker is the demuxer.
+    PipelineQueue videoqueue;
+    PipelineQueue audioqueue;
+    PipelineQueue convertqueue;
+    int convert_stage;
+    int videoworker_created;
+    int audioworker_created;
+    int convertworker_created;
+    THEORAPLAY_THREAD_T videoworker;
+    THEORAPLAY_THREAD_T audioworker;
+    THEORAPLAY_THREAD_T convertworker;
+    volatile int stage_error;
+
     // API state...
     THEORAPLAY_Allocator allocator;
     THEORAPLAY_Io *io;
-    unsigned int maxframes;  // Max video frames to buffer.
+    unsigned int maxframes;  // Default pool budget, in frames.
     volatile unsigned int prepped;
     volatile unsigned int videocount;  // currently buffered frames.
     volatile unsigned int audioms;  // currently buffered audio samples.
@@ -229,6 +328,20 @@ typedef struct TheoraDecoder
     volatile unsigned int seek_generation;
     volatile unsigned long new_seek_position_ms;
 
+    // Frame pool, all protected by lock.
+    FramePoolItem *pool_free[FRAMEPOOL_NUM_CLASSES];
+    unsigned int pool_maxbytes;  // 0 until the first frame sizes it from maxframes.
+    unsigned int pool_livebytes;  // queued or held by the app.
+    unsigned int pool_freebytes;  // sitting in pool_free, ready for reuse.
+    int pool_orphaned;  // stopDecode ran while the app still held frames.
+
+    // Zero-copy targets, protected by lock. Once the app submits one we
+    //  decode straight into its planes and throttle on targets, not the pool.
+    THEORAPLAY_VideoTarget targets[MAX_VIDEO_TARGETS];
+    unsigned int targethead;
+    unsigned int targetcount;
+    int target_mode;
+
     THEORAPLAY_VideoFormat vidfmt;
     ConvertVideoFrameFn vidcvt;
 
@@ -274,9 +387,9 @@ typedef struct TheoraDecoder
 
 
 #if THEORAPLAY_ONLY_SINGLE_THREADED
-static inline int Thread_Create(TheoraDecoder *ctx, void *(*routine) (void*))
+static inline int Thread_Create(TheoraDecoder *ctx, THEORAPLAY_THREAD_T *thread, void *(*routine) (void*))
 {
-    ctx->worker = 0;
+    *thread = 0;
     return -1;
 }
 static inline void Thread_Join(THEORAPLAY_THREAD_T thread)
@@ -295,10 +408,23 @@ static inline void Mutex_Lock(THEORAPLAY_MUTEX_T mutex)
 static inline void Mutex_Unlock(THEORAPLAY_MUTEX_T mutex)
 {
 }
+static inline THEORAPLAY_COND_T Cond_Create(TheoraDecoder *ctx)
+{
+    return (THEORAPLAY_COND_T) (size_t) 0x0001;
+}
+static inline void Cond_Destroy(TheoraDecoder *ctx, THEORAPLAY_COND_T cond)
+{
+}
+static inline void Cond_Wait(THEORAPLAY_COND_T cond, THEORAPLAY_MUTEX_T mutex)
+{
+}
+static inline void Cond_Broadcast(THEORAPLAY_COND_T cond)
+{
+}
 #elif defined(_WIN32)
-static inline int Thread_Create(TheoraDecoder *ctx, void *(*routine) (void*))
+static inline int Thread_Create(TheoraDecoder *ctx, THEORAPLAY_THREAD_T *thread, void *(*routine) (void*))
 {
-    ctx->worker = CreateThread(
+    *thread = CreateThread(
         NULL,
         0,
         (LPTHREAD_START_ROUTINE) routine,
@@ -306,33 +432,60 @@ static inline int Thread_Create(TheoraDecoder *ctx, void *(*routine) (void*))
         0,
         NULL
     );
-    return (ctx->worker == NULL);
+    return (*thread == NULL);
 }
 static inline void Thread_Join(THEORAPLAY_THREAD_T thread)
 {
     WaitForSingleObject(thread, INFINITE);
     CloseHandle(thread);
 }
+// critical sections rather than mutex handles, so condition variables work with them.
 static inline THEORAPLAY_MUTEX_T Mutex_Create(TheoraDecoder *ctx)
 {
-    return CreateMutex(NULL, FALSE, NULL);
+    THEORAPLAY_MUTEX_T retval = (THEORAPLAY_MUTEX_T) ctx->allocator.allocate(&ctx->allocator, sizeof (*retval));
+    if (retval)
+        InitializeCriticalSection(retval);
+    return retval;
 }
 static inline void Mutex_Destroy(TheoraDecoder *ctx, THEORAPLAY_MUTEX_T mutex)
 {
-    CloseHandle(mutex);
+    if (mutex) {
+        DeleteCriticalSection(mutex);
+        ctx->allocator.deallocate(&ctx->allocator, mutex);
+    }
 }
 static inline void Mutex_Lock(THEORAPLAY_MUTEX_T mutex)
 {
-    WaitForSingleObject(mutex, INFINITE);
+    EnterCriticalSection(mutex);
 }
 static inline void Mutex_Unlock(THEORAPLAY_MUTEX_T mutex)
 {
-    ReleaseMutex(mutex);
+    LeaveCriticalSection(mutex);
+}
+static inline THEORAPLAY_COND_T Cond_Create(TheoraDecoder *ctx)
+{
+    THEORAPLAY_COND_T retval = (THEORAPLAY_COND_T) ctx->allocator.allocate(&ctx->allocator, sizeof (*retval));
+    if (retval)
+        InitializeConditionVariable(retval);
+    return retval;
+}
+static inline void Cond_Destroy(TheoraDecoder *ctx, THEORAPLAY_COND_T cond)
+{
+    if (cond)
+        ctx->allocator.deallocate(&ctx->allocator, cond);
+}
+static inline void Cond_Wait(THEORAPLAY_COND_T cond, THEORAPLAY_MUTEX_T mutex)
+{
+    SleepConditionVariableCS(cond, mutex, INFINITE);
+}
+static inline void Cond_Broadcast(THEORAPLAY_COND_T cond)
+{
+    WakeAllConditionVariable(cond);
 }
 #else
-static inline int Thread_Create(TheoraDecoder *ctx, void *(*routine) (void*))
+static inline int Thread_Create(TheoraDecoder *ctx, THEORAPLAY_THREAD_T *thread, void *(*routine) (void*))
 {
-    return pthread_create(&ctx->worker, NULL, routine, ctx);
+    return pthread_create(thread, NULL, routine, ctx);
 }
 static inline void Thread_Join(THEORAPLAY_THREAD_T thread)
 {
@@ -364,9 +517,158 @@ static inline void Mutex_Unlock(THEORAPLAY_MUTEX_T mutex)
 {
     pthread_mutex_unlock(mutex);
 }
+static inline THEORAPLAY_COND_T Cond_Create(TheoraDecoder *ctx)
+{
+    THEORAPLAY_COND_T retval = (THEORAPLAY_COND_T) ctx->allocator.allocate(&ctx->allocator, sizeof (*retval));
+    if (retval) {
+        if (pthread_cond_init(retval, NULL) != 0) {
+            ctx->allocator.deallocate(&ctx->allocator, retval);
+            retval = NULL;
+        }
+    }
+    return retval;
+}
+static inline void Cond_Destroy(TheoraDecoder *ctx, THEORAPLAY_COND_T cond)
+{
+    if (cond) {
+        pthread_cond_destroy(cond);
+        ctx->allocator.deallocate(&ctx->allocator, cond);
+    }
+}
+static inline void Cond_Wait(THEORAPLAY_COND_T cond, THEORAPLAY_MUTEX_T mutex)
+{
+    pthread_cond_wait(cond, mutex);
+}
+static inline void Cond_Broadcast(THEORAPLAY_COND_T cond)
+{
+    pthread_cond_broadcast(cond);
+}
 #endif
 
 
+static unsigned int FramePool_SizeClass(const unsigned int len, unsigned int *capacity)
+{
+    unsigned int step, rounded;
+    int bit = 0;
+
+    if (len <= 16)
+    {
+        *capacity = 16;
+        return 0;
+    } // if
+
+    while (((len - 1) >> bit) > 1)
+        bit++;  // 2^bit < len <= 2^(bit+1)
+
+    step = 1u << (bit - 2);
+    rounded = (len + step - 1) & ~(step - 1);
+    *capacity = rounded;
+    return 1 + ((bit - 4) * 4) + ((rounded / step) - 5);
+} // FramePool_SizeClass
+
+
+// call with ctx->lock held.
+static int VideoOutputFull(const TheoraDecoder *ctx)
+{
+    if (ctx->target_mode)
+        return (ctx->targetcount == 0);
+    return (ctx->pool_maxbytes != 0) && (ctx->pool_livebytes >= ctx->pool_maxbytes);
+} // VideoOutputFull
+
+
+static VideoFrame *FramePool_Get(TheoraDecoder *ctx, const unsigned int len)
+{
+    unsigned int capacity;
+    const unsigned int sizeclass = FramePool_SizeClass(len, &capacity);
+    FramePoolItem *item;
+
+    Mutex_Lock(ctx->lock);
+    if (ctx->pool_maxbytes == 0)  // size the default budget by output frames, whatever len is.
+    {
+        unsigned int framecapacity;
+        FramePool_SizeClass(VideoFrameBufferSize(ctx->vidfmt, ctx->tinfo.pic_width, ctx->tinfo.pic_height), &framecapacity);
+        ctx->pool_maxbytes = framecapacity * (ctx->maxframes ? ctx->maxframes : 1);
+    } // if
+    item = ctx->pool_free[sizeclass];
+    if (item)
+    {
+        ctx->pool_free[sizeclass] = item->nextfree;
+        ctx->pool_freebytes -= capacity;
+    } // if
+    ctx->pool_livebytes += capacity;
+    Mutex_Unlock(ctx->lock);
+
+    if (item == NULL)
+    {
+        item = (FramePoolItem *) ctx->allocator.allocate(&ctx->allocator, (unsigned int) (FRAMEPOOL_HEADER_SIZE + capacity));
+        if (item == NULL)
+        {
+            Mutex_Lock(ctx->lock);
+            ctx->pool_livebytes -= capacity;
+            Mutex_Unlock(ctx->lock);
+            return NULL;
+        } // if
+        item->owner = ctx;
+        item->sizeclass = sizeclass;
+        item->capacity = capacity;
+    } // if
+
+    item->nextfree = NULL;
+    item->frame.pixels = ((unsigned char *) item) + FRAMEPOOL_HEADER_SIZE;
+    item->frame.next = NULL;
+    return &item->frame;
+} // FramePool_Get
+
+
+// call with ctx->lock held.
+static void FramePool_Put(TheoraDecoder *ctx, FramePoolItem *item)
+{
+    assert(ctx->pool_livebytes >= item->capacity);
+    ctx->pool_livebytes -= item->capacity;
+
+    // keep it around unless that would put the pool over budget.
+    if ((ctx->pool_livebytes + ctx->pool_freebytes + item->capacity) > ctx->pool_maxbytes)
+        ctx->allocator.deallocate(&ctx->allocator, item);
+    else
+    {
+        item->nextfree = ctx->pool_free[item->sizeclass];
+        ctx->pool_free[item->sizeclass] = item;
+        ctx->pool_freebytes += item->capacity;
+    } // else
+
+    Cond_Broadcast(ctx->cond);  // the video stage may be waiting for room.
+} // FramePool_Put
+
+
+// call with ctx->lock held.
+static void FramePool_Drain(TheoraDecoder *ctx)
+{
+    int i;
+    for (i = 0; i < FRAMEPOOL_NUM_CLASSES; i++)
+    {
+        FramePoolItem *item = ctx->pool_free[i];
+        while (item)
+        {
+            FramePoolItem *next = item->nextfree;
+            ctx->allocator.deallocate(&ctx->allocator, item);
+            item = next;
+        } // while
+        ctx->pool_free[i] = NULL;
+    } // for
+    ctx->pool_freebytes = 0;
+} // FramePool_Drain
+
+
+static void FreeDecoderShell(TheoraDecoder *ctx)
+{
+    THEORAPLAY_Allocator allocator;
+    memcpy(&allocator, &ctx->allocator, sizeof (THEORAPLAY_Allocator));
+    Cond_Destroy(ctx, ctx->cond);
+    Mutex_Destroy(ctx, ctx->lock);
+    allocator.deallocate(&allocator, ctx);
+} // FreeDecoderShell
+
+
 static int FeedMoreOggData(THEORAPLAY_Io *io, ogg_sync_state *sync)
 {
     long buflen = 4096;
@@ -532,122 +834,282 @@ cleanup:  // we will do actual cleanup when closing the decoder.
     return;
 }
 
-// This massive function is where all the effort happens.
-static int PumpDecoder(TheoraDecoder *ctx, int desired_frames)
+// Binary searches the stream for a page shortly before the requested seek
+//  position. Returns zero on i/o errors.
+static int SeekStream(TheoraDecoder *ctx, unsigned long *_targetms)
 {
-    int had_new_video_frames = 0;
+    unsigned long targetms;
+    long seekpos;
+    long lo, hi;
+    int found = 0;
 
-    if (!ctx->prepped)
+    if (!ctx->io->seek)
+        return 0;  // seeking unsupported.
+
+    if (ctx->streamlen == -1)  // just check this once in case it's expensive.
     {
-        PrepareDecoder(ctx);
-        return 0;
+        ctx->streamlen = ctx->io->streamlen ? ctx->io->streamlen(ctx->io) : -1;
+        if (ctx->streamlen == -1)
+            return 0;  // i/o error, unsupported, etc.
     } // if
 
-    if (ctx->thread_done)
-        return 0;
+    // We check ctx->seek_generation without a lock as this goes on, so if they mismatch we
+    //  drop what we're doing and prepare to seek to a new location. But here we hold a lock
+    //  so we can avoid the race condition where the app is halfway through requesting a
+    //  seek while we're reading in these variables.
+    Mutex_Lock(ctx->lock);
+    ctx->current_seek_generation = ctx->seek_generation;
+    targetms = ctx->new_seek_position_ms;
+    Mutex_Unlock(ctx->lock);
 
-    while (!ctx->halt && !ctx->eos && (desired_frames > 0))
+    lo = 0;
+    hi = ctx->streamlen;
+
+    if (targetms < 1000)
+        hi = 0;  /* as an optimization, just jump to the start of file if seeking within the first second, instead of binary searching. */
+
+    seekpos = (lo / 2) + (hi / 2);
+
+    while ((!ctx->halt) && (ctx->current_seek_generation == ctx->seek_generation))
     {
-        int need_pages = 0;  // need more Ogg pages?
+        //const int max_keyframe_distance = 1 << ctx->tinfo.keyframe_granule_shift;
 
-        if (ctx->current_seek_generation != ctx->seek_generation)  // seek requested
-        {
-            unsigned long targetms;
-            long seekpos;
-            long lo, hi;
-            int found = 0;
+        // Do a binary search through the stream to find our starting point.
+        // This idea came from libtheoraplayer (no relation to theoraplay).
+        if (ctx->io->seek(ctx->io, seekpos) == -1)
+            return 0;  // oh well.
 
-            if (!ctx->io->seek)
-                goto cleanup;  // seeking unsupported.
+        ctx->granulepos = -1;
+        ogg_sync_reset(&ctx->sync);
+        memset(&ctx->page, '\0', sizeof (ctx->page));
+        ogg_sync_pageseek(&ctx->sync, &ctx->page);
 
-            if (ctx->streamlen == -1)  // just check this once in case it's expensive.
+        while (!ctx->halt && (ctx->current_seek_generation == ctx->seek_generation))
+        {
+            if (ogg_sync_pageout(&ctx->sync, &ctx->page) != 1)
             {
-                ctx->streamlen = ctx->io->streamlen ? ctx->io->streamlen(ctx->io) : -1;
-                if (ctx->streamlen == -1)
-                    goto cleanup;  // i/o error, unsupported, etc.
+                if (FeedMoreOggData(ctx->io, &ctx->sync) <= 0)
+                    return 0;
+                continue;
             } // if
 
-            // We check ctx->seek_generation without a lock as this goes on, so if they mismatch we
-            //  drop what we're doing and prepare to seek to a new location. But here we hold a lock
-            //  so we can avoid the race condition where the app is halfway through requesting a
-            //  seek while we're reading in these variables.
-            Mutex_Lock(ctx->lock);
-            ctx->current_seek_generation = ctx->seek_generation;
-            targetms = ctx->new_seek_position_ms;
+            ctx->granulepos = ogg_page_granulepos(&ctx->page);
+            if (ctx->granulepos >= 0)
+            {
+                const int serialno = ogg_page_serialno(&ctx->page);
+                unsigned long ms;
+
+                // (the granule time calls only read stream info that never changes
+                //  after setup, so this is safe while the pipeline stages decode.)
+                if (ctx->tpackets)  // always tee off video frames if possible.
+                {
+                    if (serialno != ctx->tserialno)
+                        continue;
+                    ms = (unsigned long) (th_granule_time(ctx->tdec, ctx->granulepos) * 1000.0);
+                } // else
+                else
+                {
+                    if (serialno != ctx->vserialno)
+                        continue;
+                    ms = (unsigned long) (vorbis_granule_time(&ctx->vdsp, ctx->granulepos) * 1000.0);
+                } // else
+
+                if ((ms < targetms) && ((targetms - ms) >= 500) && ((targetms - ms) <= 1000))   // !!! FIXME: tweak this number?
+                    found = 1;  // found something close enough to the target!
+                else  // adjust binary search position and try again.
+                {
+                    const long newpos = (lo / 2) + (hi / 2);
+                    if (targetms > ms)
+                        lo = newpos;
+                    else
+                        hi = newpos;
+                } // else
+                break;
+            } // if
+        } // while
+
+        if (found)
+            break;
+
+        const long newseekpos = (lo / 2) + (hi / 2);
+        if (seekpos == newseekpos)
+            break;  // we did the best we could, just go from here.
+        seekpos = newseekpos;
+    } // while
+
+    *_targetms = targetms;
+    return 1;
+} // SeekStream
+
+
+static void AppendVideoFrame(TheoraDecoder *ctx, VideoFrame *item)
+{
+    Mutex_Lock(ctx->lock);
+    if (ctx->videolisttail)
+    {
+        assert(ctx->videolist);
+        ctx->videolisttail->next = item;
+    } // if
+    else
+    {
+        assert(!ctx->videolist);
+        ctx->videolist = item;
+    } // else
+    ctx->videolisttail = item;
+    ctx->videocount++;
+    Mutex_Unlock(ctx->lock);
+} // AppendVideoFrame
+
+
+static int PipelineQueue_PushFrame(TheoraDecoder *ctx, PipelineQueue *q, VideoFrame *frame);
+
+// Hands a decoded picture on: into an app target, a pool buffer, or (for the
+//  RGB formats when pipelined) to the convert stage as raw YUV. Returns zero
+//  if we ran out of memory.
+static int EmitVideoFrame(TheoraDecoder *ctx, th_ycbcr_buffer ycbcr, const unsigned int playms, const unsigned int generation)
+{
+    THEORAPLAY_VideoTarget target;
+    int have_target = 0;
+    unsigned int len;
+    VideoFrame *item;
+
+    if (ctx->convert_stage)
+    {
+        len = VideoFrameBufferSize(THEORAPLAY_VIDFMT_IYUV, ctx->tinfo.pic_width, ctx->tinfo.pic_height);
+        item = FramePool_Get(ctx, len);
+        if (item == NULL)
+            return 0;
+        item->seek_generation = generation;
+        item->playms = playms;
+        item->fps = ctx->fps;
+        item->width = ctx->tinfo.pic_width;
+        item->height = ctx->tinfo.pic_height;
+        item->format = THEORAPLAY_VIDFMT_IYUV;
+        item->target = NULL;
+        ConvertVideoFrame420ToIYUV(item->pixels, &ctx->tinfo, ycbcr);
+        if (!PipelineQueue_PushFrame(ctx, &ctx->convertqueue, item))
+        {
+            Mutex_Lock(ctx->lock);  // shutting down, nobody wants it.
+            FramePool_Put(ctx, (FramePoolItem *) item);
             Mutex_Unlock(ctx->lock);
+        } // if
+        return 1;
+    } // if
+
+    Mutex_Lock(ctx->lock);
+    if (ctx->targetcount > 0)
+    {
+        memcpy(&target, &ctx->targets[ctx->targethead], sizeof (target));
+        ctx->targethead = (ctx->targethead + 1) % MAX_VIDEO_TARGETS;
+        ctx->targetcount--;
+        have_target = 1;
+    } // if
+    Mutex_Unlock(ctx->lock);
+
+    // with a target, the pool only supplies the frame header.
+    len = have_target ? 0 : VideoFrameBufferSize(ctx->vidfmt, ctx->tinfo.pic_width, ctx->tinfo.pic_height);
+    item = FramePool_Get(ctx, len);
+    if (item == NULL)
+        return 0;
+    item->seek_generation = generation;
+    item->playms = playms;
+    item->fps = ctx->fps;
+    item->width = ctx->tinfo.pic_width;
+    item->height = ctx->tinfo.pic_height;
+    item->format = ctx->vidfmt;
+    if (have_target)
+    {
+        const int swap_uv = (ctx->vidfmt == THEORAPLAY_VIDFMT_YV12);
+        ConvertVideoFrame420ToYUVPlanes(target.planes, target.pitches, &ctx->tinfo, ycbcr, 0, swap_uv ? 2 : 1, swap_uv ? 1 : 2);
+        item->pixels = NULL;
+        item->target = target.userdata;
+    } // if
+    else
+    {
+        ctx->vidcvt(item->pixels, &ctx->tinfo, ycbcr);
+        item->target = NULL;
+    } // else
 
-            lo = 0;
-            hi = ctx->streamlen;
+    //printf("Decoded another video frame.\n");
+    AppendVideoFrame(ctx, item);
+    return 1;
+} // EmitVideoFrame
 
-            if (targetms < 1000)
-                hi = 0;  /* as an optimization, just jump to the start of file if seeking within the first second, instead of binary searching. */
 
-            seekpos = (lo / 2) + (hi / 2);
+// Returns zero if we ran out of memory.
+static int EmitAudioPacket(TheoraDecoder *ctx, float **pcm, const int frames, const unsigned int playms, const unsigned int generation)
+{
+    const int channels = ctx->vinfo.channels;
+    int chanidx, frameidx;
+    float *samples;
+    AudioPacket *item = (AudioPacket *) ctx->allocator.allocate(&ctx->allocator, sizeof (AudioPacket));
+    if (item == NULL)
+        return 0;
+    item->seek_generation = generation;
+    item->playms = playms;
+    item->channels = channels;
+    item->freq = ctx->vinfo.rate;
+    item->frames = frames;
+    item->samples = (float *) ctx->allocator.allocate(&ctx->allocator, sizeof (float) * frames * channels);
+    item->next = NULL;
+
+    if (item->samples == NULL)
+    {
+        ctx->allocator.deallocate(&ctx->allocator, item);
+        return 0;
+    } // if
 
-            while ((!ctx->halt) && (ctx->current_seek_generation == ctx->seek_generation))
-            {
-                //const int max_keyframe_distance = 1 << ctx->tinfo.keyframe_granule_shift;
+    // I bet this beats the crap out of the CPU cache...
+    samples = item->samples;
+    for (frameidx = 0; frameidx < frames; frameidx++)
+    {
+        for (chanidx = 0; chanidx < channels; chanidx++)
+            *(samples++) = pcm[chanidx][frameidx];
+    } // for
 
-                // Do a binary search through the stream to find our starting point.
-                // This idea came from libtheoraplayer (no relation to theoraplay).
-                if (ctx->io->seek(ctx->io, seekpos) == -1)
-                    goto cleanup;  // oh well.
+    //printf("Decoded %d frames of audio.\n", (int) frames);
+    Mutex_Lock(ctx->lock);
+    ctx->audioms += item->playms;
+    if (ctx->audiolisttail)
+    {
+        assert(ctx->audiolist);
+        ctx->audiolisttail->next = item;
+    } // if
+    else
+    {
+        assert(!ctx->audiolist);
+        ctx->audiolist = item;
+    } // else
+    ctx->audiolisttail = item;
+    Mutex_Unlock(ctx->lock);
+    return 1;
+} // EmitAudioPacket
 
-                ctx->granulepos = -1;
-                ogg_sync_reset(&ctx->sync);
-                memset(&ctx->page, '\0', sizeof (ctx->page));
-                ogg_sync_pageseek(&ctx->sync, &ctx->page);
 
-                while (!ctx->halt && (ctx->current_seek_generation == ctx->seek_generation))
-                {
-                    if (ogg_sync_pageout(&ctx->sync, &ctx->page) != 1)
-                    {
-                        if (FeedMoreOggData(ctx->io, &ctx->sync) <= 0)
-                            goto cleanup;
-                        continue;
-                    } // if
+// This massive function is where all the effort happens.
+//  (Single-threaded decoders only; multithreaded ones run the pipeline below.)
+static int PumpDecoder(TheoraDecoder *ctx, int desired_frames)
+{
+    int had_new_video_frames = 0;
 
-                    ctx->granulepos = ogg_page_granulepos(&ctx->page);
-                    if (ctx->granulepos >= 0)
-                    {
-                        const int serialno = ogg_page_serialno(&ctx->page);
-                        unsigned long ms;
+    if (!ctx->prepped)
+    {
+        PrepareDecoder(ctx);
+        return 0;
+    } // if
 
-                        if (ctx->tpackets)  // always tee off video frames if possible.
-                        {
-                            if (serialno != ctx->tserialno)
-                                continue;
-                            ms = (unsigned long) (th_granule_time(ctx->tdec, ctx->granulepos) * 1000.0);
-                        } // else
-                        else
-                        {
-                            if (serialno != ctx->vserialno)
-                                continue;
-                            ms = (unsigned long) (vorbis_granule_time(&ctx->vdsp, ctx->granulepos) * 1000.0);
-                        } // else
-
-                        if ((ms < targetms) && ((targetms - ms) >= 500) && ((targetms - ms) <= 1000))   // !!! FIXME: tweak this number?
-                            found = 1;  // found something close enough to the target!
-                        else  // adjust binary search position and try again.
-                        {
-                            const long newpos = (lo / 2) + (hi / 2);
-                            if (targetms > ms)
-                                lo = newpos;
-                            else
-                                hi = newpos;
-                        } // else
-                        break;
-                    } // if
-                } // while
+    if (ctx->thread_done)
+        return 0;
 
-                if (found)
-                    break;
+    while (!ctx->halt && !ctx->eos && (desired_frames > 0))
+    {
+        int need_pages = 0;  // need more Ogg pages?
 
-                const long newseekpos = (lo / 2) + (hi / 2);
-                if (seekpos == newseekpos)
-                    break;  // we did the best we could, just go from here.
-                seekpos = newseekpos;
-            } // while
+        if (ctx->current_seek_generation != ctx->seek_generation)  // seek requested
+        {
+            unsigned long targetms;
+            if (!SeekStream(ctx, &targetms))
+                goto cleanup;
 
             // at this point, we have seek'd to something reasonably close to our target. Now decode until we're as close as possible to it.
             vorbis_synthesis_restart(&ctx->vdsp);
@@ -682,48 +1144,8 @@ static int PumpDecoder(TheoraDecoder *ctx, int desired_frames)
             {
                 if (!ctx->resolving_audio_seek)
                 {
-                    const int channels = ctx->vinfo.channels;
-                    int chanidx, frameidx;
-                    float *samples;
-                    AudioPacket *item = (AudioPacket *) ctx->allocator.allocate(&ctx->allocator, sizeof (AudioPacket));
-                    if (item == NULL) goto cleanup;
-                    item->seek_generation = ctx->current_seek_generation;
-                    item->playms = playms;
-                    item->channels = channels;
-                    item->freq = ctx->vinfo.rate;
-                    item->frames = frames;
-                    item->samples = (float *) ctx->allocator.allocate(&ctx->allocator, sizeof (float) * frames * channels);
-                    item->next = NULL;
-
-                    if (item->samples == NULL)
-                    {
-                        free(item);
+                    if (!EmitAudioPacket(ctx, pcm, frames, playms, ctx->current_seek_generation))
                         goto cleanup;
-                    } // if
-
-                    // I bet this beats the crap out of the CPU cache...
-                    samples = item->samples;
-                    for (frameidx = 0; frameidx < frames; frameidx++)
-                    {
-                        for (chanidx = 0; chanidx < channels; chanidx++)
-                            *(samples++) = pcm[chanidx][frameidx];
-                    } // for
-
-                    //printf("Decoded %d frames of audio.\n", (int) frames);
-                    Mutex_Lock(ctx->lock);
-                    ctx->audioms += item->playms;
-                    if (ctx->audiolisttail)
-                    {
-                        assert(ctx->audiolist);
-                        ctx->audiolisttail->next = item;
-                    } // if
-                    else
-                    {
-                        assert(!ctx->audiolist);
-                        ctx->audiolist = item;
-                    } // else
-                    ctx->audiolisttail = item;
-                    Mutex_Unlock(ctx->lock);
                 } // if
 
                 vorbis_synthesis_read(&ctx->vdsp, frames);  // we ate everything.
@@ -773,42 +1195,14 @@ static int PumpDecoder(TheoraDecoder *ctx, int desired_frames)
                         th_ycbcr_buffer ycbcr;
                         if (th_decode_ycbcr_out(ctx->tdec, ycbcr) == 0)
                         {
-                            VideoFrame *item = (VideoFrame *) ctx->allocator.allocate(&ctx->allocator, sizeof (VideoFrame));
-                            if (item == NULL) goto cleanup;
-                            item->seek_generation = ctx->current_seek_generation;
-                            item->playms = playms;
-                            item->fps = ctx->fps;
-                            item->width = ctx->tinfo.pic_width;
-                            item->height = ctx->tinfo.pic_height;
-                            item->format = ctx->vidfmt;
-                            item->pixels = ctx->vidcvt(&ctx->allocator, &ctx->tinfo, ycbcr);
-                            item->next = NULL;
-
-                            if (item->pixels == NULL)
-                            {
-                                free(item);
+                            if (!EmitVideoFrame(ctx, ycbcr, playms, ctx->current_seek_generation))
                                 goto cleanup;
-                            } // if
-
-                            //printf("Decoded another video frame.\n");
-                            Mutex_Lock(ctx->lock);
-                            if (ctx->videolisttail)
-                            {
-                                assert(ctx->videolist);
-                                ctx->videolisttail->next = item;
-                            } // if
-                            else
-                            {
-                                assert(!ctx->videolist);
-                                ctx->videolist = item;
-                            } // else
-                            ctx->videolisttail = item;
-                            ctx->videocount++;
 
                             desired_frames--;
 
                             // if we're full, consider this a full pump.
-                            if (ctx->videocount >= ctx->maxframes)
+                            Mutex_Lock(ctx->lock);
+                            if (VideoOutputFull(ctx))
                                 desired_frames = 0;
                             Mutex_Unlock(ctx->lock);
 
@@ -844,30 +1238,557 @@ cleanup:
 } // PumpDecoder
 
 
-static void *WorkerThread(void *_this)
+static int Pipeline_Stopping(const TheoraDecoder *ctx)
+{
+    return ctx->halt || ctx->stage_error;
+} // Pipeline_Stopping
+
+
+static int PipelineQueue_Init(TheoraDecoder *ctx, PipelineQueue *q, const unsigned int maxcount)
+{
+    memset(q, '\0', sizeof (*q));
+    q->maxcount = maxcount;
+    q->lock = Mutex_Create(ctx);
+    q->cond = q->lock ? Cond_Create(ctx) : 0;
+    return q->lock && q->cond;
+} // PipelineQueue_Init
+
+
+static void PipelineQueue_FreeList(TheoraDecoder *ctx, PipelineItem *item)
+{
+    while (item)
+    {
+        PipelineItem *next = item->next;
+        if (item->frame)
+        {
+            Mutex_Lock(ctx->lock);
+            FramePool_Put(ctx, (FramePoolItem *) item->frame);
+            Mutex_Unlock(ctx->lock);
+        } // if
+        if (item->buf)
+            ctx->allocator.deallocate(&ctx->allocator, item->buf);
+        ctx->allocator.deallocate(&ctx->allocator, item);
+        item = next;
+    } // while
+} // PipelineQueue_FreeList
+
+
+static void PipelineQueue_Destroy(TheoraDecoder *ctx, PipelineQueue *q)
+{
+    PipelineQueue_FreeList(ctx, q->head);
+    PipelineQueue_FreeList(ctx, q->freelist);
+    if (q->cond)
+        Cond_Destroy(ctx, q->cond);
+    if (q->lock)
+        Mutex_Destroy(ctx, q->lock);
+    memset(q, '\0', sizeof (*q));
+} // PipelineQueue_Destroy
+
+
+static void PipelineQueue_Wake(PipelineQueue *q)
+{
+    if (q->lock)
+    {
+        Mutex_Lock(q->lock);
+        Cond_Broadcast(q->cond);
+        Mutex_Unlock(q->lock);
+    } // if
+} // PipelineQueue_Wake
+
+
+// Halt, seek requests and stage failures all need everyone to re-check.
+static void Pipeline_WakeAll(TheoraDecoder *ctx)
+{
+    PipelineQueue_Wake(&ctx->videoqueue);
+    PipelineQueue_Wake(&ctx->audioqueue);
+    PipelineQueue_Wake(&ctx->convertqueue);
+    Mutex_Lock(ctx->lock);
+    Cond_Broadcast(ctx->cond);
+    Mutex_Unlock(ctx->lock);
+} // Pipeline_WakeAll
+
+
+// Takes a recycled item, or allocates one if the queue hasn't seen this many yet.
+static PipelineItem *PipelineQueue_NewItem(TheoraDecoder *ctx, PipelineQueue *q)
+{
+    PipelineItem *item;
+    Mutex_Lock(q->lock);
+    item = q->freelist;
+    if (item)
+        q->freelist = item->next;
+    Mutex_Unlock(q->lock);
+
+    if (item == NULL)
+    {
+        item = (PipelineItem *) ctx->allocator.allocate(&ctx->allocator, sizeof (PipelineItem));
+        if (item)
+            memset(item, '\0', sizeof (*item));
+    } // if
+    return item;
+} // PipelineQueue_NewItem
+
+
+// Blocks while the queue is full (seek markers never wait). Returns 1 if
+//  queued, 0 if we're shutting down and -1 if a seek came in while pushing a
+//  packet (the item is dropped, it'd be flushed anyway).
+static int PipelineQueue_Push(TheoraDecoder *ctx, PipelineQueue *q, PipelineItem *item)
 {
+    const int is_packet = (!item->is_seek && !item->frame);
+    int retval = 1;
+    item->next = NULL;
+    Mutex_Lock(q->lock);
+    while (!Pipeline_Stopping(ctx) && !item->is_seek && (q->count >= q->maxcount) && (!is_packet || (ctx->current_seek_generation == ctx->seek_generation)))
+        Cond_Wait(q->cond, q->lock);
+
+    if (Pipeline_Stopping(ctx))
+        retval = 0;
+    else if (is_packet && (ctx->current_seek_generation != ctx->seek_generation))
+        retval = -1;
+    else
+    {
+        if (q->tail)
+            q->tail->next = item;
+        else
+            q->head = item;
+        q->tail = item;
+        q->count++;
+        Cond_Broadcast(q->cond);
+    } // else
+
+    if (retval != 1)
+    {
+        item->next = q->freelist;
+        q->freelist = item;
+    } // if
+    Mutex_Unlock(q->lock);
+    return retval;
+} // PipelineQueue_Push
+
+
+static int PipelineQueue_PushFrame(TheoraDecoder *ctx, PipelineQueue *q, VideoFrame *frame)
+{
+    PipelineItem *item = PipelineQueue_NewItem(ctx, q);
+    if (item == NULL)
+        return 0;
+    item->frame = frame;
+    if (PipelineQueue_Push(ctx, q, item) != 1)
+    {
+        item->frame = NULL;  // caller still owns it.
+        return 0;
+    } // if
+    return 1;
+} // PipelineQueue_PushFrame
+
+
 #if !THEORAPLAY_ONLY_SINGLE_THREADED
+static void PipelineQueue_Recycle(PipelineQueue *q, PipelineItem *item)
+{
+    item->frame = NULL;
+    item->is_seek = 0;
+    Mutex_Lock(q->lock);
+    item->next = q->freelist;
+    q->freelist = item;
+    Mutex_Unlock(q->lock);
+} // PipelineQueue_Recycle
+
+
+static void Pipeline_Fail(TheoraDecoder *ctx)
+{
+    ctx->stage_error = 1;
+    Pipeline_WakeAll(ctx);
+} // Pipeline_Fail
+
+
+static int PipelineQueue_PushPacket(TheoraDecoder *ctx, PipelineQueue *q, const ogg_packet *packet)
+{
+    PipelineItem *item = PipelineQueue_NewItem(ctx, q);
+    if (item == NULL)
+        return 0;
+
+    if (item->bufcap < packet->bytes)
+    {
+        if (item->buf)
+            ctx->allocator.deallocate(&ctx->allocator, item->buf);
+        item->buf = (unsigned char *) ctx->allocator.allocate(&ctx->allocator, (unsigned int) packet->bytes + 1);
+        item->bufcap = item->buf ? packet->bytes + 1 : 0;
+        if (item->buf == NULL)
+        {
+            PipelineQueue_Recycle(q, item);
+            return 0;
+        } // if
+    } // if
+
+    memcpy(&item->packet, packet, sizeof (*packet));
+    memcpy(item->buf, packet->packet, packet->bytes);
+    item->packet.packet = item->buf;
+    return PipelineQueue_Push(ctx, q, item);
+} // PipelineQueue_PushPacket
+
+
+// Throws away everything queued for the old position and queues a marker
+//  telling the stage to reset its decoder state.
+static int PipelineQueue_PushSeek(TheoraDecoder *ctx, PipelineQueue *q, const unsigned long targetms)
+{
+    PipelineItem *item;
+
+    Mutex_Lock(q->lock);
+    if (q->head)
+    {
+        q->tail->next = q->freelist;
+        q->freelist = q->head;
+        q->head = q->tail = NULL;
+        q->count = 0;
+    } // if
+    Mutex_Unlock(q->lock);
+
+    item = PipelineQueue_NewItem(ctx, q);
+    if (item == NULL)
+        return 0;
+    item->is_seek = 1;
+    item->seek_generation = ctx->current_seek_generation;
+    item->seek_target = targetms;
+    return PipelineQueue_Push(ctx, q, item) != 0;
+} // PipelineQueue_PushSeek
+
+
+// Blocks until there's an item. NULL means drained-and-done or shutting down.
+static PipelineItem *PipelineQueue_Pop(TheoraDecoder *ctx, PipelineQueue *q)
+{
+    PipelineItem *item = NULL;
+    Mutex_Lock(q->lock);
+    while (!Pipeline_Stopping(ctx) && !q->head && !q->eos)
+        Cond_Wait(q->cond, q->lock);
+
+    if (!Pipeline_Stopping(ctx) && q->head)
+    {
+        item = q->head;
+        q->head = item->next;
+        if (q->head == NULL)
+            q->tail = NULL;
+        q->count--;
+        item->next = NULL;
+        Cond_Broadcast(q->cond);  // room for the producer.
+    } // if
+    Mutex_Unlock(q->lock);
+    return item;
+} // PipelineQueue_Pop
+
+
+static void PipelineQueue_SetEOS(PipelineQueue *q)
+{
+    if (q->lock)
+    {
+        Mutex_Lock(q->lock);
+        q->eos = 1;
+        Cond_Broadcast(q->cond);
+        Mutex_Unlock(q->lock);
+    } // if
+} // PipelineQueue_SetEOS
+
+
+static void *VideoThread(void *_this)
+{
     TheoraDecoder *ctx = (TheoraDecoder *) _this;
-    while (!ctx->thread_done)
+    unsigned int generation = 0;
+    unsigned long seek_target = 0;
+    int resolving_seek = 0;
+    int need_keyframe = 0;
+    ogg_int64_t granulepos = -1;
+    PipelineItem *item;
+    int decoded;
+
+    profilerSetThreadName("theora video");
+    while ((item = PipelineQueue_Pop(ctx, &ctx->videoqueue)) != NULL)
     {
-        const int had_new_video_frames = PumpDecoder(ctx, ctx->maxframes);
-        // Sleep the process until we have space for more frames.
-        if (had_new_video_frames && !ctx->thread_done)
+        if (item->is_seek)
         {
-            int go_on = !ctx->halt;
-            //printf("Sleeping.\n");
-            while (go_on)
+            generation = item->seek_generation;
+            seek_target = item->seek_target;
+            resolving_seek = 1;
+            need_keyframe = 1;
+            PipelineQueue_Recycle(&ctx->videoqueue, item);
+            continue;
+        } // if
+
+        // you have to guide the Theora decoder to get meaningful timestamps, apparently.  :/
+        if (item->packet.granulepos >= 0)
+            th_decode_ctl(ctx->tdec, TH_DECCTL_SET_GRANPOS, &item->packet.granulepos, sizeof (item->packet.granulepos));
+
+        profilerBeginZone("theora decode");
+        decoded = (th_decode_packetin(ctx->tdec, &item->packet, &granulepos) == 0);
+        profilerEndZone();
+
+        if (decoded)  // new frame!
+        {
+            const double videotime = th_granule_time(ctx->tdec, granulepos);
+            const unsigned int playms = (unsigned int) (videotime * 1000.0);
+
+            if (need_keyframe && th_packet_iskeyframe(&item->packet))
+                need_keyframe = 0;
+
+            if (resolving_seek && !need_keyframe && ((playms >= seek_target) || ((seek_target - playms) <= (unsigned long) (1000.0 / ctx->fps))))
+                resolving_seek = 0;
+
+            if (!resolving_seek)
             {
-                // !!! FIXME: This is stupid. I should use a semaphore for this.
+                th_ycbcr_buffer ycbcr;
+                int ok = 1;
+
+                // wait for the app to make room before we take another buffer.
                 Mutex_Lock(ctx->lock);
-                go_on = !ctx->halt && (ctx->videocount >= ctx->maxframes);
+                while (!Pipeline_Stopping(ctx) && VideoOutputFull(ctx))
+                    Cond_Wait(ctx->cond, ctx->lock);
                 Mutex_Unlock(ctx->lock);
-                if (go_on)
-                    sleepms(10);
-            } // while
-            //printf("Awake!\n");
+
+                profilerBeginZone("theora emit frame");
+                if (!Pipeline_Stopping(ctx) && (th_decode_ycbcr_out(ctx->tdec, ycbcr) == 0))
+                    ok = EmitVideoFrame(ctx, ycbcr, playms, generation);
+                profilerEndZone();
+
+                if (!ok)
+                {
+                    PipelineQueue_Recycle(&ctx->videoqueue, item);
+                    Pipeline_Fail(ctx);
+                    break;
+                } // if
+            } // if
         } // if
-    }
+
+        PipelineQueue_Recycle(&ctx->videoqueue, item);
+    } // while
+
+    PipelineQueue_SetEOS(&ctx->convertqueue);
+    return NULL;
+} // VideoThread
+
+
+static void *ConvertThread(void *_this)
+{
+    TheoraDecoder *ctx = (TheoraDecoder *) _this;
+    const unsigned int w = ctx->tinfo.pic_width;
+    const unsigned int h = ctx->tinfo.pic_height;
+    const unsigned int len = VideoFrameBufferSize(ctx->vidfmt, w, h);
+    th_info rawinfo;
+    PipelineItem *item;
+
+    // raw frames are tightly packed IYUV with the picture at the origin.
+    memcpy(&rawinfo, &ctx->tinfo, sizeof (rawinfo));
+    rawinfo.pic_x = rawinfo.pic_y = 0;
+
+    profilerSetThreadName("theora convert");
+    while ((item = PipelineQueue_Pop(ctx, &ctx->convertqueue)) != NULL)
+    {
+        VideoFrame *raw = item->frame;
+        VideoFrame *out = FramePool_Get(ctx, len);
+        th_ycbcr_buffer ycbcr;
+
+        item->frame = NULL;
+        PipelineQueue_Recycle(&ctx->convertqueue, item);
+
+        if (out == NULL)
+        {
+            Mutex_Lock(ctx->lock);
+            FramePool_Put(ctx, (FramePoolItem *) raw);
+            Mutex_Unlock(ctx->lock);
+            Pipeline_Fail(ctx);
+            break;
+        } // if
+
+        ycbcr[0].width = w;
+        ycbcr[0].height = h;
+        ycbcr[0].stride = w;
+        ycbcr[0].data = raw->pixels;
+        ycbcr[1].width = ycbcr[2].width = w / 2;
+        ycbcr[1].height = ycbcr[2].height = h / 2;
+        ycbcr[1].stride = ycbcr[2].stride = w / 2;
+        ycbcr[1].data = ycbcr[0].data + (w * h);
+        ycbcr[2].data = ycbcr[1].data + ((w / 2) * (h / 2));
+
+        out->seek_generation = raw->seek_generation;
+        out->playms = raw->playms;
+        out->fps = raw->fps;
+        out->width = w;
+        out->height = h;
+        out->format = ctx->vidfmt;
+        out->target = NULL;
+        profilerBeginZone("theora convert");
+        ctx->vidcvt(out->pixels, &rawinfo, ycbcr);
+        profilerEndZone();
+
+        Mutex_Lock(ctx->lock);
+        FramePool_Put(ctx, (FramePoolItem *) raw);
+        Mutex_Unlock(ctx->lock);
+
+        AppendVideoFrame(ctx, out);
+    } // while
+    return NULL;
+} // ConvertThread
+
+
+static void *AudioThread(void *_this)
+{
+    TheoraDecoder *ctx = (TheoraDecoder *) _this;
+    unsigned int generation = 0;
+    unsigned long seek_target = 0;
+    int resolving_seek = 0;
+    PipelineItem *item;
+
+    profilerSetThreadName("theora audio");
+    while ((item = PipelineQueue_Pop(ctx, &ctx->audioqueue)) != NULL)
+    {
+        if (item->is_seek)
+        {
+            vorbis_synthesis_restart(&ctx->vdsp);
+            generation = item->seek_generation;
+            seek_target = item->seek_target;
+            resolving_seek = 1;
+            PipelineQueue_Recycle(&ctx->audioqueue, item);
+            continue;
+        } // if
+
+        profilerBeginZone("vorbis decode");
+        if (vorbis_synthesis(&ctx->vblock, &item->packet) == 0)
+            vorbis_synthesis_blockin(&ctx->vdsp, &ctx->vblock);
+        profilerEndZone();
+        PipelineQueue_Recycle(&ctx->audioqueue, item);
+
+        // eat all the audio this packet produced.
+        while (!Pipeline_Stopping(ctx))
+        {
+            const double audiotime = vorbis_granule_time(&ctx->vdsp, ctx->vdsp.granulepos);
+            const unsigned int playms = (unsigned int) (audiotime * 1000.0);
+            float **pcm = NULL;
+            int frames;
+
+            if (resolving_seek)
+            {
+                if (seek_target < 1000)   // if the seek target is the start of the data, assume we're good even before audiotime is valid. As soon as we have data, ship it.
+                    resolving_seek = 0;
+                else if ((audiotime >= 0.0) && ((playms >= seek_target) || ((seek_target - playms) <= (unsigned long) (1000.0 / ctx->fps))))
+                    resolving_seek = 0;
+            }
+
+            frames = vorbis_synthesis_pcmout(&ctx->vdsp, &pcm);
+            if (frames <= 0)
+                break;
+
+            if (!resolving_seek && !EmitAudioPacket(ctx, pcm, frames, playms, generation))
+            {
+                Pipeline_Fail(ctx);
+                return NULL;
+            } // if
+
+            vorbis_synthesis_read(&ctx->vdsp, frames);  // we ate everything.
+        } // while
+    } // while
+    return NULL;
+} // AudioThread
+#endif
+
+
+// The worker thread: sets up the streams, starts the decode stages and then
+//  keeps their packet queues topped up.
+static void *WorkerThread(void *_this)
+{
+#if !THEORAPLAY_ONLY_SINGLE_THREADED
+    TheoraDecoder *ctx = (TheoraDecoder *) _this;
+
+    profilerSetThreadName("theora worker");
+    profilerBeginZone("theora prepare");
+    PrepareDecoder(ctx);
+    profilerEndZone();
+    if (!ctx->prepped)
+        goto cleanup;
+
+    if (ctx->tpackets)
+    {
+        ctx->videoworker_created = (Thread_Create(ctx, &ctx->videoworker, VideoThread) == 0);
+        if (!ctx->videoworker_created)
+            goto cleanup;
+        if (ctx->convert_stage)
+        {
+            ctx->convertworker_created = (Thread_Create(ctx, &ctx->convertworker, ConvertThread) == 0);
+            if (!ctx->convertworker_created)
+                goto cleanup;
+        } // if
+    } // if
+
+    if (ctx->vpackets)
+    {
+        ctx->audioworker_created = (Thread_Create(ctx, &ctx->audioworker, AudioThread) == 0);
+        if (!ctx->audioworker_created)
+            goto cleanup;
+    } // if
+
+    while (!Pipeline_Stopping(ctx) && !ctx->eos)
+    {
+        int rc;
+
+        if (ctx->current_seek_generation != ctx->seek_generation)  // seek requested
+        {
+            unsigned long targetms;
+            if (!SeekStream(ctx, &targetms))
+                goto cleanup;
+            if (ctx->tpackets && !PipelineQueue_PushSeek(ctx, &ctx->videoqueue, targetms))
+                goto cleanup;
+            if (ctx->vpackets && !PipelineQueue_PushSeek(ctx, &ctx->audioqueue, targetms))
+                goto cleanup;
+            continue;
+        } // if
+
+        // move every packet the streams can give us into the queues. This
+        //  blocks when a stage falls behind.
+        rc = 1;
+        while ((rc == 1) && ctx->tpackets && (ogg_stream_packetout(&ctx->tstream, &ctx->packet) > 0))
+            rc = PipelineQueue_PushPacket(ctx, &ctx->videoqueue, &ctx->packet);
+        while ((rc == 1) && ctx->vpackets && (ogg_stream_packetout(&ctx->vstream, &ctx->packet) > 0))
+            rc = PipelineQueue_PushPacket(ctx, &ctx->audioqueue, &ctx->packet);
+
+        if (rc == 0)
+        {
+            if (!Pipeline_Stopping(ctx))
+                goto cleanup;  // out of memory.
+            break;
+        } // if
+        else if (rc < 0)
+            continue;  // seek requested.
+
+        profilerBeginZone("ogg read");
+        rc = FeedMoreOggData(ctx->io, &ctx->sync);
+        profilerEndZone();
+        if (rc == 0)
+            ctx->eos = 1;  // end of stream
+        else if (rc < 0)
+            goto cleanup;  // i/o error, etc.
+        else
+        {
+            while (!ctx->halt && (ogg_sync_pageout(&ctx->sync, &ctx->page) > 0))
+                QueueOggPage(ctx);
+        } // else
+    } // while
+
+    ctx->was_error = 0;
+
+cleanup:
+    if (ctx->was_error)
+        Pipeline_Fail(ctx);
+
+    // let the stages drain what's queued, then wait for them.
+    PipelineQueue_SetEOS(&ctx->videoqueue);
+    PipelineQueue_SetEOS(&ctx->audioqueue);
+    if (ctx->videoworker_created)
+        Thread_Join(ctx->videoworker);
+    PipelineQueue_SetEOS(&ctx->convertqueue);  // in case the video stage never started.
+    if (ctx->convertworker_created)
+        Thread_Join(ctx->convertworker);
+    if (ctx->audioworker_created)
+        Thread_Join(ctx->audioworker);
+    ctx->videoworker_created = ctx->convertworker_created = ctx->audioworker_created = 0;
+
+    Mutex_Lock(ctx->lock);
+    ctx->decode_error = (!ctx->halt && (ctx->was_error || ctx->stage_error));
+    ctx->thread_done = 1;
+    Mutex_Unlock(ctx->lock);
 
     //printf("Worker thread is done.\n");
 #endif
@@ -1048,25 +1969,39 @@ THEORAPLAY_Decoder *THEORAPLAY_startDecode(THEORAPLAY_Io *io,
     th_comment_init(&ctx->tcomment);
     th_info_init(&ctx->tinfo);
 
-    if (!multithreaded)
-        return (THEORAPLAY_Decoder *) ctx;
-    else
+    // the frame pool is shared with the app thread, so we lock even when
+    //  not threaded ourselves.
+    ctx->lock = Mutex_Create(ctx);
+    ctx->cond = ctx->lock ? Cond_Create(ctx) : 0;
+    if (ctx->cond)
     {
-        ctx->lock = Mutex_Create(ctx);
-        if (ctx->lock)
+        if (!multithreaded)
+            return (THEORAPLAY_Decoder *) ctx;
+
+        // the RGB conversions are the expensive part, give them their own thread.
+        ctx->convert_stage = ((vidfmt != THEORAPLAY_VIDFMT_YV12) && (vidfmt != THEORAPLAY_VIDFMT_IYUV));
+        if ( PipelineQueue_Init(ctx, &ctx->videoqueue, PIPELINE_MAX_PACKETS) &&
+             PipelineQueue_Init(ctx, &ctx->audioqueue, PIPELINE_MAX_PACKETS) &&
+             PipelineQueue_Init(ctx, &ctx->convertqueue, PIPELINE_MAX_RAW_FRAMES) )
         {
-            ctx->thread_created = (Thread_Create(ctx, WorkerThread) == 0);
+            ctx->thread_created = (Thread_Create(ctx, &ctx->worker, WorkerThread) == 0);
             if (ctx->thread_created)
                 return (THEORAPLAY_Decoder *) ctx;
-            Mutex_Destroy(ctx, ctx->lock);
         } // if
-    } // else
+        PipelineQueue_Destroy(ctx, &ctx->videoqueue);
+        PipelineQueue_Destroy(ctx, &ctx->audioqueue);
+        PipelineQueue_Destroy(ctx, &ctx->convertqueue);
+    } // if
 
-startdecode_failed:
+    if (ctx->cond)
+        Cond_Destroy(ctx, ctx->cond);
     if (ctx->lock)
         Mutex_Destroy(ctx, ctx->lock);
+
+startdecode_failed:
     io->close(io);
-    allocator->deallocate(allocator, ctx);
+    if (ctx)
+        allocator->deallocate(allocator, ctx);
     return NULL;
 } // THEORAPLAY_startDecode
 
@@ -1080,25 +2015,38 @@ void THEORAPLAY_stopDecode(THEORAPLAY_Decoder *decoder)
     if (ctx->thread_created)
     {
         ctx->halt = 1;
+        Pipeline_WakeAll(ctx);
         Thread_Join(ctx->worker);
-        Mutex_Destroy(ctx, ctx->lock);
+
+        // anything still queued (packets, raw frames) goes back now.
+        PipelineQueue_Destroy(ctx, &ctx->videoqueue);
+        PipelineQueue_Destroy(ctx, &ctx->audioqueue);
+        PipelineQueue_Destroy(ctx, &ctx->convertqueue);
     } // if
 
+    int orphaned;
+    Mutex_Lock(ctx->lock);
     VideoFrame *videolist = ctx->videolist;
     while (videolist)
     {
         VideoFrame *next = videolist->next;
-        free(videolist->pixels);
-        free(videolist);
+        FramePool_Put(ctx, (FramePoolItem *) videolist);
         videolist = next;
     } // while
+    ctx->videolist = ctx->videolisttail = NULL;
+
+    // frames the app still holds give their memory back as they're freed.
+    FramePool_Drain(ctx);
+    ctx->pool_maxbytes = 0;
+    orphaned = ctx->pool_orphaned = (ctx->pool_livebytes != 0);
+    Mutex_Unlock(ctx->lock);
 
     AudioPacket *audiolist = ctx->audiolist;
     while (audiolist)
     {
         AudioPacket *next = audiolist->next;
-        free(audiolist->samples);
-        free(audiolist);
+        ctx->allocator.deallocate(&ctx->allocator, audiolist->samples);
+        ctx->allocator.deallocate(&ctx->allocator, audiolist);
         audiolist = next;
     } // while
 
@@ -1117,7 +2065,8 @@ void THEORAPLAY_stopDecode(THEORAPLAY_Decoder *decoder)
     if (ctx->io && ctx->io->close)
         ctx->io->close(ctx->io);
 
-    free(ctx);
+    if (!orphaned)
+        FreeDecoderShell(ctx);
 } // THEORAPLAY_stopDecode
 
 
@@ -1129,10 +2078,12 @@ void THEORAPLAY_pumpDecode(THEORAPLAY_Decoder *decoder, const int maxframes)
         return;
     else if (!ctx->thread_created)
     {
+        int full;
         Mutex_Lock(ctx->lock);
-        if (!ctx->halt && (ctx->videocount >= ctx->maxframes))
-            return;  // already maxed out on frames, don't do anything this pump.
+        full = !ctx->halt && VideoOutputFull(ctx);
         Mutex_Unlock(ctx->lock);
+        if (full)
+            return;  // already maxed out on frames, don't do anything this pump.
 
         PumpDecoder(ctx, maxframes);
     } // else if
@@ -1255,16 +2206,60 @@ const THEORAPLAY_VideoFrame *THEORAPLAY_getVideo(THEORAPLAY_Decoder *decoder)
 
 void THEORAPLAY_freeVideo(const THEORAPLAY_VideoFrame *_item)
 {
-    THEORAPLAY_VideoFrame *item = (THEORAPLAY_VideoFrame *) _item;
+    FramePoolItem *item = (FramePoolItem *) _item;
     if (item != NULL)
     {
-        assert(item->next == NULL);
-        free(item->pixels);
-        free(item);
+        TheoraDecoder *ctx = item->owner;
+        int last_orphan;
+        assert(item->frame.next == NULL);
+        Mutex_Lock(ctx->lock);
+        FramePool_Put(ctx, item);
+        last_orphan = ctx->pool_orphaned && (ctx->pool_livebytes == 0);
+        Mutex_Unlock(ctx->lock);
+        if (last_orphan)
+            FreeDecoderShell(ctx);
     } // if
 } // THEORAPLAY_freeVideo
 
 
+int THEORAPLAY_submitVideoTarget(THEORAPLAY_Decoder *decoder, const THEORAPLAY_VideoTarget *target)
+{
+    TheoraDecoder *ctx = (TheoraDecoder *) decoder;
+    int retval = 0;
+
+    // only the planar YUV formats can be written in place.
+    if (!ctx || !target || ((ctx->vidfmt != THEORAPLAY_VIDFMT_YV12) && (ctx->vidfmt != THEORAPLAY_VIDFMT_IYUV)))
+        return 0;
+
+    Mutex_Lock(ctx->lock);
+    if (ctx->targetcount < MAX_VIDEO_TARGETS)
+    {
+        const unsigned int idx = (ctx->targethead + ctx->targetcount) % MAX_VIDEO_TARGETS;
+        memcpy(&ctx->targets[idx], target, sizeof (*target));
+        ctx->targetcount++;
+        ctx->target_mode = 1;
+        retval = 1;
+        Cond_Broadcast(ctx->cond);  // the video stage may be waiting for one.
+    } // if
+    Mutex_Unlock(ctx->lock);
+
+    return retval;
+} // THEORAPLAY_submitVideoTarget
+
+
+void THEORAPLAY_setVideoBufferBytes(THEORAPLAY_Decoder *decoder, unsigned int maxbytes)
+{
+    TheoraDecoder *ctx = (TheoraDecoder *) decoder;
+    if (ctx)
+    {
+        Mutex_Lock(ctx->lock);
+        ctx->pool_maxbytes = maxbytes;
+        Cond_Broadcast(ctx->cond);
+        Mutex_Unlock(ctx->lock);
+    } // if
+} // THEORAPLAY_setVideoBufferBytes
+
+
 unsigned int THEORAPLAY_seek(THEORAPLAY_Decoder *decoder, unsigned long mspos)
 {
     unsigned int retval;
@@ -1273,6 +2268,8 @@ unsigned int THEORAPLAY_seek(THEORAPLAY_Decoder *decoder, unsigned long mspos)
     ctx->new_seek_position_ms = mspos;
     retval = ++ctx->seek_generation;
     Mutex_Unlock(ctx->lock);
+    if (ctx->thread_created)
+        Pipeline_WakeAll(ctx);  // the demuxer might be blocked on a full queue.
     return retval;
 } // THEORAPLAY_seek
 
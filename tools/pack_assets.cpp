@@ -0,0 +1,205 @@
+// Builds the asset pack read by Texture::loadFromFile. Every image is decoded
+// with SDL_image, converted to ASSET_PACK_PIXEL_FORMAT and stored as one LZ4
+// block, so the game never decodes a PNG at run time:
+//
+//   make pack
+//   ./pack_assets.exe -o assets.pak -scaled assets/backgrounds/ assets/*/*.png
+//
+// Images under a -scaled prefix are drawn over the whole screen, they also
+// get copies pre-scaled to each render scale of the logical resolution. Run
+// it from the repository root, names are stored as given.
+
+#define SDL_MAIN_HANDLED
+#include "CONSTANTS.hpp"
+#include "assetpack.hpp"
+#include "lz4block.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Render scales RenderScaler cycles through, see Game::handleEvents
+static const float SCALES[] = {0.5f, 0.75f, 1.0f};
+
+struct PackedImage {
+  AssetPackEntry entry = {};
+  std::vector<Uint8> block;
+};
+
+static void printUsage() {
+  fprintf(stderr,
+          "usage: pack_assets [-o file] [-scaled prefix]... image...\n"
+          "  -o       output file (%s)\n"
+          "  -scaled  images whose path starts with prefix also get copies\n"
+          "           pre-scaled to %dx%d times each render scale\n",
+          ASSET_PACK_PATH, W_WIDTH, W_HEIGHT);
+}
+
+// Compresses a surface already in ASSET_PACK_PIXEL_FORMAT
+static bool packSurface(const std::string &name, SDL_Surface *surface,
+                        Uint32 flags, PackedImage &image) {
+  int pitch = surface->w * 4;
+  std::vector<Uint8> pixels(pitch * surface->h);
+  for (int y = 0; y < surface->h; y++) {
+    memcpy(&pixels[y * pitch], (Uint8 *)surface->pixels + y * surface->pitch,
+           pitch);
+  }
+
+  image.block.resize(lz4CompressBound((int)pixels.size()));
+  int compressedSize = lz4Compress(pixels.data(), (int)pixels.size(),
+                                   image.block.data(), (int)image.block.size());
+  if (compressedSize == 0)
+    return false;
+  image.block.resize(compressedSize);
+
+  strncpy(image.entry.name, name.c_str(), ASSET_PACK_NAME_SIZE - 1);
+  image.entry.width = surface->w;
+  image.entry.height = surface->h;
+  image.entry.flags = flags;
+  image.entry.compressedSize = compressedSize;
+  return true;
+}
+
+static bool packFile(const std::string &name,
+                     const std::vector<std::string> &scaledPrefixes,
+                     std::vector<PackedImage> &images) {
+  SDL_Surface *loaded = IMG_Load(name.c_str());
+  if (loaded == nullptr) {
+    fprintf(stderr, "Could not load %s: %s\n", name.c_str(), IMG_GetError());
+    return false;
+  }
+
+  // Same rule SDL_CreateTextureFromSurface uses to pick blending
+  Uint32 flags = 0;
+  if (loaded->format->Amask != 0 || SDL_HasColorKey(loaded))
+    flags |= ASSET_PACK_ALPHA;
+
+  SDL_Surface *surface =
+      SDL_ConvertSurfaceFormat(loaded, ASSET_PACK_PIXEL_FORMAT, 0);
+  SDL_FreeSurface(loaded);
+  if (surface == nullptr) {
+    fprintf(stderr, "Could not convert %s: %s\n", name.c_str(), SDL_GetError());
+    return false;
+  }
+
+  images.push_back(PackedImage());
+  bool ok = packSurface(name, surface, flags, images.back());
+
+  bool scaled = false;
+  for (const std::string &prefix : scaledPrefixes) {
+    scaled = scaled || name.compare(0, prefix.size(), prefix) == 0;
+  }
+  for (float scale : SCALES) {
+    int width = (int)(W_WIDTH * scale);
+    int height = (int)(W_HEIGHT * scale);
+    // Only downscaled copies save anything
+    if (!scaled || !ok || width >= surface->w)
+      continue;
+
+    SDL_Surface *resized = SDL_CreateRGBSurfaceWithFormat(
+        0, width, height, 32, ASSET_PACK_PIXEL_FORMAT);
+    if (resized == nullptr ||
+        SDL_SoftStretchLinear(surface, nullptr, resized, nullptr) != 0) {
+      fprintf(stderr, "Could not scale %s: %s\n", name.c_str(),
+              SDL_GetError());
+      ok = false;
+    } else {
+      images.push_back(PackedImage());
+      ok = packSurface(name, resized, flags, images.back());
+    }
+    SDL_FreeSurface(resized);
+  }
+
+  SDL_FreeSurface(surface);
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  const char *outputPath = ASSET_PACK_PATH;
+  std::vector<std::string> scaledPrefixes;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "-o") == 0 && hasValue) {
+      outputPath = argv[++i];
+    } else if (strcmp(argv[i], "-scaled") == 0 && hasValue) {
+      scaledPrefixes.push_back(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      printUsage();
+      return 1;
+    } else {
+      std::string name = argv[i];
+      std::replace(name.begin(), name.end(), '\\', '/');
+      if (name.size() >= ASSET_PACK_NAME_SIZE) {
+        fprintf(stderr, "Path too long for the pack: %s\n", name.c_str());
+        return 1;
+      }
+      files.push_back(name);
+    }
+  }
+  if (files.empty()) {
+    printUsage();
+    return 1;
+  }
+
+  if (!(IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) & IMG_INIT_PNG)) {
+    fprintf(stderr, "SDL_image could not initialize: %s\n", IMG_GetError());
+    return 1;
+  }
+
+  std::vector<PackedImage> images;
+  size_t rawBytes = 0;
+  for (const std::string &name : files) {
+    if (!packFile(name, scaledPrefixes, images)) {
+      IMG_Quit();
+      return 1;
+    }
+  }
+
+  // Texture::loadFromFile binary searches by name, variants by width
+  std::sort(images.begin(), images.end(),
+            [](const PackedImage &a, const PackedImage &b) {
+              int order = strncmp(a.entry.name, b.entry.name,
+                                  ASSET_PACK_NAME_SIZE);
+              return order != 0 ? order < 0 : a.entry.width < b.entry.width;
+            });
+
+  AssetPackHeader header = {};
+  header.magic = ASSET_PACK_MAGIC;
+  header.version = ASSET_PACK_VERSION;
+  header.pixelFormat = ASSET_PACK_PIXEL_FORMAT;
+  header.entryCount = (Uint32)images.size();
+
+  Uint32 offset =
+      sizeof(AssetPackHeader) + images.size() * sizeof(AssetPackEntry);
+  for (PackedImage &image : images) {
+    image.entry.offset = offset;
+    offset += image.entry.compressedSize;
+    rawBytes += image.entry.width * image.entry.height * 4;
+  }
+
+  FILE *file = fopen(outputPath, "wb");
+  if (file == nullptr) {
+    fprintf(stderr, "Could not write %s\n", outputPath);
+    IMG_Quit();
+    return 1;
+  }
+  fwrite(&header, sizeof(header), 1, file);
+  for (const PackedImage &image : images) {
+    fwrite(&image.entry, sizeof(image.entry), 1, file);
+  }
+  for (const PackedImage &image : images) {
+    fwrite(image.block.data(), 1, image.block.size(), file);
+  }
+  fclose(file);
+
+  printf("%s: %d images (%d files), %u KB of pixels in %u KB\n", outputPath,
+         (int)images.size(), (int)files.size(), (unsigned)(rawBytes / 1024),
+         (unsigned)(offset / 1024));
+  IMG_Quit();
+  return 0;
+}